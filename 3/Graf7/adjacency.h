@@ -0,0 +1,63 @@
+/**
+ * @file adjacency.h
+ * @brief Единый доступ к спискам соседей CSR и сжатого графа
+ * @version 1.0
+ *
+ * Обходы, которым нужны только степени и соседи (BFS, компоненты,
+ * перенумерация), пишутся шаблонами над этими адаптерами и работают
+ * с графом в любом представлении.
+ */
+
+#ifndef ADJACENCY_H
+#define ADJACENCY_H
+
+#include "compressed_graph.h"
+#include "csr_graph.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Полуинтервал соседей [first, second)
+ */
+typedef std::pair<const int*, const int*> NeighborRange;
+
+/**
+ * @struct CSRAdjacency
+ * @brief Доступ к спискам соседей CSR без копирования
+ */
+struct CSRAdjacency {
+    const CSRGraph& graph;
+
+    explicit CSRAdjacency(const CSRGraph& csr) : graph(csr) {}
+    int vertexCount() const { return graph.vertexCount(); }
+    std::int64_t arcCount() const { return graph.arcCount(); }
+    int degree(int v) const { return graph.degree(v); }
+    NeighborRange neighbors(int v) const {
+        return NeighborRange(graph.neighborsBegin(v), graph.neighborsEnd(v));
+    }
+};
+
+/**
+ * @struct CompressedAdjacency
+ * @brief Распаковка сжатых списков соседей в буфер
+ *
+ * Диапазон действителен до следующего вызова neighbors()
+ */
+struct CompressedAdjacency {
+    const CompressedGraph& graph;
+    std::vector<int> buffer;
+
+    explicit CompressedAdjacency(const CompressedGraph& compressed)
+        : graph(compressed), buffer(static_cast<std::size_t>(compressed.maxDegree()) + 1) {}
+    int vertexCount() const { return graph.vertexCount(); }
+    std::int64_t arcCount() const { return graph.arcCount(); }
+    int degree(int v) const { return graph.degree(v); }
+    NeighborRange neighbors(int v) {
+        graph.decode(v, buffer.data());
+        return NeighborRange(buffer.data(), buffer.data() + graph.degree(v));
+    }
+};
+
+#endif // ADJACENCY_H
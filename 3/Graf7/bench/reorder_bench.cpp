@@ -0,0 +1,268 @@
+/**
+ * @file reorder_bench.cpp
+ * @brief Замер промахов кэша BFS при разных перенумерациях вершин
+ * @version 1.0
+ *
+ * Граф загружается один раз, затем для каждого способа перенумерации
+ * (none, degree, bfs, rcm) из одних и тех же городов запускаются
+ * усеченные BFS. Промахи кэша считаются аппаратными счетчиками
+ * через perf_event_open; если счетчики недоступны
+ * (/proc/sys/kernel/perf_event_paranoid, контейнер), печатается только время.
+ * Ширина ленты - среднее |u - v| по дугам: чем она меньше, тем ближе
+ * в памяти соседи.
+ */
+
+#include "../graph_reader.h"
+#include "../graph_utils.h"
+#include "../vertex_order.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <linux/perf_event.h>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/**
+ * @class CacheCounters
+ * @brief Группа аппаратных счетчиков: обращения к кэшу и промахи
+ */
+class CacheCounters {
+private:
+    int leader_;      ///< cache-references (лидер группы), -1 - недоступно
+    int misses_;      ///< cache-misses
+
+    /**
+     * @brief Открытие счетчика текущего процесса
+     * @param config PERF_COUNT_HW_*
+     * @param group Лидер группы (-1 - новый лидер, создается выключенным)
+     * @return int Дескриптор или -1
+     */
+    static int open(std::uint64_t config, int group) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = group == -1 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group, 0));
+    }
+
+public:
+    CacheCounters() : leader_(open(PERF_COUNT_HW_CACHE_REFERENCES, -1)), misses_(-1) {
+        if (leader_ != -1) {
+            misses_ = open(PERF_COUNT_HW_CACHE_MISSES, leader_);
+            if (misses_ == -1) {
+                close(leader_);
+                leader_ = -1;
+            }
+        }
+    }
+
+    ~CacheCounters() {
+        if (misses_ != -1) {
+            close(misses_);
+        }
+        if (leader_ != -1) {
+            close(leader_);
+        }
+    }
+
+    CacheCounters(const CacheCounters&) = delete;
+    CacheCounters& operator=(const CacheCounters&) = delete;
+
+    /**
+     * @brief Доступны ли счетчики
+     * @return true если perf_event_open разрешен
+     */
+    bool available() const { return leader_ != -1; }
+
+    /**
+     * @brief Сброс и запуск группы
+     */
+    void start() {
+        if (available()) {
+            ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+
+    /**
+     * @brief Остановка и чтение
+     * @return std::pair<std::uint64_t, std::uint64_t> (обращения, промахи)
+     */
+    std::pair<std::uint64_t, std::uint64_t> stop() {
+        if (!available()) {
+            return std::make_pair(0, 0);
+        }
+        ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        std::uint64_t values[3] = {0, 0, 0};  // число счетчиков, обращения, промахи
+        if (read(leader_, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values))) {
+            return std::make_pair(0, 0);
+        }
+        return std::make_pair(values[1], values[2]);
+    }
+};
+
+/**
+ * @brief Столбец таблицы с выравниванием вправо
+ *
+ * Ширина считается в символах UTF-8, а не в байтах
+ * @param text Текст
+ * @param width Ширина столбца
+ * @return std::string Текст с ведущими пробелами
+ */
+std::string column(const std::string& text, std::size_t width) {
+    std::size_t length = 0;
+    for (char c : text) {
+        if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) {
+            ++length;
+        }
+    }
+    return std::string(width > length ? width - length : 0, ' ') + text;
+}
+
+/**
+ * @brief Средняя ширина ленты графа
+ * @param graph Граф
+ * @return double Среднее |u - v| по дугам
+ */
+double averageBandwidth(const CSRGraph& graph) {
+    double total = 0.0;
+    for (int u = 0; u < graph.vertexCount(); ++u) {
+        for (const int* it = graph.neighborsBegin(u); it != graph.neighborsEnd(u); ++it) {
+            total += std::abs(*it - u);
+        }
+    }
+    return graph.arcCount() > 0 ? total / graph.arcCount() : 0.0;
+}
+
+/**
+ * @brief Случайная перенумерация (имитация внешней нумерации городов)
+ * @param graph Граф
+ * @param seed Зерно генератора
+ * @return CSRGraph Граф со случайно переставленными номерами
+ */
+CSRGraph shuffleLabels(const CSRGraph& graph, unsigned seed) {
+    std::vector<int> label(static_cast<std::size_t>(graph.vertexCount()));
+    for (std::size_t v = 0; v < label.size(); ++v) {
+        label[v] = static_cast<int>(v);
+    }
+    std::mt19937 random(seed);
+    std::shuffle(label.begin(), label.end(), random);
+
+    std::vector<std::pair<int, int>> arcs;
+    arcs.reserve(static_cast<std::size_t>(graph.arcCount()));
+    for (int u = 0; u < graph.vertexCount(); ++u) {
+        for (const int* it = graph.neighborsBegin(u); it != graph.neighborsEnd(u); ++it) {
+            arcs.push_back(std::make_pair(label[u], label[*it]));
+        }
+    }
+    return CSRGraph::fromEdges(graph.vertexCount(), arcs, false);
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        if (argc < 2) {
+            std::cerr << "Использование: reorder_bench граф [--queries N] [--depth D] [--shuffle зерно]"
+                      << std::endl;
+            return 1;
+        }
+        int queries = 64;
+        int depth = 1000000;
+        bool shuffle = false;
+        unsigned seed = 0;
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--queries" && i + 1 < argc) {
+                queries = std::stoi(argv[++i]);
+            } else if (arg == "--depth" && i + 1 < argc) {
+                depth = std::stoi(argv[++i]);
+            } else if (arg == "--shuffle" && i + 1 < argc) {
+                shuffle = true;
+                seed = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else {
+                throw std::runtime_error("Неизвестный параметр: " + arg);
+            }
+        }
+
+        if (queries < 1) {
+            throw std::runtime_error("Некорректное количество запросов: " + std::to_string(queries));
+        }
+        int cityCount;
+        CSRGraph graph = GraphReader::readFromFile(argv[1], cityCount);
+        if (shuffle) {
+            graph = shuffleLabels(graph, seed);
+        }
+
+        std::mt19937 random(12345);
+        std::vector<int> sources(static_cast<std::size_t>(queries));
+        for (int& source : sources) {
+            source = static_cast<int>(random() % static_cast<unsigned>(cityCount));
+        }
+
+        CacheCounters counters;
+        if (!counters.available()) {
+            std::cerr << "Счетчики perf недоступны: печатается только время" << std::endl;
+        }
+        std::cout << "Граф: " << cityCount << " вершин, " << graph.arcCount() << " дуг; "
+                  << queries << " BFS глубины " << depth << std::endl;
+        std::cout << "порядок " << column("перенум, с", 12) << column("лента", 12)
+                  << column("BFS, с", 12) << column("обращения", 16) << column("промахи", 16)
+                  << column("промах/дуга", 14) << std::endl;
+
+        const VertexOrder orders[] = {VertexOrder::Original, VertexOrder::Degree,
+                                      VertexOrder::BreadthFirst, VertexOrder::ReverseCuthillMcKee};
+        for (VertexOrder order : orders) {
+            std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            VertexPermutation permutation = VertexPermutation::compute(graph, order);
+            CSRGraph relabeled = permutation.apply(graph);
+            double reorderSeconds = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - begin).count();
+
+            // Прогрев, затем замер на тех же городах
+            GraphUtils::breadthFirstSearch(relabeled, permutation.toInternal(sources[0]), depth, BFSTuning());
+            std::uint64_t edges = 0;
+            begin = std::chrono::steady_clock::now();
+            counters.start();
+            for (int source : sources) {
+                edges += GraphUtils::breadthFirstSearch(relabeled, permutation.toInternal(source), depth,
+                                                        BFSTuning()).edgesScanned;
+            }
+            std::pair<std::uint64_t, std::uint64_t> cache = counters.stop();
+            double bfsSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+            std::cout << std::left << std::setw(8) << VertexPermutation::orderName(order) << std::right
+                      << std::fixed << std::setprecision(3) << std::setw(12) << reorderSeconds
+                      << std::setprecision(1) << std::setw(12) << averageBandwidth(relabeled)
+                      << std::setprecision(3) << std::setw(12) << bfsSeconds;
+            if (counters.available()) {
+                std::cout << std::setw(16) << cache.first << std::setw(16) << cache.second
+                          << std::setw(14) << std::setprecision(3)
+                          << (edges > 0 ? static_cast<double>(cache.second) / edges : 0.0);
+            } else {
+                std::cout << column("н/д", 16) << column("н/д", 16) << column("н/д", 14);
+            }
+            std::cout << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "ОШИБКА: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// cd bench && g++ -std=c++11 -O2 -pthread -o reorder_bench reorder_bench.cpp ../csr_graph.cpp ../graph_reader.cpp ../graph_utils.cpp ../vertex_order.cpp ../mapped_file.cpp ../bit_matrix.cpp ../dense_bitset.cpp ../thread_pool.cpp ../radix_heap.cpp ../compressed_graph.cpp ../external_io.cpp
+// ./reorder_bench ../roads.txt --shuffle 1
@@ -0,0 +1,107 @@
+/**
+ * @file bit_matrix.cpp
+ * @brief Реализация битовой матрицы смежности
+ * @version 1.1
+ */
+
+#include "bit_matrix.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <stdexcept>
+
+BitMatrix::BitMatrix(int rowCount, int columnCount)
+    : rowCount_(rowCount), columnCount_(columnCount),
+      wordsPerRow_((static_cast<std::size_t>(columnCount) + 63) / 64),
+      words_(static_cast<std::size_t>(rowCount) * wordsPerRow_, 0) {}
+
+BitMatrix BitMatrix::fromGraph(const CSRGraph& graph) {
+    int n = graph.vertexCount();
+    BitMatrix matrix(n, n);
+
+    for (int v = 0; v < n; ++v) {
+        for (const int* it = graph.neighborsBegin(v); it != graph.neighborsEnd(v); ++it) {
+            matrix.set(v, *it);
+        }
+    }
+
+    return matrix;
+}
+
+BitMatrix BitMatrix::multiply(const BitMatrix& a, const BitMatrix& b, ThreadPool* pool) {
+    if (a.columnCount_ != b.rowCount_) {
+        throw std::runtime_error("Несогласованные размеры при умножении битовых матриц");
+    }
+    
+    BitMatrix c(a.rowCount_, b.columnCount_);
+    const std::size_t stripWords = 16;
+    const std::size_t tableWords = 256 * stripWords;
+    std::size_t strips = (c.wordsPerRow_ + stripWords - 1) / stripWords;
+    int groups = (a.columnCount_ + 7) / 8;
+    std::vector<std::vector<std::uint64_t>> tables(pool ? pool->size() : 1,
+                                                   std::vector<std::uint64_t>(8 * tableWords));
+    
+    auto multiplyStrips = [&](std::size_t begin, std::size_t end, int worker) {
+        std::uint64_t* tablesBase = tables[worker].data();
+        for (std::size_t strip = begin; strip < end; ++strip) {
+            std::size_t first = strip * stripWords;
+            std::size_t width = std::min(stripWords, c.wordsPerRow_ - first);
+            
+            // Восемь групп - одно слово строки a: таблицы строятся для всех
+            // восьми, и каждое слово a читается один раз на полосу
+            for (std::size_t word = 0; word < a.wordsPerRow_; ++word) {
+                int firstGroup = static_cast<int>(word * 8);
+                int wordGroups = std::min(8, groups - firstGroup);
+                
+                // Запись mask таблицы - OR строк группы, отмеченных битами mask
+                for (int g = 0; g < wordGroups; ++g) {
+                    std::uint64_t* table = tablesBase + g * tableWords;
+                    int groupRows = std::min(8, a.columnCount_ - (firstGroup + g) * 8);
+                    std::fill(table, table + width, 0);
+                    for (int bit = 0; bit < groupRows; ++bit) {
+                        const std::uint64_t* source = b.row((firstGroup + g) * 8 + bit) + first;
+                        std::size_t half = std::size_t(1) << bit;
+                        for (std::size_t mask = 0; mask < half; ++mask) {
+                            const std::uint64_t* low = table + mask * width;
+                            std::uint64_t* high = table + (half + mask) * width;
+                            for (std::size_t k = 0; k < width; ++k) {
+                                high[k] = low[k] | source[k];
+                            }
+                        }
+                    }
+                }
+                
+                // Каждая строка a берет по записи на каждый ненулевой байт слова
+                for (int r = 0; r < a.rowCount_; ++r) {
+                    std::uint64_t bits = a.row(r)[word];
+                    if (bits == 0) {
+                        continue;
+                    }
+                    std::uint64_t* target = c.row(r) + first;
+                    for (int g = 0; g < wordGroups; ++g, bits >>= 8) {
+                        unsigned key = static_cast<unsigned>(bits & 0xFF);
+                        if (key == 0) {
+                            continue;
+                        }
+                        const std::uint64_t* source = tablesBase + g * tableWords + key * width;
+                        for (std::size_t k = 0; k < width; ++k) {
+                            target[k] |= source[k];
+                        }
+                    }
+                }
+            }
+        }
+    };
+    
+    if (pool) {
+        pool->parallelFor(strips, 1, multiplyStrips);
+    } else {
+        multiplyStrips(0, strips, 0);
+    }
+    
+    return c;
+}
+
+std::uint64_t BitMatrix::bytesFor(int vertexCount) {
+    std::uint64_t words = (static_cast<std::uint64_t>(vertexCount) + 63) / 64;
+    return static_cast<std::uint64_t>(vertexCount) * words * sizeof(std::uint64_t);
+}
@@ -0,0 +1,133 @@
+/**
+ * @file common_zone_matrix.cpp
+ * @brief Реализация записи матрицы размеров общих зон
+ * @version 1.0
+ */
+
+#include "common_zone_matrix.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    const char kMatrixMagic[8] = {'G', 'R', 'A', 'F', '7', 'C', 'Z', 'M'};
+    const std::uint32_t kMatrixVersion = 1;
+
+    /**
+     * @struct MatrixHeader
+     * @brief Заголовок файла матрицы (64 байта)
+     */
+    struct MatrixHeader {
+        char magic[8];               ///< Сигнатура "GRAF7CZM"
+        std::uint32_t version;       ///< Версия формата
+        std::uint32_t elementBytes;  ///< Размер элемента (4)
+        std::uint64_t vertexCount;   ///< Количество городов
+        std::int64_t L;              ///< Количество промежуточных городов
+        std::uint64_t graphChecksum; ///< CSRGraph::checksum() графа
+        std::uint64_t dataPos;       ///< Позиция первого элемента
+        std::uint64_t reserved[2];   ///< Зарезервировано (0)
+    };
+
+    static_assert(sizeof(MatrixHeader) == 64, "Заголовок матрицы должен занимать 64 байта");
+
+    const int kTile = 64;                  ///< Строк и столбцов в плитке
+    const std::size_t kChunkWords = 256;   ///< Слов строки в блоке накопления (2 КБ)
+}
+
+void CommonZoneMatrix::write(const BitMatrix& neighborhoods, int L, std::uint64_t graphChecksum,
+                             const std::string& filename, ThreadPool* pool) {
+    int n = neighborhoods.rowCount();
+    if (neighborhoods.columnCount() != n) {
+        throw std::runtime_error("Матрица окрестностей должна быть квадратной");
+    }
+    std::size_t words = neighborhoods.wordsPerRow();
+
+    MatrixHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMatrixMagic, sizeof(kMatrixMagic));
+    header.version = kMatrixVersion;
+    header.elementBytes = sizeof(std::uint32_t);
+    header.vertexCount = static_cast<std::uint64_t>(n);
+    header.L = L;
+    header.graphChecksum = graphChecksum;
+    header.dataPos = sizeof(MatrixHeader);
+
+    std::string tempName = filename + ".tmp";
+    std::ofstream out(tempName, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Не удалось создать файл матрицы: " + tempName);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    int columnTiles = (n + kTile - 1) / kTile;
+    std::vector<std::uint32_t> band(static_cast<std::size_t>(kTile) * n);
+
+    for (int rowBegin = 0; rowBegin < n; rowBegin += kTile) {
+        int rows = std::min(kTile, n - rowBegin);
+
+        auto countTiles = [&](std::size_t begin, std::size_t end, int) {
+            std::uint32_t counts[kTile][kTile];
+            for (std::size_t tile = begin; tile < end; ++tile) {
+                int columnBegin = static_cast<int>(tile) * kTile;
+                int columns = std::min(kTile, n - columnBegin);
+                std::memset(counts, 0, sizeof(counts));
+
+                // Блоки слов: 2 × 64 строки по 2 КБ остаются в кэше
+                for (std::size_t chunk = 0; chunk < words; chunk += kChunkWords) {
+                    std::size_t chunkEnd = std::min(words, chunk + kChunkWords);
+                    for (int i = 0; i < rows; ++i) {
+                        const std::uint64_t* left = neighborhoods.row(rowBegin + i);
+                        for (int j = 0; j < columns; ++j) {
+                            const std::uint64_t* right = neighborhoods.row(columnBegin + j);
+                            std::uint32_t common = 0;
+                            for (std::size_t k = chunk; k < chunkEnd; ++k) {
+                                common += static_cast<std::uint32_t>(__builtin_popcountll(left[k] & right[k]));
+                            }
+                            counts[i][j] += common;
+                        }
+                    }
+                }
+
+                // Штаб-квартиры не входят в общую зону
+                for (int i = 0; i < rows; ++i) {
+                    int a = rowBegin + i;
+                    std::uint32_t* target = &band[static_cast<std::size_t>(i) * n + columnBegin];
+                    for (int j = 0; j < columns; ++j) {
+                        int b = columnBegin + j;
+                        target[j] = a == b ? 0
+                            : counts[i][j] - neighborhoods.test(b, a) - neighborhoods.test(a, b);
+                    }
+                }
+            }
+        };
+
+        if (pool) {
+            pool->parallelFor(static_cast<std::size_t>(columnTiles), 1, countTiles);
+        } else {
+            countTiles(0, static_cast<std::size_t>(columnTiles), 0);
+        }
+
+        out.write(reinterpret_cast<const char*>(band.data()),
+                  static_cast<std::streamsize>(sizeof(std::uint32_t) * rows * static_cast<std::size_t>(n)));
+        if (!out) {
+            break;
+        }
+    }
+
+    out.flush();
+    if (!out) {
+        out.close();
+        std::remove(tempName.c_str());
+        throw std::runtime_error("Ошибка записи матрицы: " + tempName);
+    }
+    out.close();
+
+    if (std::rename(tempName.c_str(), filename.c_str()) != 0) {
+        std::remove(tempName.c_str());
+        throw std::runtime_error("Не удалось переименовать матрицу в " + filename);
+    }
+}
@@ -0,0 +1,51 @@
+/**
+ * @file common_zone_matrix.h
+ * @brief Размеры общих зон для всех пар городов
+ * @version 1.0
+ *
+ * Для каждой пары (k1, k2) - количество общих городов при заданном L,
+ * то есть |findCommonCities(k1, k2, L)| (0, если общих нет).
+ * Матрица записывается в двоичный файл без вывода в stdout.
+ */
+
+#ifndef COMMON_ZONE_MATRIX_H
+#define COMMON_ZONE_MATRIX_H
+
+#include "bit_matrix.h"
+#include <cstdint>
+#include <string>
+
+class ThreadPool;
+
+/**
+ * @class CommonZoneMatrix
+ * @brief Запись матрицы попарных размеров общих зон
+ *
+ * Формат файла: заголовок 64 байта (сигнатура "GRAF7CZM", версия,
+ * размер элемента, количество городов, L, контрольная сумма графа),
+ * затем n × n чисел uint32 по строкам. Элемент (i, j) - размер общей
+ * зоны городов i + 1 и j + 1; диагональ нулевая. Матрица симметрична.
+ */
+class CommonZoneMatrix {
+public:
+    /**
+     * @brief Вычисление и запись матрицы
+     *
+     * Строка v матрицы окрестностей - города в пределах L + 1 ребер
+     * от v, включая сам v. Тогда размер общей зоны
+     * |N(i) ∩ N(j)| - [i ∈ N(j)] - [j ∈ N(i)]. Пересечения считаются
+     * плитками 64 × 64 строк с накоплением popcount(AND) по блокам
+     * слов, плитки одной полосы строк распределяются по потокам,
+     * готовая полоса сразу пишется в файл.
+     * @param neighborhoods Матрица окрестностей n × n
+     * @param L Количество промежуточных городов (для заголовка)
+     * @param graphChecksum CSRGraph::checksum() графа (для заголовка)
+     * @param filename Имя файла (запись через временный файл)
+     * @param pool Пул потоков (nullptr - в вызывающем потоке)
+     * @throws std::runtime_error при ошибке записи или неквадратной матрице
+     */
+    static void write(const BitMatrix& neighborhoods, int L, std::uint64_t graphChecksum,
+                      const std::string& filename, ThreadPool* pool = nullptr);
+};
+
+#endif // COMMON_ZONE_MATRIX_H
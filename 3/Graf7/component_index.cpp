@@ -0,0 +1,154 @@
+/**
+ * @file component_index.cpp
+ * @brief Реализация индекса компонент связности
+ * @version 1.2
+ */
+
+#include "component_index.h"
+#include "adjacency.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+    /**
+     * @class DisjointSets
+     * @brief Система непересекающихся множеств
+     */
+    class DisjointSets {
+    private:
+        std::vector<int> parent_;
+        std::vector<int> size_;
+
+    public:
+        explicit DisjointSets(int n) : parent_(n), size_(n, 1) {
+            for (int v = 0; v < n; ++v) {
+                parent_[v] = v;
+            }
+        }
+
+        int find(int v) {
+            // Сжатие путей делением пополам
+            while (parent_[v] != v) {
+                parent_[v] = parent_[parent_[v]];
+                v = parent_[v];
+            }
+            return v;
+        }
+
+        void unite(int u, int v) {
+            u = find(u);
+            v = find(v);
+            if (u == v) {
+                return;
+            }
+            if (size_[u] < size_[v]) {
+                std::swap(u, v);
+            }
+            parent_[v] = u;
+            size_[u] += size_[v];
+        }
+    };
+}
+
+ComponentIndex ComponentIndex::build(const CSRGraph& graph, const CSRGraph* reverse) {
+    CSRAdjacency forward(graph);
+    if (reverse == nullptr) {
+        return buildFrom(forward, static_cast<CSRAdjacency*>(nullptr));
+    }
+    CSRAdjacency backward(*reverse);
+    return buildFrom(forward, &backward);
+}
+
+ComponentIndex ComponentIndex::build(const CompressedGraph& graph, const CompressedGraph* reverse) {
+    CompressedAdjacency forward(graph);
+    if (reverse == nullptr) {
+        return buildFrom(forward, static_cast<CompressedAdjacency*>(nullptr));
+    }
+    CompressedAdjacency backward(*reverse);
+    return buildFrom(forward, &backward);
+}
+
+template <class Adjacency>
+ComponentIndex ComponentIndex::buildFrom(Adjacency& graph, Adjacency* reverse) {
+    int n = graph.vertexCount();
+    ComponentIndex index;
+
+    // У неориентированного графа каждое ребро лежит в двух списках,
+    // у ориентированного дуга v → u - только в списке v
+    DisjointSets sets(n);
+    for (int v = 0; v < n; ++v) {
+        NeighborRange range = graph.neighbors(v);
+        for (const int* it = range.first; it != range.second; ++it) {
+            if (*it > v || reverse != nullptr) {
+                sets.unite(v, *it);
+            }
+        }
+    }
+
+    // Номера компонент - в порядке наименьших вершин; корень - вершина
+    // наибольшей степени
+    index.component_.resize(n);
+    std::vector<int> labelOfRoot(n, -1);
+    std::vector<int> roots;
+    for (int v = 0; v < n; ++v) {
+        int& label = labelOfRoot[sets.find(v)];
+        if (label == -1) {
+            label = static_cast<int>(roots.size());
+            roots.push_back(v);
+        }
+        index.component_[v] = label;
+        if (graph.degree(v) > graph.degree(roots[label])) {
+            roots[label] = v;
+        }
+    }
+
+    // Списки вершин подсчетом; внутри компоненты вершины по возрастанию
+    int components = static_cast<int>(roots.size());
+    index.memberOffsets_.assign(components + 1, 0);
+    for (int v = 0; v < n; ++v) {
+        ++index.memberOffsets_[index.component_[v] + 1];
+    }
+    for (int c = 0; c < components; ++c) {
+        index.memberOffsets_[c + 1] += index.memberOffsets_[c];
+    }
+    index.members_.resize(n);
+    std::vector<int> cursor(index.memberOffsets_.begin(), index.memberOffsets_.end() - 1);
+    for (int v = 0; v < n; ++v) {
+        index.members_[cursor[index.component_[v]]++] = v;
+    }
+
+    // BFS из корня каждой компоненты: один массив расстояний на все
+    index.rootDistance_.assign(n, -1);
+    index.rootEccentricity_.assign(components, 0);
+    std::vector<int> queue(static_cast<std::size_t>(n));
+    for (int c = 0; c < components; ++c) {
+        std::size_t head = 0;
+        std::size_t tail = 0;
+        queue[tail++] = roots[c];
+        index.rootDistance_[roots[c]] = 0;
+        while (head < tail) {
+            int current = queue[head++];
+            int next = index.rootDistance_[current] + 1;
+            NeighborRange range = graph.neighbors(current);
+            for (const int* it = range.first; it != range.second; ++it) {
+                if (index.rootDistance_[*it] == -1) {
+                    index.rootDistance_[*it] = next;
+                    queue[tail++] = *it;
+                }
+            }
+            if (reverse == nullptr) {
+                continue;
+            }
+            range = reverse->neighbors(current);
+            for (const int* it = range.first; it != range.second; ++it) {
+                if (index.rootDistance_[*it] == -1) {
+                    index.rootDistance_[*it] = next;
+                    queue[tail++] = *it;
+                }
+            }
+        }
+        index.rootEccentricity_[c] = index.rootDistance_[queue[tail - 1]];
+    }
+
+    return index;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file component_index.h
+ * @brief Компоненты связности и оценки эксцентриситетов
+ * @version 1.2
+ *
+ * Строится один раз при создании анализатора и позволяет отвечать
+ * без обхода на запросы со штаб-квартирами в разных компонентах и на
+ * запросы, у которых L + 1 не меньше эксцентриситета обеих штаб-квартир.
+ */
+
+#ifndef COMPONENT_INDEX_H
+#define COMPONENT_INDEX_H
+
+#include "compressed_graph.h"
+#include "csr_graph.h"
+#include <vector>
+
+/**
+ * @class ComponentIndex
+ * @brief Номера компонент, списки их вершин и верхние оценки эксцентриситетов
+ *
+ * Компоненты находятся системой непересекающихся множеств (union-find)
+ * со сжатием путей и объединением по размеру. В каждой компоненте
+ * выполняется BFS из вершины наибольшей степени (корня); тогда
+ * ecc(v) ≤ d(v, корень) + ecc(корень) по неравенству треугольника.
+ * Для ориентированного графа строятся слабые компоненты, а расстояния
+ * и оценки относятся к графу без учета направлений.
+ */
+class ComponentIndex {
+private:
+    std::vector<int> component_;         ///< Номер компоненты каждой вершины
+    std::vector<int> memberOffsets_;     ///< Начало списка вершин компоненты в members_
+    std::vector<int> members_;           ///< Вершины, сгруппированные по компонентам (по возрастанию)
+    std::vector<int> rootDistance_;      ///< Расстояние от вершины до корня ее компоненты
+    std::vector<int> rootEccentricity_;  ///< Эксцентриситет корня каждой компоненты
+
+public:
+    /**
+     * @brief Построение индекса
+     *
+     * Сложность O(V + E · α(V)) на union-find и O(V + E) на обходы
+     * @param graph Неориентированный граф (у ориентированного - исходящие дуги)
+     * @param reverse Входящие дуги ориентированного графа; nullptr - граф неориентированный
+     * @return ComponentIndex Индекс
+     */
+    static ComponentIndex build(const CSRGraph& graph, const CSRGraph* reverse = nullptr);
+
+    /**
+     * @brief Построение индекса по сжатым спискам соседей
+     *
+     * То же, что build для CSR; списки распаковываются при обходе
+     * @param graph Неориентированный граф (у ориентированного - исходящие дуги)
+     * @param reverse Входящие дуги ориентированного графа; nullptr - граф неориентированный
+     * @return ComponentIndex Индекс
+     */
+    static ComponentIndex build(const CompressedGraph& graph, const CompressedGraph* reverse = nullptr);
+
+    /**
+     * @brief Количество компонент
+     * @return int Количество компонент
+     */
+    int componentCount() const { return static_cast<int>(rootEccentricity_.size()); }
+
+    /**
+     * @brief Компонента вершины
+     * @param vertex Вершина (0-based)
+     * @return int Номер компоненты
+     */
+    int componentOf(int vertex) const { return component_[vertex]; }
+
+    /**
+     * @brief Лежат ли вершины в одной компоненте
+     * @param u Первая вершина (0-based)
+     * @param v Вторая вершина (0-based)
+     * @return true если между вершинами есть путь
+     */
+    bool connected(int u, int v) const { return component_[u] == component_[v]; }
+
+    /**
+     * @brief Вершины компоненты
+     * @param c Номер компоненты
+     * @return const int* Начало списка (вершины по возрастанию)
+     */
+    const int* membersBegin(int c) const { return members_.data() + memberOffsets_[c]; }
+
+    /**
+     * @brief Конец списка вершин компоненты
+     * @param c Номер компоненты
+     * @return const int* Указатель за последней вершиной
+     */
+    const int* membersEnd(int c) const { return members_.data() + memberOffsets_[c + 1]; }
+
+    /**
+     * @brief Верхняя оценка эксцентриситета вершины
+     * @param vertex Вершина (0-based)
+     * @return int Расстояние, в пределах которого лежит вся ее компонента
+     */
+    int eccentricityBound(int vertex) const {
+        return rootDistance_[vertex] + rootEccentricity_[component_[vertex]];
+    }
+
+private:
+    /**
+     * @brief Построение индекса по спискам соседей в любом представлении (adjacency.h)
+     * @param graph Исходящие дуги
+     * @param reverse Входящие дуги; nullptr - граф неориентированный
+     * @return ComponentIndex Индекс
+     */
+    template <class Adjacency>
+    static ComponentIndex buildFrom(Adjacency& graph, Adjacency* reverse);
+};
+
+#endif // COMPONENT_INDEX_H
@@ -0,0 +1,268 @@
+/**
+ * @file compressed_graph.cpp
+ * @brief Реализация сжатых списков соседей
+ * @version 1.1
+ */
+
+#include "compressed_graph.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Количество байт значения (1-4)
+ * @param value Значение
+ * @return int Длина в байтах
+ */
+int encodedLength(std::uint32_t value) {
+    if (value < (1u << 8)) {
+        return 1;
+    }
+    if (value < (1u << 16)) {
+        return 2;
+    }
+    if (value < (1u << 24)) {
+        return 3;
+    }
+    return 4;
+}
+
+/**
+ * @brief Значения списка соседей перед упаковкой
+ * @param v Вершина
+ * @param index Номер соседа
+ * @param neighbors Соседи вершины
+ * @return std::uint32_t zigzag первого смещения или разность соседних
+ */
+std::uint32_t gapValue(int v, int index, const int* neighbors) {
+    if (index > 0) {
+        return static_cast<std::uint32_t>(neighbors[index] - neighbors[index - 1]);
+    }
+    std::int64_t delta = static_cast<std::int64_t>(neighbors[0]) - v;
+    return static_cast<std::uint32_t>(delta < 0 ? -2 * delta - 1 : 2 * delta);
+}
+
+#ifdef __SSSE3__
+/**
+ * @struct DecodeTables
+ * @brief Маски перестановки байт и длины четверок по управляющему байту
+ */
+struct DecodeTables {
+    std::uint8_t shuffle[256][16];  ///< Байт назначения ← байт источника (0x80 - ноль)
+    std::uint8_t length[256];       ///< Суммарная длина четверки
+
+    DecodeTables() {
+        for (int key = 0; key < 256; ++key) {
+            int source = 0;
+            for (int k = 0; k < 4; ++k) {
+                int bytes = ((key >> (2 * k)) & 3) + 1;
+                for (int b = 0; b < 4; ++b) {
+                    shuffle[key][4 * k + b] = static_cast<std::uint8_t>(b < bytes ? source + b : 0x80);
+                }
+                source += bytes;
+            }
+            length[key] = static_cast<std::uint8_t>(source);
+        }
+    }
+};
+
+const DecodeTables& decodeTables() {
+    static const DecodeTables tables;
+    return tables;
+}
+#endif
+
+} // namespace
+
+const std::size_t CompressedGraph::kPadding;
+const std::size_t CompressedGraph::kSegmentBytes;
+const int CompressedGraph::kMaxRanges;
+
+CompressedGraph::CompressedGraph()
+    : vertexCount_(0), arcCount_(0), maxDegree_(0), segments_(std::make_shared<Segments>()),
+      neighborBytes_(0), segmentBytes_(0) {}
+
+CompressedGraph::Encoder::Encoder(int vertexCount)
+    : vertexCount_(vertexCount), next_(0), segmentFirst_(0), segments_(std::make_shared<Segments>()) {
+    graph_.vertexCount_ = vertexCount;
+    graph_.blocks_.resize(static_cast<std::size_t>(vertexCount));
+    graph_.degrees_.resize(static_cast<std::size_t>(vertexCount));
+}
+
+void CompressedGraph::Encoder::addRow(const int* neighbors, int degree) {
+    if (next_ == vertexCount_) {
+        throw std::runtime_error("Лишняя строка сжатого графа: вершин " + std::to_string(vertexCount_));
+    }
+
+    // Место под худший случай (4 байта на значение) выделяется без
+    // перераспределения куска: указатели на его блоки остаются верны
+    std::size_t controlBytes = static_cast<std::size_t>(degree + 3) / 4;
+    std::size_t worstBytes = controlBytes + 4 * static_cast<std::size_t>(degree);
+    if (segment_.size() + worstBytes + kPadding > segment_.capacity()) {
+        closeSegment();
+        segment_.reserve(std::max(kSegmentBytes, worstBytes + kPadding));
+    }
+
+    int v = next_++;
+    std::size_t start = segment_.size();
+    segment_.resize(start + worstBytes, 0);
+    std::uint8_t* control = segment_.data() + start;
+    std::uint8_t* data = control + controlBytes;
+    for (int i = 0; i < degree; ++i) {
+        std::uint32_t value = gapValue(v, i, neighbors);
+        int length = encodedLength(value);
+        control[i >> 2] |= static_cast<std::uint8_t>((length - 1) << ((i & 3) * 2));
+        for (int b = 0; b < length; ++b) {
+            *data++ = static_cast<std::uint8_t>(value >> (8 * b));
+        }
+    }
+    segment_.resize(static_cast<std::size_t>(data - segment_.data()));
+
+    graph_.blocks_[v] = control;
+    graph_.degrees_[v] = degree;
+    graph_.maxDegree_ = std::max(graph_.maxDegree_, degree);
+    graph_.arcCount_ += degree;
+}
+
+void CompressedGraph::Encoder::closeSegment() {
+    if (next_ == segmentFirst_) {
+        return;
+    }
+    // Незаполненный хвост емкости не затронут и памяти не занимает
+    graph_.neighborBytes_ += segment_.size();
+    segment_.resize(segment_.size() + kPadding, 0);
+
+    graph_.segmentBytes_ += segment_.size();
+    segments_->push_back(std::vector<std::uint8_t>());
+    segments_->back().swap(segment_);
+    segmentFirst_ = next_;
+}
+
+CompressedGraph CompressedGraph::Encoder::finish() {
+    if (next_ != vertexCount_) {
+        throw std::runtime_error("Сжаты не все строки графа: " + std::to_string(next_) + " из " +
+                                 std::to_string(vertexCount_));
+    }
+    closeSegment();
+    graph_.segments_ = segments_;
+    return std::move(graph_);
+}
+
+CompressedGraph CompressedGraph::fromCSR(const CSRGraph& graph) {
+    Encoder encoder(graph.vertexCount());
+    for (int v = 0; v < graph.vertexCount(); ++v) {
+        encoder.addRow(graph.neighborsBegin(v), graph.degree(v));
+    }
+    return encoder.finish();
+}
+
+CompressedGraph CompressedGraph::fromArcs(const std::vector<std::int64_t>& offsets,
+                                          const std::function<void(RowRange&)>& arcs) {
+    int n = static_cast<int>(offsets.size()) - 1;
+    const std::int64_t minRangeArcs = std::int64_t(1) << 22;
+    std::int64_t rangeArcs = std::max(minRangeArcs, (offsets[n] + kMaxRanges - 1) / kMaxRanges);
+
+    Encoder encoder(n);
+    RowRange range;
+    for (int begin = 0; begin < n;) {
+        // Диапазон закрывается, как только набрал rangeArcs дуг
+        int end = begin;
+        while (end < n && offsets[end] - offsets[begin] < rangeArcs) {
+            ++end;
+        }
+        range.begin_ = begin;
+        range.end_ = end;
+        range.cursor_.assign(offsets.begin() + begin, offsets.begin() + end);
+        for (std::int64_t& position : range.cursor_) {
+            position -= offsets[begin];
+        }
+        range.neighbors_.resize(static_cast<std::size_t>(offsets[end] - offsets[begin]));
+        if (!range.neighbors_.empty()) {
+            arcs(range);
+        }
+
+        for (int v = begin; v < end; ++v) {
+            int* row = range.neighbors_.data() + (offsets[v] - offsets[begin]);
+            int* rowEnd = range.neighbors_.data() + range.cursor_[v - begin];
+            std::sort(row, rowEnd);
+            rowEnd = std::unique(row, rowEnd);
+            encoder.addRow(row, static_cast<int>(rowEnd - row));
+        }
+        begin = end;
+    }
+    return encoder.finish();
+}
+
+CompressedGraph CompressedGraph::transposed() const {
+    int n = vertexCount_;
+    std::vector<int> row(static_cast<std::size_t>(maxDegree_) + 1);
+    std::vector<std::int64_t> offsets(static_cast<std::size_t>(n) + 1, 0);
+    for (int v = 0; v < n; ++v) {
+        decode(v, row.data());
+        for (int i = 0; i < degrees_[v]; ++i) {
+            ++offsets[row[i] + 1];
+        }
+    }
+    for (int v = 0; v < n; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+
+    // Источники идут по возрастанию - строки диапазона уже отсортированы
+    return fromArcs(offsets, [this, &row](RowRange& range) {
+        for (int v = 0; v < vertexCount_; ++v) {
+            decode(v, row.data());
+            for (int i = 0; i < degrees_[v]; ++i) {
+                range.add(row[i], v);
+            }
+        }
+    });
+}
+
+void CompressedGraph::decode(int v, int* out) const {
+    int degree = degrees_[v];
+    if (degree == 0) {
+        return;
+    }
+    const std::uint8_t* control = blocks_[v];
+    const std::uint8_t* data = control + (degree + 3) / 4;
+    std::uint32_t* values = reinterpret_cast<std::uint32_t*>(out);
+    int i = 0;
+
+#ifdef __SSSE3__
+    // Полные четверки: 16 байт читаются разом (за концом - следующий блок или запас)
+    const DecodeTables& tables = decodeTables();
+    for (; i + 4 <= degree; i += 4) {
+        std::uint8_t key = control[i >> 2];
+        __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables.shuffle[key]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), _mm_shuffle_epi8(packed, mask));
+        data += tables.length[key];
+    }
+#endif
+
+    for (; i < degree; ++i) {
+        int length = ((control[i >> 2] >> ((i & 3) * 2)) & 3) + 1;
+        std::uint32_t value = 0;
+        for (int b = 0; b < length; ++b) {
+            value |= static_cast<std::uint32_t>(data[b]) << (8 * b);
+        }
+        values[i] = value;
+        data += length;
+    }
+
+    // Обратно от разностей к номерам
+    std::uint32_t first = values[0];
+    std::int64_t delta = (first & 1) ? -(static_cast<std::int64_t>(first) + 1) / 2 : first / 2;
+    out[0] = static_cast<int>(v + delta);
+    for (i = 1; i < degree; ++i) {
+        out[i] = out[i - 1] + static_cast<int>(values[i]);
+    }
+}
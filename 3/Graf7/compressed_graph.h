@@ -0,0 +1,229 @@
+/**
+ * @file compressed_graph.h
+ * @brief Сжатые списки соседей (разности + stream-vbyte)
+ * @version 1.1
+ *
+ * На больших графах память занимает массив соседей int32. Здесь
+ * отсортированные соседи хранятся разностями, а разности - целыми
+ * переменной длины (1-4 байта) в раскладке stream-vbyte: длины
+ * четверки значений лежат в одном управляющем байте, байты значений -
+ * отдельно. Четверка распаковывается одной перестановкой байт (SSSE3),
+ * поэтому BFS распаковывает списки на лету почти без потерь скорости.
+ */
+
+#ifndef COMPRESSED_GRAPH_H
+#define COMPRESSED_GRAPH_H
+
+#include "csr_graph.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @class CompressedGraph
+ * @brief Граф со сжатыми списками соседей
+ *
+ * Блок вершины v: ceil(d / 4) управляющих байт, затем d значений.
+ * Первое значение - zigzag(neighbors[0] - v), остальные -
+ * neighbors[i] - neighbors[i - 1] (не меньше 1: соседи различны).
+ * После перенумерации вершин (vertex_order.h) разности малы, и
+ * большинство значений занимает один байт.
+ *
+ * Блоки лежат подряд в кусках около kSegmentBytes, каждый кусок
+ * заканчивается kPadding нулевыми байтами. Граф строится построчно
+ * (Encoder) и не требует заранее ни CSR, ни общего размера; копии
+ * разделяют куски, как копии CSRGraph - массивы.
+ */
+class CompressedGraph {
+private:
+    typedef std::vector<std::vector<std::uint8_t>> Segments;
+
+    int vertexCount_;
+    std::int64_t arcCount_;
+    int maxDegree_;
+    std::vector<const std::uint8_t*> blocks_;  ///< Начало блока вершины в одном из кусков
+    std::vector<int> degrees_;
+    std::shared_ptr<const Segments> segments_;
+    std::size_t neighborBytes_;                ///< Байт в блоках (без запаса кусков)
+    std::size_t segmentBytes_;                 ///< Байт во всех кусках
+
+public:
+    /**
+     * @brief Запас байт в конце куска (16-байтное чтение четверки)
+     */
+    static const std::size_t kPadding = 16;
+
+    /**
+     * @brief Емкость куска: строка, которая в нем не помещается, начинает следующий
+     */
+    static const std::size_t kSegmentBytes = std::size_t(1) << 24;
+
+    /**
+     * @brief Наибольшее число проходов fromArcs по дугам
+     */
+    static const int kMaxRanges = 8;
+
+    class Encoder;
+
+    /**
+     * @class RowRange
+     * @brief Строки диапазона вершин, собираемые из перечисления всех дуг (см. fromArcs)
+     */
+    class RowRange {
+    private:
+        friend class CompressedGraph;
+
+        int begin_;
+        int end_;
+        std::vector<std::int64_t> cursor_;  ///< Следующая позиция строки в neighbors_
+        std::vector<int> neighbors_;
+
+        RowRange() : begin_(0), end_(0) {}
+
+    public:
+        /**
+         * @brief Добавление дуги (дуги из вершин вне диапазона пропускаются)
+         * @param from Начало дуги (0-based)
+         * @param to Конец дуги (0-based)
+         */
+        void add(int from, int to) {
+            if (from >= begin_ && from < end_) {
+                neighbors_[cursor_[from - begin_]++] = to;
+            }
+        }
+    };
+
+    /**
+     * @brief Конструктор пустого графа
+     */
+    CompressedGraph();
+
+    /**
+     * @brief Сжатие графа
+     *
+     * Вершины кодируются по порядку, граф читается один раз
+     * последовательно (подходит и для отображенного снимка)
+     * @param graph Граф в формате CSR
+     * @return CompressedGraph Сжатый граф
+     */
+    static CompressedGraph fromCSR(const CSRGraph& graph);
+
+    /**
+     * @brief Сжатие графа, дуги которого перечисляются заново для каждого диапазона вершин
+     *
+     * Для списка ребер в тексте и для транспонирования, где строки
+     * не идут по порядку. Вершины делятся не больше чем на kMaxRanges
+     * диапазонов; для каждого arcs(range) перечисляет все дуги, дуги
+     * из вершин диапазона раскладываются подсчетом, строки сортируются
+     * и повторы удаляются. CSR целиком не строится: в памяти дуги
+     * одного диапазона
+     * @param offsets Префиксные суммы числа дуг, которые arcs перечислит из каждой вершины (vertexCount + 1)
+     * @param arcs Перечисление дуг через RowRange::add, каждый раз одних и тех же
+     * @return CompressedGraph Сжатый граф
+     */
+    static CompressedGraph fromArcs(const std::vector<std::int64_t>& offsets,
+                                    const std::function<void(RowRange&)>& arcs);
+
+    /**
+     * @brief Транспонированный граф
+     *
+     * Строится fromArcs из распакованных строк, без CSR
+     * @return CompressedGraph Граф с обращенными дугами
+     */
+    CompressedGraph transposed() const;
+
+    /**
+     * @brief Количество вершин
+     * @return int Количество вершин
+     */
+    int vertexCount() const { return vertexCount_; }
+
+    /**
+     * @brief Количество дуг
+     * @return std::int64_t Количество ориентированных дуг
+     */
+    std::int64_t arcCount() const { return arcCount_; }
+
+    /**
+     * @brief Степень вершины
+     * @param v Вершина (0-based)
+     * @return int Количество соседей
+     */
+    int degree(int v) const { return degrees_[v]; }
+
+    /**
+     * @brief Наибольшая степень (размер буфера для decode)
+     * @return int Наибольшая степень
+     */
+    int maxDegree() const { return maxDegree_; }
+
+    /**
+     * @brief Распаковка соседей вершины
+     * @param v Вершина (0-based)
+     * @param[out] out Буфер не меньше degree(v) элементов; соседи по возрастанию
+     */
+    void decode(int v, int* out) const;
+
+    /**
+     * @brief Размер сжатых списков
+     * @return std::size_t Байт в блоках соседей
+     */
+    std::size_t neighborBytes() const { return neighborBytes_; }
+
+    /**
+     * @brief Полный объем памяти
+     * @return std::size_t Байт (куски, начала блоков и степени)
+     */
+    std::size_t memoryBytes() const {
+        return segmentBytes_ + blocks_.size() * sizeof(const std::uint8_t*) + degrees_.size() * sizeof(int);
+    }
+};
+
+/**
+ * @class Encoder
+ * @brief Построчное сжатие: строки добавляются по возрастанию номера вершины
+ *
+ * Блоки пишутся прямо в текущий кусок, емкость которого выделена
+ * заранее; строка, не помещающаяся целиком, начинает новый кусок.
+ * Готовые блоки не перекопируются, и указатели на них не меняются.
+ */
+class CompressedGraph::Encoder {
+private:
+    int vertexCount_;
+    int next_;                           ///< Следующая вершина
+    int segmentFirst_;                   ///< Первая вершина текущего куска
+    std::vector<std::uint8_t> segment_;  ///< Текущий кусок; емкость не растет, пока он открыт
+    std::shared_ptr<Segments> segments_;
+    CompressedGraph graph_;
+
+    /**
+     * @brief Запас в конце текущего куска и перенос его в граф
+     */
+    void closeSegment();
+
+public:
+    /**
+     * @brief Начало сжатия графа
+     * @param vertexCount Количество вершин
+     */
+    explicit Encoder(int vertexCount);
+
+    /**
+     * @brief Добавление строки следующей вершины
+     * @param neighbors Соседи по строгому возрастанию
+     * @param degree Количество соседей
+     * @throws std::runtime_error если все строки уже добавлены
+     */
+    void addRow(const int* neighbors, int degree);
+
+    /**
+     * @brief Завершение сжатия
+     * @return CompressedGraph Сжатый граф
+     * @throws std::runtime_error если добавлены не все строки
+     */
+    CompressedGraph finish();
+};
+
+#endif // COMPRESSED_GRAPH_H
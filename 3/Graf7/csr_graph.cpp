@@ -0,0 +1,267 @@
+/**
+ * @file csr_graph.cpp
+ * @brief Реализация графа в формате CSR
+ * @version 1.2
+ */
+
+#include "csr_graph.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    /**
+     * @struct OwnedArrays
+     * @brief Владелец массивов графа, построенного в памяти
+     */
+    struct OwnedArrays {
+        std::vector<std::int64_t> offsets;
+        std::vector<int> neighbors;
+        std::vector<std::uint32_t> weights;
+    };
+    
+    /**
+     * @brief Проверка согласованности массива смещений
+     * @param vertexCount Количество вершин
+     * @param offsets Массив смещений
+     * @param arcCount Длина массива соседей
+     * @throws std::runtime_error если массивы не согласованы
+     */
+    void checkArrays(int vertexCount, const std::vector<std::int64_t>& offsets, std::int64_t arcCount) {
+        if (vertexCount < 0 || offsets.size() != static_cast<size_t>(vertexCount) + 1) {
+            throw std::runtime_error("Некорректный массив смещений CSR");
+        }
+        if (offsets.front() != 0 || offsets.back() != arcCount) {
+            throw std::runtime_error("Массив смещений CSR не согласован с массивом соседей");
+        }
+    }
+}
+
+CSRGraph::CSRGraph() : CSRGraph(0, std::vector<std::int64_t>(1, 0), std::vector<int>()) {}
+
+CSRGraph::CSRGraph(int vertexCount, std::vector<std::int64_t> offsets, std::vector<int> neighbors)
+    : vertexCount_(vertexCount), arcCount_(static_cast<std::int64_t>(neighbors.size())),
+      offsets_(nullptr), neighbors_(nullptr), weights_(nullptr) {
+    checkArrays(vertexCount_, offsets, arcCount_);
+    
+    std::shared_ptr<OwnedArrays> arrays = std::make_shared<OwnedArrays>();
+    arrays->offsets = std::move(offsets);
+    arrays->neighbors = std::move(neighbors);
+    offsets_ = arrays->offsets.data();
+    neighbors_ = arrays->neighbors.data();
+    storage_ = arrays;
+}
+
+CSRGraph::CSRGraph(int vertexCount, std::vector<std::int64_t> offsets, std::vector<int> neighbors,
+                   std::vector<std::uint32_t> weights)
+    : vertexCount_(vertexCount), arcCount_(static_cast<std::int64_t>(neighbors.size())),
+      offsets_(nullptr), neighbors_(nullptr), weights_(nullptr) {
+    checkArrays(vertexCount_, offsets, arcCount_);
+    if (weights.size() != neighbors.size()) {
+        throw std::runtime_error("Массив весов CSR не согласован с массивом соседей");
+    }
+    
+    std::shared_ptr<OwnedArrays> arrays = std::make_shared<OwnedArrays>();
+    arrays->offsets = std::move(offsets);
+    arrays->neighbors = std::move(neighbors);
+    arrays->weights = std::move(weights);
+    offsets_ = arrays->offsets.data();
+    neighbors_ = arrays->neighbors.data();
+    weights_ = arrays->weights.data();
+    storage_ = arrays;
+}
+
+CSRGraph CSRGraph::fromExternal(int vertexCount, std::int64_t arcCount,
+                                const std::int64_t* offsets, const int* neighbors,
+                                std::shared_ptr<const void> owner,
+                                const std::uint32_t* weights) {
+    CSRGraph graph;
+    graph.vertexCount_ = vertexCount;
+    graph.arcCount_ = arcCount;
+    graph.offsets_ = offsets;
+    graph.neighbors_ = neighbors;
+    graph.weights_ = weights;
+    graph.storage_ = std::move(owner);
+    return graph;
+}
+
+CSRGraph CSRGraph::fromEdges(int vertexCount, const std::vector<std::pair<int, int>>& edges,
+                             bool symmetric) {
+    std::vector<std::int64_t> offsets(static_cast<size_t>(vertexCount) + 1, 0);
+
+    // Подсчет степеней
+    for (const auto& edge : edges) {
+        if (edge.first < 0 || edge.first >= vertexCount ||
+            edge.second < 0 || edge.second >= vertexCount) {
+            throw std::runtime_error("Номер вершины вне диапазона: " +
+                                     std::to_string(edge.first + 1) + " " +
+                                     std::to_string(edge.second + 1));
+        }
+        ++offsets[edge.first + 1];
+        if (symmetric && edge.first != edge.second) {
+            ++offsets[edge.second + 1];
+        }
+    }
+
+    for (int v = 0; v < vertexCount; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+
+    // Раскладка соседей по строкам (сортировка подсчетом)
+    std::vector<int> neighbors(static_cast<size_t>(offsets[vertexCount]));
+    std::vector<std::int64_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (const auto& edge : edges) {
+        neighbors[cursor[edge.first]++] = edge.second;
+        if (symmetric && edge.first != edge.second) {
+            neighbors[cursor[edge.second]++] = edge.first;
+        }
+    }
+
+    // Сортировка строк и удаление кратных ребер с уплотнением
+    std::int64_t write = 0;
+    for (int v = 0; v < vertexCount; ++v) {
+        auto rowBegin = neighbors.begin() + offsets[v];
+        auto rowEnd = neighbors.begin() + offsets[v + 1];
+        std::sort(rowBegin, rowEnd);
+        auto uniqueEnd = std::unique(rowBegin, rowEnd);
+
+        offsets[v] = write;
+        write = std::copy(rowBegin, uniqueEnd, neighbors.begin() + write) - neighbors.begin();
+    }
+    offsets[vertexCount] = write;
+    neighbors.resize(static_cast<size_t>(write));
+    neighbors.shrink_to_fit();
+
+    return CSRGraph(vertexCount, std::move(offsets), std::move(neighbors));
+}
+
+CSRGraph CSRGraph::fromWeightedEdges(int vertexCount, const std::vector<WeightedEdge>& edges,
+                                     bool symmetric) {
+    std::vector<std::int64_t> offsets(static_cast<size_t>(vertexCount) + 1, 0);
+    
+    for (const WeightedEdge& edge : edges) {
+        if (edge.u < 0 || edge.u >= vertexCount || edge.v < 0 || edge.v >= vertexCount) {
+            throw std::runtime_error("Номер вершины вне диапазона: " +
+                                     std::to_string(edge.u + 1) + " " +
+                                     std::to_string(edge.v + 1));
+        }
+        ++offsets[edge.u + 1];
+        if (symmetric && edge.u != edge.v) {
+            ++offsets[edge.v + 1];
+        }
+    }
+    
+    for (int v = 0; v < vertexCount; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    
+    // Пары (сосед, вес): после сортировки первым идет самое легкое из кратных ребер
+    std::vector<std::pair<int, std::uint32_t>> arcs(static_cast<size_t>(offsets[vertexCount]));
+    std::vector<std::int64_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (const WeightedEdge& edge : edges) {
+        arcs[cursor[edge.u]++] = std::make_pair(edge.v, edge.weight);
+        if (symmetric && edge.u != edge.v) {
+            arcs[cursor[edge.v]++] = std::make_pair(edge.u, edge.weight);
+        }
+    }
+    
+    std::vector<int> neighbors;
+    std::vector<std::uint32_t> weights;
+    neighbors.reserve(arcs.size());
+    weights.reserve(arcs.size());
+    for (int v = 0; v < vertexCount; ++v) {
+        auto rowBegin = arcs.begin() + offsets[v];
+        auto rowEnd = arcs.begin() + offsets[v + 1];
+        std::sort(rowBegin, rowEnd);
+        
+        offsets[v] = static_cast<std::int64_t>(neighbors.size());
+        for (auto it = rowBegin; it != rowEnd; ++it) {
+            if (neighbors.size() > static_cast<size_t>(offsets[v]) && neighbors.back() == it->first) {
+                continue;
+            }
+            neighbors.push_back(it->first);
+            weights.push_back(it->second);
+        }
+    }
+    offsets[vertexCount] = static_cast<std::int64_t>(neighbors.size());
+    
+    return CSRGraph(vertexCount, std::move(offsets), std::move(neighbors), std::move(weights));
+}
+
+CSRGraph CSRGraph::transposed() const {
+    std::vector<std::int64_t> offsets(static_cast<size_t>(vertexCount_) + 1, 0);
+    for (std::int64_t i = 0; i < arcCount_; ++i) {
+        ++offsets[neighbors_[i] + 1];
+    }
+    for (int v = 0; v < vertexCount_; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    
+    // Источники перебираются по возрастанию - строки сразу отсортированы
+    std::vector<int> neighbors(static_cast<size_t>(arcCount_));
+    std::vector<std::uint32_t> weights(weights_ != nullptr ? static_cast<size_t>(arcCount_) : 0);
+    std::vector<std::int64_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (int u = 0; u < vertexCount_; ++u) {
+        for (std::int64_t i = offsets_[u]; i < offsets_[u + 1]; ++i) {
+            std::int64_t position = cursor[neighbors_[i]]++;
+            neighbors[position] = u;
+            if (weights_ != nullptr) {
+                weights[position] = weights_[i];
+            }
+        }
+    }
+    
+    if (weights_ == nullptr) {
+        return CSRGraph(vertexCount_, std::move(offsets), std::move(neighbors));
+    }
+    return CSRGraph(vertexCount_, std::move(offsets), std::move(neighbors), std::move(weights));
+}
+
+bool CSRGraph::hasEdge(int u, int v) const {
+    return std::binary_search(neighborsBegin(u), neighborsEnd(u), v);
+}
+
+bool CSRGraph::isSymmetric() const {
+    for (int u = 0; u < vertexCount_; ++u) {
+        for (const int* it = neighborsBegin(u); it != neighborsEnd(u); ++it) {
+            const int* back = std::lower_bound(neighborsBegin(*it), neighborsEnd(*it), u);
+            if (back == neighborsEnd(*it) || *back != u) {
+                return false;
+            }
+            if (weights_ != nullptr && weights_[back - neighbors_] != weights_[it - neighbors_]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::uint64_t CSRGraph::checksum() const {
+    std::uint64_t hash = checksum(offsets_, sizeof(std::int64_t) * (static_cast<size_t>(vertexCount_) + 1),
+                                  static_cast<std::uint64_t>(vertexCount_));
+    hash = checksum(neighbors_, sizeof(int) * static_cast<size_t>(arcCount_), hash);
+    if (weights_ != nullptr) {
+        hash = checksum(weights_, sizeof(std::uint32_t) * static_cast<size_t>(arcCount_), hash);
+    }
+    return hash;
+}
+
+std::uint64_t CSRGraph::checksum(const void* data, std::size_t size, std::uint64_t seed) {
+    // Пословное перемешивание в духе FNV-1a: 8 байт за шаг вместо одного
+    const std::uint64_t prime = 0x100000001b3ULL;
+    std::uint64_t hash = 0xcbf29ce484222325ULL ^ seed;
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    
+    std::size_t i = 0;
+    for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 29;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * prime;
+    }
+    return hash;
+}
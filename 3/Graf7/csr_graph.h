@@ -0,0 +1,236 @@
+/**
+ * @file csr_graph.h
+ * @brief Компактное представление графа в формате CSR
+ * @version 1.2
+ *
+ * Граф хранится как массив смещений и общий массив соседей
+ * (compressed sparse row): память линейна по числу ребер.
+ * У взвешенного графа рядом с массивом соседей лежит массив весов дуг.
+ * Массивы неизменяемы и разделяются между копиями графа, поэтому
+ * они могут лежать как в векторах, так и в отображенном файле.
+ */
+
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct WeightedEdge
+ * @brief Ребро с весом (временем в пути)
+ */
+struct WeightedEdge {
+    int u;                 ///< Первая вершина (0-based)
+    int v;                 ///< Вторая вершина (0-based)
+    std::uint32_t weight;  ///< Вес ребра
+};
+
+/**
+ * @class CSRGraph
+ * @brief Граф в формате сжатых строк (CSR)
+ *
+ * Соседи вершины v лежат в neighbors[offsets[v] .. offsets[v+1])
+ * и отсортированы по возрастанию, дубликаты удалены.
+ * Все номера вершин 0-based. У взвешенного графа вес дуги
+ * neighbors[i] - weights[i]; у невзвешенного все веса считаются равными 1.
+ *
+ * Копирование графа - O(1): копии разделяют одни и те же
+ * неизменяемые массивы, владелец памяти хранится в storage_.
+ */
+class CSRGraph {
+private:
+    int vertexCount_;
+    std::int64_t arcCount_;
+    const std::int64_t* offsets_;
+    const int* neighbors_;
+    const std::uint32_t* weights_;  ///< Веса дуг (nullptr - граф невзвешенный)
+    std::shared_ptr<const void> storage_;
+
+public:
+    /**
+     * @brief Конструктор пустого графа
+     */
+    CSRGraph();
+
+    /**
+     * @brief Конструктор из готовых массивов CSR
+     * @param vertexCount Количество вершин
+     * @param offsets Массив смещений (vertexCount + 1 элементов)
+     * @param neighbors Массив соседей
+     * @throws std::runtime_error если массивы не согласованы
+     */
+    CSRGraph(int vertexCount, std::vector<std::int64_t> offsets, std::vector<int> neighbors);
+
+    /**
+     * @brief Конструктор взвешенного графа из готовых массивов CSR
+     * @param vertexCount Количество вершин
+     * @param offsets Массив смещений (vertexCount + 1 элементов)
+     * @param neighbors Массив соседей
+     * @param weights Веса дуг (той же длины, что neighbors)
+     * @throws std::runtime_error если массивы не согласованы
+     */
+    CSRGraph(int vertexCount, std::vector<std::int64_t> offsets, std::vector<int> neighbors,
+             std::vector<std::uint32_t> weights);
+
+    /**
+     * @brief Граф поверх внешней памяти без копирования
+     * @param vertexCount Количество вершин
+     * @param arcCount Количество элементов в массиве соседей
+     * @param offsets Массив смещений (vertexCount + 1 элементов)
+     * @param neighbors Массив соседей
+     * @param owner Владелец памяти, удерживается пока жив граф
+     * @param weights Веса дуг (nullptr - граф невзвешенный)
+     * @return CSRGraph Граф, ссылающийся на переданные массивы
+     */
+    static CSRGraph fromExternal(int vertexCount, std::int64_t arcCount,
+                                 const std::int64_t* offsets, const int* neighbors,
+                                 std::shared_ptr<const void> owner,
+                                 const std::uint32_t* weights = nullptr);
+
+    /**
+     * @brief Построение графа из списка ребер
+     * @param vertexCount Количество вершин
+     * @param edges Пары (u, v), 0-based
+     * @param symmetric true - каждое ребро добавляется в обе стороны
+     * @return CSRGraph Граф с отсортированными списками соседей
+     * @throws std::runtime_error при выходе номера вершины за границы
+     */
+    static CSRGraph fromEdges(int vertexCount, const std::vector<std::pair<int, int>>& edges,
+                              bool symmetric = true);
+
+    /**
+     * @brief Построение взвешенного графа из списка ребер
+     *
+     * Из кратных ребер остается ребро наименьшего веса
+     * @param vertexCount Количество вершин
+     * @param edges Ребра с весами, 0-based
+     * @param symmetric true - каждое ребро добавляется в обе стороны
+     * @return CSRGraph Граф с отсортированными списками соседей и весами
+     * @throws std::runtime_error при выходе номера вершины за границы
+     */
+    static CSRGraph fromWeightedEdges(int vertexCount, const std::vector<WeightedEdge>& edges,
+                                      bool symmetric = true);
+
+    /**
+     * @brief Транспонированный граф (все дуги развернуты)
+     *
+     * Подсчетом за O(V + E); списки соседей остаются отсортированными,
+     * веса переносятся вместе с дугами
+     * @return CSRGraph Граф входящих дуг
+     */
+    CSRGraph transposed() const;
+
+    /**
+     * @brief Количество вершин
+     * @return int Количество вершин
+     */
+    int vertexCount() const { return vertexCount_; }
+
+    /**
+     * @brief Количество элементов в массиве соседей
+     * @return std::int64_t Количество ориентированных дуг
+     */
+    std::int64_t arcCount() const { return arcCount_; }
+
+    /**
+     * @brief Степень вершины
+     * @param v Вершина (0-based)
+     * @return int Количество соседей
+     */
+    int degree(int v) const {
+        return static_cast<int>(offsets_[v + 1] - offsets_[v]);
+    }
+
+    /**
+     * @brief Начало списка соседей вершины
+     * @param v Вершина (0-based)
+     * @return const int* Указатель на первого соседа
+     */
+    const int* neighborsBegin(int v) const { return neighbors_ + offsets_[v]; }
+
+    /**
+     * @brief Конец списка соседей вершины
+     * @param v Вершина (0-based)
+     * @return const int* Указатель за последним соседом
+     */
+    const int* neighborsEnd(int v) const { return neighbors_ + offsets_[v + 1]; }
+
+    /**
+     * @brief Массив смещений целиком
+     * @return const std::int64_t* Указатель на vertexCount + 1 смещений
+     */
+    const std::int64_t* offsetsData() const { return offsets_; }
+
+    /**
+     * @brief Массив соседей целиком
+     * @return const int* Указатель на arcCount элементов
+     */
+    const int* neighborsData() const { return neighbors_; }
+
+    /**
+     * @brief Есть ли у графа веса дуг
+     * @return true если граф взвешенный
+     */
+    bool isWeighted() const { return weights_ != nullptr; }
+
+    /**
+     * @brief Начало весов дуг вершины (только для взвешенного графа)
+     * @param v Вершина (0-based)
+     * @return const std::uint32_t* Вес дуги к первому соседу
+     */
+    const std::uint32_t* weightsBegin(int v) const { return weights_ + offsets_[v]; }
+
+    /**
+     * @brief Массив весов целиком
+     * @return const std::uint32_t* Указатель на arcCount весов или nullptr
+     */
+    const std::uint32_t* weightsData() const { return weights_; }
+
+    /**
+     * @brief Проверка наличия ребра (бинарный поиск)
+     * @param u Начальная вершина (0-based)
+     * @param v Конечная вершина (0-based)
+     * @return true если ребро u -> v существует
+     */
+    bool hasEdge(int u, int v) const;
+
+    /**
+     * @brief Проверка симметричности (неориентированный граф)
+     * @return true если для каждого ребра u -> v есть ребро v -> u
+     *         (у взвешенного графа - того же веса)
+     */
+    bool isSymmetric() const;
+
+    /**
+     * @brief Контрольная сумма массивов смещений, соседей и весов
+     * @return std::uint64_t 64-битная контрольная сумма
+     */
+    std::uint64_t checksum() const;
+
+    /**
+     * @brief Контрольная сумма произвольного буфера
+     * @param data Начало буфера
+     * @param size Размер в байтах
+     * @param seed Начальное значение (для продолжения подсчета)
+     * @return std::uint64_t 64-битная контрольная сумма
+     */
+    static std::uint64_t checksum(const void* data, std::size_t size, std::uint64_t seed);
+};
+
+/**
+ * @struct DirectedGraph
+ * @brief Ориентированный граф: исходящие и входящие дуги
+ *
+ * Обратный граф строится один раз при загрузке, поэтому обходы
+ * против направления дуг стоят столько же, сколько обычные.
+ */
+struct DirectedGraph {
+    CSRGraph forward;  ///< Исходящие дуги
+    CSRGraph reverse;  ///< Входящие дуги (forward.transposed())
+};
+
+#endif // CSR_GRAPH_H
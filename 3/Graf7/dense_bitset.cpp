@@ -0,0 +1,76 @@
+/**
+ * @file dense_bitset.cpp
+ * @brief Реализация плотного битового множества
+ * @version 1.1
+ */
+
+#include "dense_bitset.h"
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+void DenseBitset::clear() {
+    std::fill(words_.begin(), words_.end(), 0);
+}
+
+std::size_t DenseBitset::count() const {
+    std::size_t total = 0;
+    for (std::uint64_t word : words_) {
+        total += static_cast<std::size_t>(__builtin_popcountll(word));
+    }
+    return total;
+}
+
+bool DenseBitset::empty() const {
+    for (std::uint64_t word : words_) {
+        if (word != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<int> DenseBitset::toVector() const {
+    std::vector<int> elements;
+    elements.reserve(count());
+    forEach([&elements](int i) { elements.push_back(i); });
+    return elements;
+}
+
+std::size_t DenseBitset::intersect(const DenseBitset& a, const DenseBitset& b, DenseBitset& out) {
+    if (a.size_ != b.size_) {
+        throw std::runtime_error("Пересечение битовых множеств разного размера");
+    }
+    if (out.size_ != a.size_) {
+        out = DenseBitset(a.size_);
+    }
+
+    return intersectWords(a.words_.data(), b.words_.data(), out.words_.data(), a.words_.size());
+}
+
+std::size_t DenseBitset::intersectWords(const std::uint64_t* x, const std::uint64_t* y,
+                                        std::uint64_t* z, std::size_t words) {
+    std::size_t total = 0;
+    std::size_t i = 0;
+
+#ifdef __AVX2__
+    // AND по 256 бит; popcount - аппаратной инструкцией по словам
+    for (; i + 4 <= words; i += 4) {
+        __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+        __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(z + i), _mm256_and_si256(left, right));
+        total += static_cast<std::size_t>(__builtin_popcountll(z[i]) + __builtin_popcountll(z[i + 1]) +
+                                          __builtin_popcountll(z[i + 2]) + __builtin_popcountll(z[i + 3]));
+    }
+#endif
+
+    for (; i < words; ++i) {
+        z[i] = x[i] & y[i];
+        total += static_cast<std::size_t>(__builtin_popcountll(z[i]));
+    }
+
+    return total;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file dense_bitset.h
+ * @brief Плотное битовое множество вершин
+ * @version 1.1
+ *
+ * Множество номеров 0..size-1, один бит на элемент. Заменяет
+ * std::set<int> для множеств достижимых вершин: без выделения
+ * памяти на элемент, пересечение - словарное AND с popcount
+ */
+
+#ifndef DENSE_BITSET_H
+#define DENSE_BITSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class DenseBitset
+ * @brief Битовое множество фиксированного размера
+ */
+class DenseBitset {
+private:
+    std::size_t size_;
+    std::vector<std::uint64_t> words_;
+
+public:
+    /**
+     * @brief Конструктор пустого множества
+     * @param size Количество возможных элементов
+     */
+    explicit DenseBitset(std::size_t size = 0)
+        : size_(size), words_((size + 63) / 64, 0) {}
+
+    /**
+     * @brief Размер универсума
+     * @return std::size_t Количество возможных элементов
+     */
+    std::size_t size() const { return size_; }
+
+    /**
+     * @brief Количество 64-битных слов
+     * @return std::size_t Длина массива слов
+     */
+    std::size_t wordCount() const { return words_.size(); }
+
+    /**
+     * @brief Массив слов
+     * @return const std::uint64_t* Указатель на первое слово
+     */
+    const std::uint64_t* words() const { return words_.data(); }
+
+    /**
+     * @brief Массив слов для изменения
+     * @return std::uint64_t* Указатель на первое слово
+     */
+    std::uint64_t* words() { return words_.data(); }
+
+    /**
+     * @brief Проверка принадлежности
+     * @param i Элемент
+     * @return true если элемент в множестве
+     */
+    bool test(std::size_t i) const { return (words_[i >> 6] >> (i & 63)) & 1; }
+
+    /**
+     * @brief Добавление элемента
+     * @param i Элемент
+     */
+    void set(std::size_t i) { words_[i >> 6] |= std::uint64_t(1) << (i & 63); }
+
+    /**
+     * @brief Удаление элемента
+     * @param i Элемент
+     */
+    void reset(std::size_t i) { words_[i >> 6] &= ~(std::uint64_t(1) << (i & 63)); }
+
+    /**
+     * @brief Очистка множества
+     */
+    void clear();
+
+    /**
+     * @brief Мощность множества
+     * @return std::size_t Количество элементов (popcount)
+     */
+    std::size_t count() const;
+
+    /**
+     * @brief Пустое ли множество
+     * @return true если элементов нет
+     */
+    bool empty() const;
+
+    /**
+     * @brief Обход элементов по возрастанию
+     * @param visit Функция, вызываемая для каждого элемента
+     */
+    template <typename Visitor>
+    void forEach(Visitor visit) const {
+        for (std::size_t w = 0; w < words_.size(); ++w) {
+            std::uint64_t bits = words_[w];
+            while (bits != 0) {
+                visit(static_cast<int>(w * 64 + __builtin_ctzll(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    /**
+     * @brief Элементы множества в отсортированном векторе
+     * @return std::vector<int> Элементы по возрастанию
+     */
+    std::vector<int> toVector() const;
+
+    /**
+     * @brief Пересечение двух множеств одного размера
+     * @param a Первое множество
+     * @param b Второе множество
+     * @param[out] out Результат a AND b (может совпадать с a или b)
+     * @return std::size_t Мощность пересечения
+     */
+    static std::size_t intersect(const DenseBitset& a, const DenseBitset& b, DenseBitset& out);
+
+    /**
+     * @brief Пересечение массивов слов
+     * @param x Первый массив
+     * @param y Второй массив
+     * @param[out] z Результат x AND y (может совпадать с x или y)
+     * @param words Длина массивов в словах
+     * @return std::size_t Количество установленных битов результата
+     */
+    static std::size_t intersectWords(const std::uint64_t* x, const std::uint64_t* y,
+                                      std::uint64_t* z, std::size_t words);
+};
+
+#endif // DENSE_BITSET_H
@@ -0,0 +1,72 @@
+/**
+ * @file diagnostics.cpp
+ * @brief Реализация диагностики запросов
+ * @version 1.0
+ */
+
+#include "diagnostics.h"
+#include <iomanip>
+#include <sstream>
+
+DiagnosticsSink::DiagnosticsSink(std::ostream& out, std::size_t flushThreshold)
+    : out_(&out), flushThreshold_(flushThreshold) {
+    buffer_.reserve(flushThreshold_);
+}
+
+DiagnosticsSink::~DiagnosticsSink() {
+    flush();
+}
+
+void DiagnosticsSink::writeLine(const std::string& line) {
+    buffer_ += line;
+    buffer_ += '\n';
+    if (buffer_.size() >= flushThreshold_) {
+        flush();
+    }
+}
+
+void DiagnosticsSink::flush() {
+    if (!buffer_.empty()) {
+        out_->write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        out_->flush();
+        buffer_.clear();
+    }
+}
+
+void DiagnosticsSink::redirect(std::ostream& out) {
+    flush();
+    out_ = &out;
+}
+
+Diagnostics::Diagnostics(Verbosity verbosity, std::ostream& out)
+    : verbosity_(verbosity), sink_(out) {}
+
+void Diagnostics::reportQuery(const QueryStats& stats) {
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(3);
+    line << "[ЗАПРОС] K1=" << stats.k1 << " K2=" << stats.k2 << " L=" << stats.L
+         << " общих=" << stats.resultSize
+         << " ребер=" << (stats.fromK1.edgesScanned + stats.fromK2.edgesScanned)
+         << " bfs=" << (stats.fromK1.seconds + stats.fromK2.seconds) * 1000.0 << "мс"
+         << " пересечение=" << stats.intersectSeconds * 1000.0 << "мс";
+    sink_.writeLine(line.str());
+
+    if (!enabled(Verbosity::Trace)) {
+        return;
+    }
+
+    const TraversalStats* traversals[2] = {&stats.fromK1, &stats.fromK2};
+    const char* names[2] = {"K1", "K2"};
+    for (int i = 0; i < 2; ++i) {
+        std::ostringstream trace;
+        trace << std::fixed << std::setprecision(3);
+        trace << "  [BFS " << names[i] << "] фронт по уровням:";
+        for (int size : traversals[i]->frontierSizes) {
+            trace << ' ' << size;
+        }
+        trace << " | ребер=" << traversals[i]->edgesScanned
+              << " | снизу вверх=" << traversals[i]->bottomUpLevels
+              << " | " << traversals[i]->seconds * 1000.0 << "мс";
+        sink_.writeLine(trace.str());
+    }
+}
@@ -0,0 +1,197 @@
+/**
+ * @file diagnostics.h
+ * @brief Диагностика запросов анализатора
+ * @version 1.0
+ *
+ * Уровень подробности задается во время работы, а сборка с
+ * -DGRAF7_DIAGNOSTICS=0 полностью исключает трассировку из кода.
+ * Сообщения накапливаются в буфере и сбрасываются крупными блоками.
+ */
+
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifndef GRAF7_DIAGNOSTICS
+#define GRAF7_DIAGNOSTICS 1
+#endif
+
+/**
+ * @brief Выполнение кода диагностики, если уровень включен
+ *
+ * При GRAF7_DIAGNOSTICS == 0 выражение только проверяется на
+ * синтаксис под if (false) и в машинный код не попадает
+ */
+#if GRAF7_DIAGNOSTICS
+#define GRAF7_DIAG(diagnostics, level, statement) \
+    do { if ((diagnostics).enabled(level)) { statement; } } while (0)
+#else
+#define GRAF7_DIAG(diagnostics, level, statement) \
+    do { if (false) { statement; } } while (0)
+#endif
+
+/**
+ * @enum Verbosity
+ * @brief Уровень подробности диагностики
+ */
+enum class Verbosity {
+    Silent = 0,   ///< Ничего не выводить
+    Summary = 1,  ///< Одна строка на запрос
+    Trace = 2     ///< Подробная статистика по уровням BFS
+};
+
+/**
+ * @struct TraversalStats
+ * @brief Статистика одного обхода
+ */
+struct TraversalStats {
+    std::vector<int> frontierSizes;  ///< Размер фронта на каждом уровне (уровень 0 - старт)
+    std::int64_t edgesScanned = 0;   ///< Просмотрено ребер (для битовой матрицы - бит строк)
+    int bottomUpLevels = 0;          ///< Уровни, пройденные снизу вверх
+    double seconds = 0.0;            ///< Время обхода
+};
+
+/**
+ * @struct QueryStats
+ * @brief Статистика одного запроса findCommonCities
+ */
+struct QueryStats {
+    int k1 = 0;                       ///< Первая штаб-квартира (1-based)
+    int k2 = 0;                       ///< Вторая штаб-квартира (1-based)
+    int L = 0;                        ///< Количество промежуточных городов
+    TraversalStats fromK1;            ///< Обход из K1
+    TraversalStats fromK2;            ///< Обход из K2
+    double intersectSeconds = 0.0;    ///< Время пересечения
+    std::size_t resultSize = 0;       ///< Количество общих городов
+};
+
+/**
+ * @class DiagnosticsSink
+ * @brief Буферизованный приемник диагностических сообщений
+ */
+class DiagnosticsSink {
+private:
+    std::ostream* out_;
+    std::string buffer_;
+    std::size_t flushThreshold_;
+
+public:
+    /**
+     * @brief Конструктор
+     * @param out Поток назначения
+     * @param flushThreshold Размер буфера, после которого он сбрасывается
+     */
+    explicit DiagnosticsSink(std::ostream& out, std::size_t flushThreshold = 64 * 1024);
+
+    DiagnosticsSink(const DiagnosticsSink&) = delete;
+    DiagnosticsSink& operator=(const DiagnosticsSink&) = delete;
+
+    /**
+     * @brief Деструктор - сбрасывает остаток буфера
+     */
+    ~DiagnosticsSink();
+
+    /**
+     * @brief Добавление строки в буфер
+     * @param line Строка без завершающего перевода строки
+     */
+    void writeLine(const std::string& line);
+
+    /**
+     * @brief Сброс буфера в поток
+     */
+    void flush();
+
+    /**
+     * @brief Смена потока назначения (буфер предварительно сбрасывается)
+     * @param out Новый поток
+     */
+    void redirect(std::ostream& out);
+};
+
+/**
+ * @class Diagnostics
+ * @brief Уровень подробности и приемник сообщений
+ */
+class Diagnostics {
+private:
+    Verbosity verbosity_;
+    DiagnosticsSink sink_;
+
+public:
+    /**
+     * @brief Конструктор
+     * @param verbosity Начальный уровень
+     * @param out Поток назначения
+     */
+    Diagnostics(Verbosity verbosity, std::ostream& out);
+
+    /**
+     * @brief Включен ли уровень
+     * @param level Проверяемый уровень
+     * @return true если сообщения этого уровня нужно формировать
+     */
+    bool enabled(Verbosity level) const {
+        return GRAF7_DIAGNOSTICS && level != Verbosity::Silent &&
+               static_cast<int>(verbosity_) >= static_cast<int>(level);
+    }
+
+    /**
+     * @brief Установка уровня подробности
+     * @param verbosity Новый уровень
+     */
+    void setVerbosity(Verbosity verbosity) { verbosity_ = verbosity; }
+
+    /**
+     * @brief Текущий уровень подробности
+     * @return Verbosity Уровень
+     */
+    Verbosity verbosity() const { return verbosity_; }
+
+    /**
+     * @brief Приемник сообщений
+     * @return DiagnosticsSink& Буферизованный приемник
+     */
+    DiagnosticsSink& sink() { return sink_; }
+
+    /**
+     * @brief Отчет о запросе (формат зависит от уровня)
+     * @param stats Статистика запроса
+     */
+    void reportQuery(const QueryStats& stats);
+};
+
+/**
+ * @class PhaseTimer
+ * @brief Замер длительности фазы запроса
+ *
+ * Часы опрашиваются только если диагностика включена
+ */
+class PhaseTimer {
+private:
+    std::chrono::steady_clock::time_point start_;
+
+public:
+    /**
+     * @brief Запуск замера
+     * @param active false - часы не опрашиваются (seconds() тогда не имеет смысла)
+     */
+    explicit PhaseTimer(bool active)
+        : start_(GRAF7_DIAGNOSTICS && active ? std::chrono::steady_clock::now()
+                                             : std::chrono::steady_clock::time_point()) {}
+
+    /**
+     * @brief Время с момента запуска
+     * @return double Длительность в секундах
+     */
+    double seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    }
+};
+
+#endif // DIAGNOSTICS_H
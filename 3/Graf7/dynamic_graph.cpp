@@ -0,0 +1,86 @@
+/**
+ * @file dynamic_graph.cpp
+ * @brief Реализация изменяемого графа
+ * @version 1.0
+ */
+
+#include "dynamic_graph.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+DynamicGraph::DynamicGraph(int vertexCount)
+    : adjacency_(static_cast<std::size_t>(vertexCount)), arcCount_(0) {}
+
+DynamicGraph DynamicGraph::fromCSR(const CSRGraph& graph) {
+    DynamicGraph dynamic(graph.vertexCount());
+    for (int v = 0; v < graph.vertexCount(); ++v) {
+        dynamic.adjacency_[v].assign(graph.neighborsBegin(v), graph.neighborsEnd(v));
+    }
+    dynamic.arcCount_ = graph.arcCount();
+    return dynamic;
+}
+
+bool DynamicGraph::hasEdge(int u, int v) const {
+    const std::vector<int>& list = adjacency_[u];
+    return std::binary_search(list.begin(), list.end(), v);
+}
+
+bool DynamicGraph::addEdge(int u, int v) {
+    checkVertex(u);
+    checkVertex(v);
+
+    std::vector<int>& listU = adjacency_[u];
+    std::vector<int>::iterator position = std::lower_bound(listU.begin(), listU.end(), v);
+    if (position != listU.end() && *position == v) {
+        return false;
+    }
+    listU.insert(position, v);
+    ++arcCount_;
+
+    if (u != v) {
+        std::vector<int>& listV = adjacency_[v];
+        listV.insert(std::lower_bound(listV.begin(), listV.end(), u), u);
+        ++arcCount_;
+    }
+    return true;
+}
+
+bool DynamicGraph::removeEdge(int u, int v) {
+    checkVertex(u);
+    checkVertex(v);
+
+    std::vector<int>& listU = adjacency_[u];
+    std::vector<int>::iterator position = std::lower_bound(listU.begin(), listU.end(), v);
+    if (position == listU.end() || *position != v) {
+        return false;
+    }
+    listU.erase(position);
+    --arcCount_;
+
+    if (u != v) {
+        std::vector<int>& listV = adjacency_[v];
+        listV.erase(std::lower_bound(listV.begin(), listV.end(), u));
+        --arcCount_;
+    }
+    return true;
+}
+
+CSRGraph DynamicGraph::toCSR() const {
+    int n = vertexCount();
+    std::vector<std::int64_t> offsets(static_cast<std::size_t>(n) + 1, 0);
+    std::vector<int> neighbors;
+    neighbors.reserve(static_cast<std::size_t>(arcCount_));
+    for (int v = 0; v < n; ++v) {
+        neighbors.insert(neighbors.end(), adjacency_[v].begin(), adjacency_[v].end());
+        offsets[v + 1] = static_cast<std::int64_t>(neighbors.size());
+    }
+    return CSRGraph(n, std::move(offsets), std::move(neighbors));
+}
+
+void DynamicGraph::checkVertex(int v) const {
+    if (v < 0 || v >= vertexCount()) {
+        throw std::runtime_error("Номер вершины вне диапазона: " + std::to_string(v));
+    }
+}
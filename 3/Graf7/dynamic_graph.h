@@ -0,0 +1,103 @@
+/**
+ * @file dynamic_graph.h
+ * @brief Изменяемый неориентированный граф
+ * @version 1.0
+ *
+ * Списки соседей хранятся отдельными отсортированными векторами,
+ * поэтому ребро добавляется и удаляется без перестройки всего графа.
+ * Для запросов анализатора граф фиксируется в CSR (toCSR).
+ */
+
+#ifndef DYNAMIC_GRAPH_H
+#define DYNAMIC_GRAPH_H
+
+#include "csr_graph.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class DynamicGraph
+ * @brief Неориентированный граф со списками смежности
+ *
+ * Вершины нумеруются с 0. Петля (u, u) хранится в списке u один раз.
+ */
+class DynamicGraph {
+private:
+    std::vector<std::vector<int>> adjacency_;  ///< Соседи каждой вершины по возрастанию
+    std::int64_t arcCount_;                    ///< Суммарная длина списков
+
+public:
+    /**
+     * @brief Конструктор графа без ребер
+     * @param vertexCount Количество вершин
+     */
+    explicit DynamicGraph(int vertexCount = 0);
+
+    /**
+     * @brief Копия графа CSR
+     * @param graph Симметричный граф
+     * @return DynamicGraph Изменяемый граф с теми же ребрами
+     */
+    static DynamicGraph fromCSR(const CSRGraph& graph);
+
+    /**
+     * @brief Количество вершин
+     * @return int Количество вершин
+     */
+    int vertexCount() const { return static_cast<int>(adjacency_.size()); }
+
+    /**
+     * @brief Количество дуг (каждое ребро - две дуги, петля - одна)
+     * @return std::int64_t Суммарная длина списков соседей
+     */
+    std::int64_t arcCount() const { return arcCount_; }
+
+    /**
+     * @brief Соседи вершины
+     * @param v Вершина
+     * @return const std::vector<int>& Соседи по возрастанию
+     */
+    const std::vector<int>& neighbors(int v) const { return adjacency_[v]; }
+
+    /**
+     * @brief Проверка наличия ребра (двоичный поиск)
+     * @param u Первая вершина
+     * @param v Вторая вершина
+     * @return true если ребро есть
+     */
+    bool hasEdge(int u, int v) const;
+
+    /**
+     * @brief Добавление ребра
+     * @param u Первая вершина
+     * @param v Вторая вершина
+     * @return false если ребро уже было
+     * @throws std::runtime_error при номере вершины вне диапазона
+     */
+    bool addEdge(int u, int v);
+
+    /**
+     * @brief Удаление ребра
+     * @param u Первая вершина
+     * @param v Вторая вершина
+     * @return false если ребра не было
+     * @throws std::runtime_error при номере вершины вне диапазона
+     */
+    bool removeEdge(int u, int v);
+
+    /**
+     * @brief Фиксация текущего состояния в CSR
+     * @return CSRGraph Неизменяемая копия графа
+     */
+    CSRGraph toCSR() const;
+
+private:
+    /**
+     * @brief Проверка номера вершины
+     * @param v Вершина
+     * @throws std::runtime_error если номер вне диапазона
+     */
+    void checkVertex(int v) const;
+};
+
+#endif // DYNAMIC_GRAPH_H
@@ -0,0 +1,188 @@
+/**
+ * @file external_analyzer.cpp
+ * @brief Реализация внешнего BFS и поиска общих городов
+ * @version 1.0
+ */
+
+#include "external_analyzer.h"
+#include "graph_utils.h"
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+/**
+ * @class SortedCursor
+ * @brief Проверка принадлежности по возрастающим запросам
+ *
+ * Файл отсортированных вершин читается один раз вместе с
+ * возрастающей последовательностью запросов (слияние)
+ */
+class SortedCursor {
+private:
+    RecordReader<int> reader_;
+    int current_;
+    bool valid_;
+
+public:
+    SortedCursor(const DiskFile& file, std::uint64_t count, std::size_t bufferBytes, IOCounters* counters)
+        : reader_(file, 0, count, bufferBytes, counters), current_(0), valid_(reader_.next(current_)) {}
+
+    /**
+     * @brief Есть ли вершина в файле
+     * @param vertex Вершина (не меньше предыдущего запроса)
+     * @return true если вершина найдена
+     */
+    bool contains(int vertex) {
+        while (valid_ && current_ < vertex) {
+            valid_ = reader_.next(current_);
+        }
+        return valid_ && current_ == vertex;
+    }
+};
+
+} // namespace
+
+IOCounters ExternalQueryStats::total() const {
+    IOCounters sum = intersect;
+    const ExternalSearchStats* searches[] = {&fromK1, &fromK2};
+    for (const ExternalSearchStats* search : searches) {
+        for (const ExternalLevelStats& level : search->levels) {
+            sum += level.io;
+        }
+        sum += search->collect;
+    }
+    return sum;
+}
+
+ExternalAnalyzer::ExternalAnalyzer(const std::string& snapshotFile, std::size_t memoryBudget,
+                                   const std::string& tempDirectory)
+    : file_(snapshotFile), layout_(GraphReader::readSnapshotLayout(snapshotFile)),
+      memoryBudget_(memoryBudget), tempDirectory_(tempDirectory) {
+    if (layout_.directed) {
+        throw std::runtime_error("Внешний BFS поддерживает только неориентированный граф: " + snapshotFile);
+    }
+    if (memoryBudget_ < kMinMemoryBudget) {
+        throw std::runtime_error("Бюджет памяти меньше " + std::to_string(kMinMemoryBudget >> 20) + " МБ");
+    }
+}
+
+std::vector<int> ExternalAnalyzer::findCommonCities(int k1, int k2, int L, ExternalQueryStats* stats) const {
+    if (!GraphUtils::isValidCity(k1, cityCount())) {
+        throw std::runtime_error("Некорректный номер города K1: " + std::to_string(k1));
+    }
+    if (!GraphUtils::isValidCity(k2, cityCount())) {
+        throw std::runtime_error("Некорректный номер города K2: " + std::to_string(k2));
+    }
+    if (!GraphUtils::isValidL(L)) {
+        throw std::runtime_error("Некорректное значение L: " + std::to_string(L));
+    }
+    if (k1 == k2) {
+        throw std::runtime_error("K1 и K2 не могут быть одинаковыми");
+    }
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    ExternalQueryStats local;
+    ExternalQueryStats& query = stats != nullptr ? *stats : local;
+    query = ExternalQueryStats();
+
+    int start1 = k1 - 1;
+    int start2 = k2 - 1;
+    std::int64_t maxDistance = static_cast<std::int64_t>(L) + 1;
+    std::vector<int> commonCities;
+
+    // Из K1 достижима только она сама - общих городов нет, второй обход не нужен
+    VertexRun fromK1 = reachableVertices(start1, maxDistance, query.fromK1);
+    if (fromK1.count > 1) {
+        VertexRun fromK2 = reachableVertices(start2, maxDistance, query.fromK2);
+        SortedCursor first(fromK1.file, fromK1.count, streamBytes(), &query.intersect);
+        RecordReader<int> second(fromK2.file, 0, fromK2.count, streamBytes(), &query.intersect);
+        int vertex;
+        while (second.next(vertex)) {
+            if (first.contains(vertex) && vertex != start1 && vertex != start2) {
+                commonCities.push_back(vertex + 1);
+            }
+        }
+    }
+
+    query.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    if (commonCities.empty()) {
+        return {-1};
+    }
+    return commonCities;
+}
+
+ExternalAnalyzer::VertexRun ExternalAnalyzer::reachableVertices(int start, std::int64_t maxDistance,
+                                                                ExternalSearchStats& stats) const {
+    // Уровни не пересекаются и отсортированы: каждый, который больше не
+    // нужен обходу, сразу отдается слиянию готовой серией
+    ExternalSorter<int> merger(memoryBudget_ / 2, tempDirectory_, false, &stats.collect);
+    VertexRun previous = {DiskFile::temporary(tempDirectory_), 0};
+    VertexRun current = {DiskFile::temporary(tempDirectory_), 1};
+    current.file.writeAt(&start, sizeof(start), 0);
+    ExternalLevelStats originStats;
+    originStats.frontierSize = 1;
+    stats.levels.push_back(originStats);
+
+    for (std::int64_t distance = 1; distance <= maxDistance; ++distance) {
+        ExternalLevelStats levelStats;
+        VertexRun next = nextLevel(current, previous, levelStats.io);
+        levelStats.frontierSize = static_cast<std::int64_t>(next.count);
+        stats.levels.push_back(levelStats);
+        if (next.count == 0) {
+            break;
+        }
+        merger.addSortedRun(std::move(previous.file), previous.count);
+        previous = std::move(current);
+        current = std::move(next);
+    }
+    merger.addSortedRun(std::move(previous.file), previous.count);
+    merger.addSortedRun(std::move(current.file), current.count);
+
+    VertexRun reached = {DiskFile::temporary(tempDirectory_), 0};
+    RecordWriter<int> writer(reached.file, 0, streamBytes(), &stats.collect);
+    merger.finish([&writer](int vertex) { writer.push(vertex); });
+    writer.flush();
+    reached.count = writer.count();
+    return reached;
+}
+
+ExternalAnalyzer::VertexRun ExternalAnalyzer::nextLevel(const VertexRun& current, const VertexRun& previous,
+                                                        IOCounters& counters) const {
+    // Половина бюджета - сортировке соседей, по 1/16 - потокам
+    ExternalSorter<int> neighbors(memoryBudget_ / 2, tempDirectory_, true, &counters);
+    {
+        RecordReader<int> frontier(current.file, 0, current.count, streamBytes(), &counters);
+        RecordReader<std::int64_t> offsets(file_, layout_.offsetsPos,
+                                           static_cast<std::uint64_t>(layout_.vertexCount) + 1,
+                                           streamBytes(), &counters);
+        RecordReader<int> arcs(file_, layout_.neighborsPos, static_cast<std::uint64_t>(layout_.arcCount),
+                               streamBytes(), &counters);
+        int vertex;
+        while (frontier.next(vertex)) {
+            std::int64_t first = offsets.at(static_cast<std::uint64_t>(vertex));
+            std::int64_t last = offsets.at(static_cast<std::uint64_t>(vertex) + 1);
+            for (std::int64_t i = first; i < last; ++i) {
+                neighbors.push(arcs.at(static_cast<std::uint64_t>(i)));
+            }
+        }
+    }
+
+    VertexRun next = {DiskFile::temporary(tempDirectory_), 0};
+    RecordWriter<int> writer(next.file, 0, streamBytes(), &counters);
+    SortedCursor inCurrent(current.file, current.count, streamBytes(), &counters);
+    SortedCursor inPrevious(previous.file, previous.count, streamBytes(), &counters);
+    neighbors.finish([&](int vertex) {
+        if (!inCurrent.contains(vertex) && !inPrevious.contains(vertex)) {
+            writer.push(vertex);
+        }
+    });
+    writer.flush();
+    next.count = writer.count();
+    return next;
+}
+
+std::size_t ExternalAnalyzer::streamBytes() const {
+    return std::max<std::size_t>(ExternalSorter<int>::kMinStreamBytes, memoryBudget_ / 16);
+}
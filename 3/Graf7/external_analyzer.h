@@ -0,0 +1,165 @@
+/**
+ * @file external_analyzer.h
+ * @brief Поиск общих городов без загрузки графа в память
+ * @version 1.0
+ *
+ * Для графов, которые не помещаются в память даже сжатыми. Граф
+ * читается из двоичного снимка (отсортированные списки соседей)
+ * позиционными чтениями, уровни BFS лежат во временных файлах, а
+ * память ограничена заданным бюджетом. Обход - алгоритм
+ * Мунагалы-Ранаде: следующий уровень неориентированного графа -
+ * соседи текущего уровня без текущего и предыдущего, поэтому
+ * множество посещенных вершин хранить не нужно.
+ */
+
+#ifndef EXTERNAL_ANALYZER_H
+#define EXTERNAL_ANALYZER_H
+
+#include "external_io.h"
+#include "graph_reader.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct ExternalLevelStats
+ * @brief Статистика построения одного уровня внешнего BFS
+ */
+struct ExternalLevelStats {
+    std::int64_t frontierSize = 0;  ///< Вершин на уровне
+    IOCounters io;                  ///< Ввод-вывод: списки соседей, сортировка, вычитание уровней
+};
+
+/**
+ * @struct ExternalSearchStats
+ * @brief Статистика одного внешнего BFS
+ */
+struct ExternalSearchStats {
+    std::vector<ExternalLevelStats> levels;  ///< По уровням (уровень 0 - старт)
+    IOCounters collect;                      ///< Слияние уровней в одно множество
+};
+
+/**
+ * @struct ExternalQueryStats
+ * @brief Статистика запроса ExternalAnalyzer::findCommonCities
+ */
+struct ExternalQueryStats {
+    ExternalSearchStats fromK1;  ///< Обход из K1
+    ExternalSearchStats fromK2;  ///< Обход из K2 (пуст, если из K1 ничего не достижимо)
+    IOCounters intersect;        ///< Пересечение множеств
+    double seconds = 0.0;        ///< Время запроса
+
+    /**
+     * @brief Суммарный ввод-вывод запроса
+     * @return IOCounters Сумма по обходам и пересечению
+     */
+    IOCounters total() const;
+};
+
+/**
+ * @class ExternalAnalyzer
+ * @brief Анализатор общих городов над снимком на диске
+ *
+ * Отвечает так же, как GraphAnalyzer::findCommonCities для
+ * неориентированного графа. Память запроса - не больше бюджета,
+ * не считая вектора с ответом.
+ */
+class ExternalAnalyzer {
+private:
+    DiskFile file_;
+    SnapshotLayout layout_;
+    std::size_t memoryBudget_;
+    std::string tempDirectory_;
+
+    /**
+     * @struct VertexRun
+     * @brief Отсортированные номера вершин во временном файле
+     */
+    struct VertexRun {
+        DiskFile file;
+        std::uint64_t count;
+    };
+
+public:
+    /**
+     * @brief Наименьший бюджет памяти
+     */
+    static const std::size_t kMinMemoryBudget = 1 << 20;
+
+    /**
+     * @brief Конструктор
+     *
+     * Читается только заголовок снимка
+     * @param snapshotFile Двоичный снимок неориентированного графа
+     * @param memoryBudget Бюджет памяти запроса, байт
+     * @param tempDirectory Каталог временных файлов (пусто - $TMPDIR или /tmp)
+     * @throws std::runtime_error если снимок некорректен или ориентирован,
+     *         или бюджет меньше kMinMemoryBudget
+     */
+    ExternalAnalyzer(const std::string& snapshotFile, std::size_t memoryBudget,
+                     const std::string& tempDirectory = "");
+
+    /**
+     * @brief Количество городов
+     * @return int Количество городов
+     */
+    int cityCount() const { return layout_.vertexCount; }
+
+    /**
+     * @brief Количество дуг
+     * @return std::int64_t Длина массива соседей снимка
+     */
+    std::int64_t arcCount() const { return layout_.arcCount; }
+
+    /**
+     * @brief Бюджет памяти
+     * @return std::size_t Байт
+     */
+    std::size_t memoryBudget() const { return memoryBudget_; }
+
+    /**
+     * @brief Поиск общих городов
+     *
+     * Два внешних BFS глубины L + 1; уровни каждого сливаются в
+     * отсортированное множество, множества пересекаются слиянием
+     * @param k1 Первая штаб-квартира (1..cityCount)
+     * @param k2 Вторая штаб-квартира (1..cityCount)
+     * @param L Максимальное количество промежуточных городов
+     * @param[out] stats Статистика ввода-вывода по уровням (может быть nullptr)
+     * @return std::vector<int> Отсортированные номера городов или {-1}
+     * @throws std::runtime_error при некорректных параметрах или ошибке ввода-вывода
+     */
+    std::vector<int> findCommonCities(int k1, int k2, int L, ExternalQueryStats* stats = nullptr) const;
+
+private:
+    /**
+     * @brief Внешний BFS с объединением уровней
+     * @param start Стартовая вершина (0-based)
+     * @param maxDistance Максимальное расстояние в ребрах
+     * @param[out] stats Статистика по уровням
+     * @return VertexRun Вершины на расстоянии не больше maxDistance (со стартом)
+     */
+    VertexRun reachableVertices(int start, std::int64_t maxDistance, ExternalSearchStats& stats) const;
+
+    /**
+     * @brief Следующий уровень по Мунагале-Ранаде
+     *
+     * Списки соседей уровня читаются по возрастанию номеров, соседи
+     * сортируются с удалением повторов и вычитаются слиянием
+     * из текущего и предыдущего уровней
+     * @param current Текущий уровень
+     * @param previous Предыдущий уровень
+     * @param[out] counters Ввод-вывод
+     * @return VertexRun Следующий уровень
+     */
+    VertexRun nextLevel(const VertexRun& current, const VertexRun& previous, IOCounters& counters) const;
+
+    /**
+     * @brief Буфер одного последовательного потока
+     * @return std::size_t Байт (1/16 бюджета, но не меньше 64 КБ)
+     */
+    std::size_t streamBytes() const;
+};
+
+#endif // EXTERNAL_ANALYZER_H
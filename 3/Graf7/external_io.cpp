@@ -0,0 +1,106 @@
+/**
+ * @file external_io.cpp
+ * @brief Реализация файлового ввода-вывода для внешних алгоритмов
+ * @version 1.0
+ */
+
+#include "external_io.h"
+#include <cerrno>
+#include <cstdlib>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+DiskFile::DiskFile(const std::string& filename) : fd_(::open(filename.c_str(), O_RDONLY)) {
+    if (fd_ < 0) {
+        throw std::runtime_error("Не удалось открыть файл: " + filename);
+    }
+}
+
+DiskFile DiskFile::temporary(const std::string& directory) {
+    std::string base = temporaryDirectory(directory);
+    std::string pattern = base + "/graf7-XXXXXX";
+    std::vector<char> name(pattern.begin(), pattern.end());
+    name.push_back('\0');
+
+    int fd = ::mkstemp(name.data());
+    if (fd < 0) {
+        throw std::runtime_error("Не удалось создать временный файл в " + base);
+    }
+    ::unlink(name.data());
+    return DiskFile(fd);
+}
+
+std::string DiskFile::temporaryDirectory(const std::string& directory) {
+    if (!directory.empty()) {
+        return directory;
+    }
+    const char* environment = std::getenv("TMPDIR");
+    return environment != nullptr && *environment != '\0' ? environment : "/tmp";
+}
+
+DiskFile DiskFile::create(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Не удалось создать файл: " + filename);
+    }
+    return DiskFile(fd);
+}
+
+DiskFile& DiskFile::operator=(DiskFile&& other) {
+    if (this != &other) {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+        fd_ = other.fd_;
+        other.fd_ = -1;
+    }
+    return *this;
+}
+
+DiskFile::~DiskFile() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+void DiskFile::readAt(void* data, std::size_t size, std::uint64_t position) const {
+    char* out = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t done = ::pread(fd_, out, size, static_cast<off_t>(position));
+        if (done < 0 && errno == EINTR) {
+            continue;
+        }
+        if (done <= 0) {
+            throw std::runtime_error("Ошибка чтения файла на позиции " + std::to_string(position));
+        }
+        out += done;
+        size -= static_cast<std::size_t>(done);
+        position += static_cast<std::uint64_t>(done);
+    }
+}
+
+void DiskFile::writeAt(const void* data, std::size_t size, std::uint64_t position) {
+    const char* in = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t done = ::pwrite(fd_, in, size, static_cast<off_t>(position));
+        if (done < 0 && errno == EINTR) {
+            continue;
+        }
+        if (done <= 0) {
+            throw std::runtime_error("Ошибка записи файла на позиции " + std::to_string(position));
+        }
+        in += done;
+        size -= static_cast<std::size_t>(done);
+        position += static_cast<std::uint64_t>(done);
+    }
+}
+
+std::uint64_t DiskFile::size() const {
+    struct stat info;
+    if (::fstat(fd_, &info) != 0) {
+        throw std::runtime_error("Не удалось получить размер файла");
+    }
+    return static_cast<std::uint64_t>(info.st_size);
+}
@@ -0,0 +1,495 @@
+/**
+ * @file external_io.h
+ * @brief Последовательный ввод-вывод записей и внешняя сортировка
+ * @version 1.0
+ *
+ * Основа для алгоритмов, которым граф не помещается в память:
+ * файлы читаются и пишутся крупными буферами, память ограничена
+ * заданным бюджетом, а объем ввода-вывода подсчитывается.
+ * Временные файлы удаляются из каталога сразу после создания и
+ * исчезают при закрытии дескриптора, в том числе при аварийном выходе.
+ */
+
+#ifndef EXTERNAL_IO_H
+#define EXTERNAL_IO_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct IOCounters
+ * @brief Объем ввода-вывода
+ */
+struct IOCounters {
+    std::uint64_t bytesRead = 0;     ///< Прочитано байт
+    std::uint64_t bytesWritten = 0;  ///< Записано байт
+    std::uint64_t seeks = 0;         ///< Чтения не с того места, где закончилось предыдущее
+
+    /**
+     * @brief Накопление счетчиков
+     * @param other Прибавляемые счетчики
+     * @return IOCounters& Эти счетчики
+     */
+    IOCounters& operator+=(const IOCounters& other) {
+        bytesRead += other.bytesRead;
+        bytesWritten += other.bytesWritten;
+        seeks += other.seeks;
+        return *this;
+    }
+};
+
+/**
+ * @class DiskFile
+ * @brief Файловый дескриптор с позиционным чтением и записью
+ *
+ * Дескриптор закрывается в деструкторе. Объект можно перемещать,
+ * но нельзя копировать.
+ */
+class DiskFile {
+private:
+    int fd_;
+
+    explicit DiskFile(int fd) : fd_(fd) {}
+
+public:
+    /**
+     * @brief Открытие файла только для чтения
+     * @param filename Имя файла
+     * @throws std::runtime_error если файл не удалось открыть
+     */
+    explicit DiskFile(const std::string& filename);
+
+    /**
+     * @brief Создание временного файла
+     *
+     * Файл сразу удаляется из каталога и живет, пока открыт дескриптор
+     * @param directory Каталог (пусто - $TMPDIR или /tmp)
+     * @return DiskFile Файл, открытый на чтение и запись
+     * @throws std::runtime_error если файл не удалось создать
+     */
+    static DiskFile temporary(const std::string& directory);
+
+    /**
+     * @brief Каталог временных файлов
+     * @param directory Заданный каталог
+     * @return std::string directory или, если он пуст, $TMPDIR или /tmp
+     */
+    static std::string temporaryDirectory(const std::string& directory);
+
+    /**
+     * @brief Создание (или очистка) файла для записи
+     * @param filename Имя файла
+     * @return DiskFile Файл, открытый на чтение и запись
+     * @throws std::runtime_error если файл не удалось создать
+     */
+    static DiskFile create(const std::string& filename);
+
+    DiskFile(DiskFile&& other) : fd_(other.fd_) { other.fd_ = -1; }
+    DiskFile& operator=(DiskFile&& other);
+    DiskFile(const DiskFile&) = delete;
+    DiskFile& operator=(const DiskFile&) = delete;
+
+    ~DiskFile();
+
+    /**
+     * @brief Чтение с заданной позиции
+     * @param[out] data Буфер
+     * @param size Сколько байт прочитать
+     * @param position Позиция в файле
+     * @throws std::runtime_error при ошибке или преждевременном конце файла
+     */
+    void readAt(void* data, std::size_t size, std::uint64_t position) const;
+
+    /**
+     * @brief Запись с заданной позиции
+     * @param data Данные
+     * @param size Сколько байт записать
+     * @param position Позиция в файле
+     * @throws std::runtime_error при ошибке записи (например, нет места)
+     */
+    void writeAt(const void* data, std::size_t size, std::uint64_t position);
+
+    /**
+     * @brief Размер файла
+     * @return std::uint64_t Размер в байтах
+     */
+    std::uint64_t size() const;
+};
+
+/**
+ * @class RecordWriter
+ * @brief Буферизованная последовательная запись записей
+ *
+ * Записи копируются побайтно: T - тривиально копируемый тип
+ */
+template <class T>
+class RecordWriter {
+private:
+    DiskFile* file_;
+    std::uint64_t position_;  ///< Позиция следующего сброса буфера
+    std::vector<T> buffer_;
+    std::size_t capacity_;
+    std::uint64_t count_;
+    IOCounters* counters_;
+
+public:
+    /**
+     * @brief Конструктор
+     * @param file Файл
+     * @param position Позиция первой записи
+     * @param bufferBytes Размер буфера
+     * @param counters Счетчики ввода-вывода (может быть nullptr)
+     */
+    RecordWriter(DiskFile& file, std::uint64_t position, std::size_t bufferBytes, IOCounters* counters)
+        : file_(&file), position_(position), capacity_(std::max<std::size_t>(1, bufferBytes / sizeof(T))),
+          count_(0), counters_(counters) {
+        buffer_.reserve(capacity_);
+    }
+
+    /**
+     * @brief Добавление записи
+     * @param value Запись
+     */
+    void push(const T& value) {
+        buffer_.push_back(value);
+        ++count_;
+        if (buffer_.size() == capacity_) {
+            flush();
+        }
+    }
+
+    /**
+     * @brief Сброс буфера в файл
+     */
+    void flush() {
+        if (buffer_.empty()) {
+            return;
+        }
+        std::size_t bytes = buffer_.size() * sizeof(T);
+        file_->writeAt(buffer_.data(), bytes, position_);
+        position_ += bytes;
+        if (counters_ != nullptr) {
+            counters_->bytesWritten += bytes;
+        }
+        buffer_.clear();
+    }
+
+    /**
+     * @brief Количество добавленных записей
+     * @return std::uint64_t Количество записей
+     */
+    std::uint64_t count() const { return count_; }
+};
+
+/**
+ * @class RecordReader
+ * @brief Буферизованное чтение массива записей из файла
+ *
+ * Поддерживает последовательное чтение (next) и обращение по
+ * неубывающим номерам (at). Упреждающее чтение как в ядре: после
+ * перехода (seek) читается страница kSeekBytes, каждое следующее
+ * последовательное чтение - вдвое больше, до размера буфера. Пропуск
+ * короче текущего окна дочитывается, длиннее - становится переходом,
+ * поэтому редкие обращения не тянут за собой весь файл
+ */
+template <class T>
+class RecordReader {
+private:
+    const DiskFile* file_;
+    std::uint64_t start_;       ///< Позиция записи 0
+    std::uint64_t count_;       ///< Количество записей
+    std::vector<T> buffer_;
+    std::uint64_t bufferFirst_; ///< Номер записи buffer_[0]
+    std::uint64_t loadEnd_;     ///< Номер записи после последней прочитанной
+    std::uint64_t position_;    ///< Номер следующей записи для next
+    std::size_t capacity_;
+    std::size_t window_;        ///< Записей в следующем последовательном чтении
+    IOCounters* counters_;
+
+    void load(std::uint64_t index) {
+        bool sequential = index >= loadEnd_ && index - loadEnd_ < window_;
+        std::size_t page = std::max<std::size_t>(1, kSeekBytes / sizeof(T));
+        window_ = sequential ? std::min(capacity_, 2 * window_) : page;
+        std::uint64_t first = sequential ? loadEnd_ : index;
+        std::size_t size = static_cast<std::size_t>(std::min<std::uint64_t>(window_, count_ - first));
+        buffer_.resize(size);
+        file_->readAt(buffer_.data(), size * sizeof(T), start_ + first * sizeof(T));
+        if (counters_ != nullptr) {
+            counters_->bytesRead += size * sizeof(T);
+            counters_->seeks += !sequential;
+        }
+        bufferFirst_ = first;
+        loadEnd_ = first + size;
+    }
+
+public:
+    /**
+     * @brief Сколько байт читается при переходе
+     */
+    static const std::size_t kSeekBytes = 4096;
+
+    /**
+     * @brief Конструктор
+     * @param file Файл
+     * @param start Позиция записи 0
+     * @param count Количество записей
+     * @param bufferBytes Размер буфера
+     * @param counters Счетчики ввода-вывода (может быть nullptr)
+     */
+    RecordReader(const DiskFile& file, std::uint64_t start, std::uint64_t count, std::size_t bufferBytes,
+                 IOCounters* counters)
+        : file_(&file), start_(start), count_(count), bufferFirst_(0), loadEnd_(0), position_(0),
+          capacity_(std::max<std::size_t>(1, bufferBytes / sizeof(T))),
+          window_(std::max<std::size_t>(1, kSeekBytes / sizeof(T))), counters_(counters) {}
+
+    /**
+     * @brief Следующая запись
+     * @param[out] value Запись
+     * @return false если записи закончились
+     */
+    bool next(T& value) {
+        if (position_ >= count_) {
+            return false;
+        }
+        value = at(position_++);
+        return true;
+    }
+
+    /**
+     * @brief Запись по номеру
+     * @param index Номер записи (< count)
+     * @return const T& Запись (действительна до следующего чтения)
+     */
+    const T& at(std::uint64_t index) {
+        if (index < bufferFirst_ || index >= bufferFirst_ + buffer_.size()) {
+            load(index);
+        }
+        return buffer_[static_cast<std::size_t>(index - bufferFirst_)];
+    }
+
+    /**
+     * @brief Количество записей
+     * @return std::uint64_t Количество записей
+     */
+    std::uint64_t count() const { return count_; }
+};
+
+/**
+ * @class ExternalSorter
+ * @brief Внешняя сортировка слиянием в пределах бюджета памяти
+ *
+ * Записи накапливаются в буфере на 2/3 бюджета; заполненный буфер
+ * сортируется и сбрасывается во временный файл (серию). finish
+ * сливает серии по fanIn за проход, пока их не останется столько,
+ * чтобы слить за один, и передает записи потребителю по возрастанию.
+ * Если все записи поместились в буфер, файлы не создаются. Открытых
+ * серий не бывает больше kMaxOpenRuns: при переполнении они
+ * сливаются проходом заранее.
+ */
+template <class T>
+class ExternalSorter {
+private:
+    /**
+     * @struct Run
+     * @brief Отсортированная серия во временном файле
+     */
+    struct Run {
+        DiskFile file;
+        std::uint64_t count;
+    };
+
+    std::size_t memoryBudget_;
+    std::string tempDirectory_;
+    bool unique_;
+    IOCounters* counters_;
+    std::vector<T> buffer_;
+    std::size_t capacity_;
+    std::vector<Run> runs_;
+
+public:
+    /**
+     * @brief Наименьший буфер одной серии при слиянии
+     */
+    static const std::size_t kMinStreamBytes = 64 * 1024;
+
+    /**
+     * @brief Наибольшее число серий (открытых временных файлов)
+     */
+    static const std::size_t kMaxOpenRuns = 256;
+
+    /**
+     * @brief Конструктор
+     * @param memoryBudget Память под буфер и под слияние, байт
+     * @param tempDirectory Каталог временных файлов (пусто - $TMPDIR или /tmp)
+     * @param unique true - равные записи выдаются один раз
+     * @param counters Счетчики ввода-вывода (может быть nullptr)
+     */
+    ExternalSorter(std::size_t memoryBudget, const std::string& tempDirectory, bool unique, IOCounters* counters)
+        : memoryBudget_(std::max(memoryBudget, 2 * kMinStreamBytes)), tempDirectory_(tempDirectory),
+          unique_(unique), counters_(counters), capacity_(memoryBudget_ / 3 * 2 / sizeof(T)) {}
+
+    /**
+     * @brief Добавление записи
+     * @param value Запись
+     */
+    void push(const T& value) {
+        if (buffer_.size() == capacity_) {
+            spill();
+        }
+        // Рост вдвое, но не дальше capacity_: при перевыделении старый и
+        // новый буферы вместе занимают не больше бюджета
+        if (buffer_.size() == buffer_.capacity()) {
+            buffer_.reserve(std::min(capacity_, std::max<std::size_t>(1024, 2 * buffer_.capacity())));
+        }
+        buffer_.push_back(value);
+    }
+
+    /**
+     * @brief Добавление готовой отсортированной серии
+     *
+     * Серия сливается вместе с остальными без повторной сортировки
+     * @param file Файл с записями по возрастанию с позиции 0
+     * @param count Количество записей
+     */
+    void addSortedRun(DiskFile&& file, std::uint64_t count) {
+        if (count == 0) {
+            return;
+        }
+        Run run = {std::move(file), count};
+        runs_.push_back(std::move(run));
+        limitOpenRuns();
+    }
+
+    /**
+     * @brief Выдача всех записей по возрастанию
+     *
+     * После вызова сортировщик пуст
+     * @param consumer Функция, вызываемая для каждой записи
+     */
+    template <class Consumer>
+    void finish(Consumer consumer) {
+        if (runs_.empty()) {
+            sortBuffer();
+            for (const T& value : buffer_) {
+                consumer(value);
+            }
+            std::vector<T>().swap(buffer_);
+            return;
+        }
+
+        spill();
+        std::vector<T>().swap(buffer_);
+        while (runs_.size() > fanIn()) {
+            mergePass();
+        }
+        merge(0, runs_.size(), consumer);
+        runs_.clear();
+    }
+
+private:
+    void sortBuffer() {
+        std::sort(buffer_.begin(), buffer_.end());
+        if (unique_) {
+            buffer_.erase(std::unique(buffer_.begin(), buffer_.end()), buffer_.end());
+        }
+    }
+
+    void spill() {
+        if (buffer_.empty()) {
+            return;
+        }
+        sortBuffer();
+        Run run = {DiskFile::temporary(tempDirectory_), static_cast<std::uint64_t>(buffer_.size())};
+        std::size_t bytes = buffer_.size() * sizeof(T);
+        run.file.writeAt(buffer_.data(), bytes, 0);
+        if (counters_ != nullptr) {
+            counters_->bytesWritten += bytes;
+        }
+        runs_.push_back(std::move(run));
+        buffer_.clear();
+        limitOpenRuns();
+    }
+
+    std::size_t fanIn() const {
+        return std::max<std::size_t>(2, memoryBudget_ / kMinStreamBytes - 1);
+    }
+
+    /**
+     * @brief Слияние лишних серий; буфер освобождается, чтобы слияние уложилось в бюджет
+     */
+    void limitOpenRuns() {
+        if (runs_.size() >= kMaxOpenRuns) {
+            std::vector<T>().swap(buffer_);
+            mergePass();
+        }
+    }
+
+    /**
+     * @brief Один проход: каждые fanIn серий сливаются в одну
+     */
+    void mergePass() {
+        std::vector<Run> merged;
+        for (std::size_t first = 0; first < runs_.size(); first += fanIn()) {
+            std::size_t last = std::min(runs_.size(), first + fanIn());
+            Run run = {DiskFile::temporary(tempDirectory_), 0};
+            RecordWriter<T> writer(run.file, 0, memoryBudget_ / (last - first + 1), counters_);
+            merge(first, last, [&writer](const T& value) { writer.push(value); });
+            writer.flush();
+            run.count = writer.count();
+            merged.push_back(std::move(run));
+        }
+        runs_.swap(merged);
+    }
+
+    /**
+     * @brief Слияние серий [first, last) кучей по текущим записям
+     */
+    template <class Consumer>
+    void merge(std::size_t first, std::size_t last, Consumer&& consumer) {
+        typedef std::pair<T, std::size_t> Head;
+        std::size_t streamBytes = memoryBudget_ / (last - first + 1);
+        std::vector<RecordReader<T>> readers;
+        readers.reserve(last - first);
+        std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+        for (std::size_t i = first; i < last; ++i) {
+            readers.push_back(RecordReader<T>(runs_[i].file, 0, runs_[i].count, streamBytes, counters_));
+            T value;
+            if (readers.back().next(value)) {
+                heads.push(Head(value, readers.size() - 1));
+            }
+        }
+
+        bool emitted = false;
+        T previous = T();
+        while (!heads.empty()) {
+            Head head = heads.top();
+            heads.pop();
+            if (!unique_ || !emitted || !(previous == head.first)) {
+                consumer(head.first);
+                previous = head.first;
+                emitted = true;
+            }
+            T value;
+            if (readers[head.second].next(value)) {
+                heads.push(Head(value, head.second));
+            }
+        }
+    }
+};
+
+template <class T>
+const std::size_t RecordReader<T>::kSeekBytes;
+
+template <class T>
+const std::size_t ExternalSorter<T>::kMinStreamBytes;
+
+template <class T>
+const std::size_t ExternalSorter<T>::kMaxOpenRuns;
+
+#endif // EXTERNAL_IO_H
@@ -0,0 +1,207 @@
+/**
+ * @file frontier_transport.cpp
+ * @brief Реализация обмена границами через Unix-сокеты
+ * @version 1.0
+ */
+
+#include "frontier_transport.h"
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+const std::size_t kHeaderBytes = 2 * sizeof(std::int64_t);
+
+/**
+ * @struct PeerState
+ * @brief Ход отправки и приема сообщения одного соединения
+ */
+struct PeerState {
+    std::int64_t outHeader[2];
+    const char* outPayload = nullptr;
+    std::size_t outSize = 0;       ///< Заголовок и вершины
+    std::size_t outDone = 0;
+    std::int64_t inHeader[2];
+    std::size_t inSize = kHeaderBytes;  ///< Растет после приема заголовка
+    std::size_t inDone = 0;
+};
+
+/**
+ * @brief Отправка очередной части сообщения без ожидания
+ * @param fd Сокет
+ * @param state Состояние соединения
+ * @return std::size_t Отправлено байт
+ */
+std::size_t sendSome(int fd, PeerState& state) {
+    const char* data = state.outDone < kHeaderBytes
+                           ? reinterpret_cast<const char*>(state.outHeader) + state.outDone
+                           : state.outPayload + (state.outDone - kHeaderBytes);
+    std::size_t size = state.outDone < kHeaderBytes ? kHeaderBytes - state.outDone : state.outSize - state.outDone;
+    ssize_t sent = ::send(fd, data, size, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (sent < 0) {
+        if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
+        throw std::runtime_error(std::string("Ошибка отправки границы: ") + std::strerror(errno));
+    }
+    state.outDone += static_cast<std::size_t>(sent);
+    return static_cast<std::size_t>(sent);
+}
+
+/**
+ * @brief Прием очередной части сообщения без ожидания
+ * @param fd Сокет
+ * @param state Состояние соединения
+ * @param[out] vertices Вершины сообщения
+ */
+void receiveSome(int fd, PeerState& state, std::vector<int>& vertices) {
+    char* data = state.inDone < kHeaderBytes
+                     ? reinterpret_cast<char*>(state.inHeader) + state.inDone
+                     : reinterpret_cast<char*>(vertices.data()) + (state.inDone - kHeaderBytes);
+    std::size_t size = state.inDone < kHeaderBytes ? kHeaderBytes - state.inDone : state.inSize - state.inDone;
+    ssize_t got = ::recv(fd, data, size, MSG_DONTWAIT);
+    if (got == 0) {
+        throw std::runtime_error("Процесс BFS разорвал соединение");
+    }
+    if (got < 0) {
+        if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
+            return;
+        }
+        throw std::runtime_error(std::string("Ошибка приема границы: ") + std::strerror(errno));
+    }
+    state.inDone += static_cast<std::size_t>(got);
+
+    // Заголовок принят - известен размер вершин
+    if (state.inDone == kHeaderBytes && state.inSize == kHeaderBytes) {
+        std::int64_t count = state.inHeader[0];
+        if (count < 0 || count > INT_MAX) {
+            throw std::runtime_error("Некорректное сообщение границы: " + std::to_string(count) + " вершин");
+        }
+        vertices.resize(static_cast<std::size_t>(count));
+        state.inSize = kHeaderBytes + static_cast<std::size_t>(count) * sizeof(int);
+    }
+}
+
+} // namespace
+
+SocketTransport::SocketTransport(int rank, std::vector<int> peers)
+    : rank_(rank), peers_(std::move(peers)), bytesSent_(0) {}
+
+SocketTransport::~SocketTransport() {
+    for (int fd : peers_) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+std::int64_t SocketTransport::exchange(const std::vector<std::vector<int>>& outgoing, std::int64_t localCount,
+                                       std::vector<std::vector<int>>& incoming) {
+    int count = size();
+    std::vector<PeerState> states(static_cast<std::size_t>(count));
+    incoming.assign(static_cast<std::size_t>(count), std::vector<int>());
+    for (int p = 0; p < count; ++p) {
+        if (p == rank_) {
+            continue;
+        }
+        PeerState& state = states[p];
+        state.outHeader[0] = static_cast<std::int64_t>(outgoing[p].size());
+        state.outHeader[1] = localCount;
+        state.outPayload = reinterpret_cast<const char*>(outgoing[p].data());
+        state.outSize = kHeaderBytes + outgoing[p].size() * sizeof(int);
+    }
+
+    std::int64_t total = localCount;
+    std::vector<pollfd> entries;
+    std::vector<int> owners;
+    for (;;) {
+        entries.clear();
+        owners.clear();
+        for (int p = 0; p < count; ++p) {
+            if (p == rank_) {
+                continue;
+            }
+            short events = 0;
+            if (states[p].outDone < states[p].outSize) {
+                events |= POLLOUT;
+            }
+            if (states[p].inDone < states[p].inSize) {
+                events |= POLLIN;
+            }
+            if (events != 0) {
+                pollfd entry = {peers_[p], events, 0};
+                entries.push_back(entry);
+                owners.push_back(p);
+            }
+        }
+        if (entries.empty()) {
+            break;
+        }
+
+        if (::poll(entries.data(), entries.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(std::string("Ошибка ожидания границы: ") + std::strerror(errno));
+        }
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            int p = owners[i];
+            short ready = entries[i].revents;
+            if ((entries[i].events & POLLOUT) && (ready & (POLLOUT | POLLERR | POLLHUP))) {
+                bytesSent_ += sendSome(peers_[p], states[p]);
+            }
+            if ((entries[i].events & POLLIN) && (ready & (POLLIN | POLLERR | POLLHUP))) {
+                receiveSome(peers_[p], states[p], incoming[p]);
+                if (states[p].inDone == states[p].inSize) {
+                    total += states[p].inHeader[1];
+                }
+            }
+        }
+    }
+    return total;
+}
+
+SocketMesh::SocketMesh(int size)
+    : sockets_(static_cast<std::size_t>(size), std::vector<int>(static_cast<std::size_t>(size), -1)) {
+    for (int i = 0; i < size; ++i) {
+        for (int j = i + 1; j < size; ++j) {
+            int pair[2];
+            if (::socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+                int error = errno;
+                closeAll();
+                throw std::runtime_error(std::string("Не удалось создать сокеты между процессами: ") +
+                                         std::strerror(error));
+            }
+            sockets_[i][j] = pair[0];
+            sockets_[j][i] = pair[1];
+        }
+    }
+}
+
+SocketMesh::~SocketMesh() {
+    closeAll();
+}
+
+std::unique_ptr<FrontierTransport> SocketMesh::endpoint(int rank) {
+    std::vector<int> peers;
+    peers.swap(sockets_[rank]);
+    closeAll();
+    return std::unique_ptr<FrontierTransport>(new SocketTransport(rank, std::move(peers)));
+}
+
+void SocketMesh::closeAll() {
+    for (std::vector<int>& row : sockets_) {
+        for (int& fd : row) {
+            if (fd >= 0) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+    }
+}
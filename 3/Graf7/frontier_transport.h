@@ -0,0 +1,136 @@
+/**
+ * @file frontier_transport.h
+ * @brief Обмен границами BFS между процессами
+ * @version 1.0
+ *
+ * Распределенному BFS нужна одна коллективная операция: на каждом
+ * уровне каждый процесс отправляет каждому другому найденные
+ * вершины его части графа и получает такие же от всех. Операция
+ * описана интерфейсом FrontierTransport; сейчас она реализована
+ * через Unix-сокеты между процессами одной машины (SocketTransport),
+ * а сетевую реализацию можно подставить, не меняя BFS.
+ */
+
+#ifndef FRONTIER_TRANSPORT_H
+#define FRONTIER_TRANSPORT_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @class FrontierTransport
+ * @brief Обмен "все со всеми" между процессами распределенного BFS
+ */
+class FrontierTransport {
+public:
+    virtual ~FrontierTransport() {}
+
+    /**
+     * @brief Номер этого процесса
+     * @return int 0..size()-1
+     */
+    virtual int rank() const = 0;
+
+    /**
+     * @brief Количество процессов
+     * @return int Количество процессов
+     */
+    virtual int size() const = 0;
+
+    /**
+     * @brief Обмен вершинами (вызывают все процессы)
+     *
+     * Вместе с вершинами передается число, которое суммируется
+     * по всем процессам: так все одновременно узнают размер
+     * глобальной границы и одинаково решают, продолжать ли обход
+     * @param outgoing Вершины для каждого процесса (свой элемент не отправляется)
+     * @param localCount Слагаемое этого процесса
+     * @param[out] incoming Вершины от каждого процесса (свой элемент пуст)
+     * @return std::int64_t Сумма localCount по всем процессам
+     * @throws std::runtime_error при ошибке связи или завершении другого процесса
+     */
+    virtual std::int64_t exchange(const std::vector<std::vector<int>>& outgoing, std::int64_t localCount,
+                                  std::vector<std::vector<int>>& incoming) = 0;
+
+    /**
+     * @brief Отправлено байт за все обмены
+     * @return std::uint64_t Байт вместе с заголовками сообщений
+     */
+    virtual std::uint64_t bytesSent() const = 0;
+};
+
+/**
+ * @class SocketTransport
+ * @brief Обмен через пары Unix-сокетов (полный граф соединений)
+ *
+ * Сообщение - заголовок из двух 64-битных чисел (количество вершин
+ * и слагаемое суммы) и номера вершин. Отправка и прием идут
+ * одновременно через poll, поэтому большие сообщения не блокируют
+ * друг друга при заполненных буферах сокетов.
+ */
+class SocketTransport : public FrontierTransport {
+private:
+    int rank_;
+    std::vector<int> peers_;  ///< Сокет к каждому процессу (-1 - к себе)
+    std::uint64_t bytesSent_;
+
+public:
+    /**
+     * @brief Конструктор
+     * @param rank Номер процесса
+     * @param peers Сокеты к процессам (владение передается объекту)
+     */
+    SocketTransport(int rank, std::vector<int> peers);
+
+    ~SocketTransport();
+
+    SocketTransport(const SocketTransport&) = delete;
+    SocketTransport& operator=(const SocketTransport&) = delete;
+
+    int rank() const override { return rank_; }
+    int size() const override { return static_cast<int>(peers_.size()); }
+    std::int64_t exchange(const std::vector<std::vector<int>>& outgoing, std::int64_t localCount,
+                          std::vector<std::vector<int>>& incoming) override;
+    std::uint64_t bytesSent() const override { return bytesSent_; }
+};
+
+/**
+ * @class SocketMesh
+ * @brief Сокеты между всеми парами процессов до fork
+ *
+ * Создается в родительском процессе; каждый дочерний процесс
+ * забирает свою строку через endpoint, а остальные сокеты
+ * закрываются (в родителе - деструктором)
+ */
+class SocketMesh {
+private:
+    std::vector<std::vector<int>> sockets_;  ///< sockets_[i][j] - конец соединения i-j у процесса i
+
+public:
+    /**
+     * @brief Создание соединений
+     * @param size Количество процессов
+     * @throws std::runtime_error если сокеты не удалось создать
+     */
+    explicit SocketMesh(int size);
+
+    ~SocketMesh();
+
+    SocketMesh(const SocketMesh&) = delete;
+    SocketMesh& operator=(const SocketMesh&) = delete;
+
+    /**
+     * @brief Транспорт процесса rank
+     *
+     * Сокеты остальных процессов закрываются
+     * @param rank Номер процесса
+     * @return std::unique_ptr<FrontierTransport> Транспорт
+     */
+    std::unique_ptr<FrontierTransport> endpoint(int rank);
+
+private:
+    void closeAll();
+};
+
+#endif // FRONTIER_TRANSPORT_H
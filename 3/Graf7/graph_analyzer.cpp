@@ -1,110 +1,644 @@
 /**
  * @file graph_analyzer.cpp
  * @brief Реализация анализатора графа
- * @version 2.3
+ * @version 3.0
  */
 
 #include "graph_analyzer.h"
+#include "common_zone_matrix.h"
 #include "graph_utils.h"
+#include <algorithm>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
 #include <iostream>
+#include <map>
+#include <utility>
 
-GraphAnalyzer::GraphAnalyzer(const AdjacencyMatrix& graph, int cityCount) 
-    : graph_(graph), cityCount_(cityCount) {}
+GraphAnalyzer::GraphAnalyzer(const CSRGraph& graph, int cityCount) 
+    : GraphAnalyzer(GraphSnapshot::create(graph, cityCount)) {}
+
+GraphAnalyzer::GraphAnalyzer(std::shared_ptr<const GraphSnapshot> snapshot)
+    : diagnostics_(Verbosity::Silent, std::cerr), requestedThreads_(-1) {
+    setSnapshot(std::move(snapshot));
+}
+
+void GraphAnalyzer::setSnapshot(std::shared_ptr<const GraphSnapshot> snapshot) {
+    if (!snapshot) {
+        throw std::runtime_error("Пустой снимок графа");
+    }
+    if (snapshot_ && snapshot_->version() != snapshot->version()) {
+        reachIndex_ = ReachabilityIndex();
+    }
+    snapshot_ = std::move(snapshot);
+    
+    if (requestedThreads_ == -1) {
+        bool parallel = !snapshot_->isDense() && !snapshot_->isCompressed() && isLargeGraph(snapshot_->graph());
+        if (!parallel) {
+            pool_.reset();
+        } else if (!pool_) {
+            pool_.reset(new ThreadPool());
+        }
+    }
+}
+
+const std::shared_ptr<const GraphSnapshot>& GraphAnalyzer::snapshot() const {
+    return snapshot_;
+}
 
 std::vector<int> GraphAnalyzer::findCommonCities(int k1, int k2, int L) {
+    return findCommonCities(k1, k2, L, ReachMode::FromBoth);
+}
+
+std::vector<int> GraphAnalyzer::findCommonCities(int k1, int k2, int L, ReachMode mode) {
     validateInput(k1, k2, L);
     
-    // Преобразование в 0-based индексы
-    int start1 = k1 - 1;
-    int start2 = k2 - 1;
+    // Преобразование в вершины снимка
+    int start1 = vertexOf(k1);
+    int start2 = vertexOf(k2);
     
-    // Максимальное расстояние в ребрах = L + 1
-    int maxDistance = L + 1;
+    // Максимальное расстояние в ребрах = L + 1 (L ограничено, см. boundedL)
+    int maxDistance = boundedL(L) + 1;
     
-    std::cout << std::endl;
-    std::cout << "=== ОТЛАДОЧНАЯ ИНФОРМАЦИЯ ===" << std::endl;
-    std::cout << "K1=" << k1 << " (0-based: " << start1 << "), ";
-    std::cout << "K2=" << k2 << " (0-based: " << start2 << "), ";
-    std::cout << "L=" << L << " (maxDistance=" << maxDistance << ")" << std::endl;
+    QueryStats stats;
+    stats.k1 = k1;
+    stats.k2 = k2;
+    stats.L = L;
     
-    // Поиск достижимых городов из обеих штаб-квартир
-    std::set<int> reachableFromK1 = findReachableCities(start1, maxDistance);
-    std::set<int> reachableFromK2 = findReachableCities(start2, maxDistance);
+    std::vector<int> commonCities;
+    if (answerFromComponents(start1, start2, maxDistance - 1, commonCities)) {
+        GRAF7_DIAG(diagnostics_, Verbosity::Summary,
+                   stats.resultSize = commonCities.front() == -1 ? 0 : commonCities.size();
+                   diagnostics_.reportQuery(stats));
+        return commonCities;
+    }
     
-    // Отладочный вывод ДО удаления штаб-квартир
-    std::cout << "[ОТЛАДКА] Достижимые из K1 (включая саму K1): ";
-    for (int city : reachableFromK1) {
-        std::cout << (city + 1) << " ";
+    // У неориентированного графа все режимы совпадают
+    if (!snapshot_->isDirected()) {
+        mode = ReachMode::FromBoth;
     }
-    std::cout << std::endl;
     
-    std::cout << "[ОТЛАДКА] Достижимые из K2 (включая саму K2): ";
-    for (int city : reachableFromK2) {
-        std::cout << (city + 1) << " ";
+    if (mode == ReachMode::FromBoth && reachIndex_.covers(L)) {
+        // Строки индекса - готовые множества в пределах L + 1 ребер
+        PhaseTimer intersectTimer(diagnostics_.enabled(Verbosity::Summary));
+        DenseBitset common(snapshot_->cityCount());
+        DenseBitset::intersectWords(reachIndex_.row(L, start1), reachIndex_.row(L, start2),
+                                    common.words(), common.wordCount());
+        common.reset(start1);
+        common.reset(start2);
+        commonCities = common.toVector();
+        GRAF7_DIAG(diagnostics_, Verbosity::Summary,
+                   stats.intersectSeconds = intersectTimer.seconds());
+    } else {
+        // Поиск достижимых городов из обеих штаб-квартир
+        DenseBitset reachableFromK1 = findReachableCities(start1, maxDistance, stats.fromK1,
+                                                          mode == ReachMode::ToBoth);
+        DenseBitset reachableFromK2 = findReachableCities(start2, maxDistance, stats.fromK2,
+                                                          mode != ReachMode::FromBoth);
+        
+        // Штаб-квартиры не входят в множества достижимых городов
+        reachableFromK1.reset(start1);
+        reachableFromK2.reset(start2);
+        
+        // Поиск пересечения (только общие города, исключая штаб-квартиры)
+        PhaseTimer intersectTimer(diagnostics_.enabled(Verbosity::Summary));
+        commonCities = GraphUtils::findIntersection(reachableFromK1, reachableFromK2);
+        GRAF7_DIAG(diagnostics_, Verbosity::Summary,
+                   stats.intersectSeconds = intersectTimer.seconds());
     }
-    std::cout << std::endl;
     
-    // УДАЛЯЕМ штаб-квартиры из множеств достижимых городов
-    reachableFromK1.erase(start1);
-    reachableFromK2.erase(start2);
+    // Преобразование обратно в номера городов
+    toCityNumbers(commonCities);
     
-    // Отладочный вывод ПОСЛЕ удаления штаб-квартир
-    std::cout << "[ОТЛАДКА] Достижимые из K1 (исключая саму K1): ";
-    for (int city : reachableFromK1) {
-        std::cout << (city + 1) << " ";
+    stats.resultSize = commonCities.size();
+    GRAF7_DIAG(diagnostics_, Verbosity::Summary, diagnostics_.reportQuery(stats));
+    
+    if (commonCities.empty()) {
+        return {-1};
     }
-    std::cout << std::endl;
     
-    std::cout << "[ОТЛАДКА] Достижимые из K2 (исключая саму K2): ";
-    for (int city : reachableFromK2) {
-        std::cout << (city + 1) << " ";
+    return commonCities;
+}
+
+std::vector<int> GraphAnalyzer::findCommonCities(const std::vector<int>& headquarters, int L) {
+    if (headquarters.size() < 2 || headquarters.size() > static_cast<size_t>(GraphUtils::kMaxCommonSources)) {
+        throw std::runtime_error("Количество штаб-квартир должно быть от 2 до " +
+                                 std::to_string(GraphUtils::kMaxCommonSources));
+    }
+    if (!GraphUtils::isValidL(L)) {
+        throw std::runtime_error("Некорректное значение L: " + std::to_string(L));
     }
-    std::cout << std::endl;
     
-    // Поиск пересечения (только общие города, исключая штаб-квартиры)
-    std::vector<int> commonCities = GraphUtils::findIntersection(reachableFromK1, reachableFromK2);
+    std::vector<int> sources;
+    for (int city : headquarters) {
+        if (!GraphUtils::isValidCity(city, snapshot_->cityCount())) {
+            throw std::runtime_error("Некорректный номер штаб-квартиры: " + std::to_string(city));
+        }
+        sources.push_back(vertexOf(city));
+    }
+    std::vector<int> sortedSources(sources);
+    std::sort(sortedSources.begin(), sortedSources.end());
+    if (std::adjacent_find(sortedSources.begin(), sortedSources.end()) != sortedSources.end()) {
+        throw std::runtime_error("Штаб-квартиры не могут повторяться");
+    }
     
-    // Преобразование обратно в 1-based индексы
-    for (int& city : commonCities) {
-        city += 1;
+    // Как и для двух штаб-квартир: разные компоненты - общих городов нет,
+    // L + 1 не меньше оценок эксцентриситетов всех - вся компонента
+    const ComponentIndex& components = snapshot_->components();
+    int maxDistance = boundedL(L) + 1;
+    bool wholeComponent = !snapshot_->isDirected();
+    for (int source : sources) {
+        if (!components.connected(sources[0], source)) {
+            return {-1};
+        }
+        wholeComponent = wholeComponent && maxDistance >= components.eccentricityBound(source);
     }
     
-    std::cout << "[ОТЛАДКА] Общие города (1-based): ";
-    if (commonCities.empty()) {
-        std::cout << "нет";
+    std::vector<int> commonCities;
+    if (wholeComponent) {
+        int component = components.componentOf(sources[0]);
+        for (const int* it = components.membersBegin(component); it != components.membersEnd(component); ++it) {
+            if (!std::binary_search(sortedSources.begin(), sortedSources.end(), *it)) {
+                commonCities.push_back(*it);
+            }
+        }
+    } else if (reachIndex_.covers(L)) {
+        DenseBitset common(snapshot_->cityCount());
+        DenseBitset::intersectWords(reachIndex_.row(L, sources[0]), reachIndex_.row(L, sources[1]),
+                                    common.words(), common.wordCount());
+        for (size_t i = 2; i < sources.size(); ++i) {
+            DenseBitset::intersectWords(common.words(), reachIndex_.row(L, sources[i]),
+                                        common.words(), common.wordCount());
+        }
+        for (int source : sources) {
+            common.reset(source);
+        }
+        commonCities = common.toVector();
     } else {
-        for (int city : commonCities) {
-            std::cout << city << " ";
+        PhaseTimer reachTimer(diagnostics_.enabled(Verbosity::Summary));
+        CommonReachResult reach = GraphUtils::commonReach(snapshot_->graph(), sources, maxDistance);
+        GRAF7_DIAG(diagnostics_, Verbosity::Summary,
+                   diagnostics_.sink().writeLine(
+                       "[ОБЩИЕ] штаб-квартир=" + std::to_string(sources.size()) +
+                       " L=" + std::to_string(L) +
+                       " уровней=" + std::to_string(reach.levels) +
+                       " затронуто вершин=" + std::to_string(reach.touched) +
+                       (reach.stoppedEarly ? " досрочно" : "") +
+                       " мкс=" + std::to_string(static_cast<long long>(reachTimer.seconds() * 1e6))));
+        for (int city : reach.vertices) {
+            if (!std::binary_search(sortedSources.begin(), sortedSources.end(), city)) {
+                commonCities.push_back(city);
+            }
         }
     }
-    std::cout << std::endl;
-    std::cout << "========================" << std::endl;
-    std::cout << std::endl;
     
+    toCityNumbers(commonCities);
     if (commonCities.empty()) {
         return {-1};
     }
+    return commonCities;
+}
+
+std::vector<std::vector<int>> GraphAnalyzer::findCommonCitiesBatch(const std::vector<CityQuery>& queries) {
+    for (const CityQuery& query : queries) {
+        validateInput(query.k1, query.k2, query.L);
+    }
     
+    std::vector<std::vector<int>> answers(queries.size());
+    
+    // Запросы, решаемые по компонентам, отвечаются сразу. L приходит
+    // от клиентов сервера как есть и ограничивается до подсчета глубин
+    std::vector<CityQuery> pending;
+    std::vector<size_t> pendingPositions;
+    for (size_t q = 0; q < queries.size(); ++q) {
+        CityQuery query = queries[q];
+        query.L = boundedL(query.L);
+        if (!answerFromComponents(vertexOf(query.k1), vertexOf(query.k2), query.L, answers[q])) {
+            pending.push_back(query);
+            pendingPositions.push_back(q);
+        }
+    }
+    
+    std::vector<std::vector<int>> pendingAnswers = findCommonCitiesBySweeps(pending);
+    for (size_t i = 0; i < pending.size(); ++i) {
+        answers[pendingPositions[i]].swap(pendingAnswers[i]);
+    }
+    
+    return answers;
+}
+
+std::vector<std::vector<int>> GraphAnalyzer::findCommonCitiesBySweeps(const std::vector<CityQuery>& queries) {
+    std::vector<std::vector<int>> answers(queries.size());
+    
+    size_t begin = 0;
+    while (begin < queries.size()) {
+        // Набор источников прохода: одинаковые пары (город, глубина)
+        // занимают одну дорожку
+        std::vector<int> sources;
+        std::vector<int> maxDistances;
+        std::vector<std::pair<int, int>> lanes;  // дорожки K1 и K2 для каждого запроса
+        std::map<std::pair<int, int>, int> laneOf;
+        
+        size_t end = begin;
+        for (; end < queries.size(); ++end) {
+            const CityQuery& query = queries[end];
+            std::pair<int, int> key1(vertexOf(query.k1), query.L + 1);
+            std::pair<int, int> key2(vertexOf(query.k2), query.L + 1);
+            size_t needed = laneOf.count(key1) ? 0 : 1;
+            needed += laneOf.count(key2) ? 0 : 1;
+            if (sources.size() + needed > static_cast<size_t>(GraphUtils::kMaxSources)) {
+                break;
+            }
+            
+            int lane[2];
+            const std::pair<int, int>* keys[2] = {&key1, &key2};
+            for (int h = 0; h < 2; ++h) {
+                auto found = laneOf.find(*keys[h]);
+                if (found == laneOf.end()) {
+                    found = laneOf.insert(std::make_pair(*keys[h], static_cast<int>(sources.size()))).first;
+                    sources.push_back(keys[h]->first);
+                    maxDistances.push_back(keys[h]->second);
+                }
+                lane[h] = found->second;
+            }
+            lanes.push_back(std::make_pair(lane[0], lane[1]));
+        }
+        
+        PhaseTimer sweepTimer(diagnostics_.enabled(Verbosity::Summary));
+        MultiSourceBFSResult sweep = GraphUtils::multiSourceBFS(snapshot_->graph(), sources, maxDistances);
+        GRAF7_DIAG(diagnostics_, Verbosity::Summary,
+                   diagnostics_.sink().writeLine(
+                       "[ПАКЕТ] запросов=" + std::to_string(end - begin) +
+                       " источников=" + std::to_string(sources.size()) +
+                       " затронуто вершин=" + std::to_string(sweep.touched.size()) +
+                       " мкс=" + std::to_string(static_cast<long long>(
+                           sweepTimer.seconds() * 1e6))));
+        
+        // Общие города запроса - вершины с битами обеих дорожек,
+        // кроме самих штаб-квартир; touched уже отсортирован
+        for (int city : sweep.touched) {
+            for (size_t q = begin; q < end; ++q) {
+                const std::pair<int, int>& lane = lanes[q - begin];
+                if (sweep.reached(city, lane.first) && sweep.reached(city, lane.second) &&
+                    city != sources[lane.first] && city != sources[lane.second]) {
+                    answers[q].push_back(city);
+                }
+            }
+        }
+        
+        for (size_t q = begin; q < end; ++q) {
+            toCityNumbers(answers[q]);
+            if (answers[q].empty()) {
+                answers[q].push_back(-1);
+            }
+        }
+        begin = end;
+    }
+    
+    return answers;
+}
+
+void GraphAnalyzer::validateQuery(const CityQuery& query) const {
+    validateInput(query.k1, query.k2, query.L);
+}
+
+Diagnostics& GraphAnalyzer::diagnostics() {
+    return diagnostics_;
+}
+
+BFSTuning& GraphAnalyzer::traversalTuning() {
+    return tuning_;
+}
+
+void GraphAnalyzer::setReachabilityIndex(const ReachabilityIndex& index) {
+    if (index.levelCount() > 0 && index.vertexCount() != snapshot_->cityCount()) {
+        throw std::runtime_error("Индекс достижимости построен для другого графа");
+    }
+    reachIndex_ = index;
+}
+
+const ReachabilityIndex& GraphAnalyzer::reachabilityIndex() const {
+    return reachIndex_;
+}
+
+void GraphAnalyzer::setThreadCount(int threadCount) {
+    requestedThreads_ = threadCount;
+    pool_.reset(threadCount == 1 ? nullptr : new ThreadPool(threadCount));
+}
+
+int GraphAnalyzer::threadCount() const {
+    return pool_ ? pool_->size() : 1;
+}
+
+std::vector<int> GraphAnalyzer::findCommonCitiesWithin(int k1, int k2, std::int64_t budget) {
+    validateInput(k1, k2, 0);
+    if (budget < 0) {
+        throw std::runtime_error("Некорректный бюджет времени: " + std::to_string(budget));
+    }
+    
+    int start1 = vertexOf(k1);
+    int start2 = vertexOf(k2);
+    if (!snapshot_->components().connected(start1, start2)) {
+        return {-1};
+    }
+    
+    WeightedSearchResult fromK1 = GraphUtils::boundedDijkstra(snapshot_->graph(), start1, budget);
+    WeightedSearchResult fromK2 = GraphUtils::boundedDijkstra(snapshot_->graph(), start2, budget);
+    fromK1.reachable.reset(start1);
+    fromK2.reachable.reset(start2);
+    
+    std::vector<int> commonCities = GraphUtils::findIntersection(fromK1.reachable, fromK2.reachable);
+    toCityNumbers(commonCities);
+    if (commonCities.empty()) {
+        commonCities.push_back(-1);
+    }
     return commonCities;
 }
 
+CommonZoneProfile GraphAnalyzer::findCommonCitiesProfile(int k1, int k2, int maxL) {
+    validateInput(k1, k2, maxL);
+    
+    int start1 = vertexOf(k1);
+    int start2 = vertexOf(k2);
+    
+    QueryStats stats;
+    stats.k1 = k1;
+    stats.k2 = k2;
+    stats.L = maxL;
+    
+    // Один обход на штаб-квартиру до наибольшей глубины; расстояния
+    // не превышают cityCount - 1, так что глубже искать незачем
+    int maxDistance = maxL < snapshot_->cityCount() ? maxL + 1 : snapshot_->cityCount();
+    BFSResult fromK1 = runBreadthFirstSearch(start1, maxDistance, stats.fromK1);
+    BFSResult fromK2 = runBreadthFirstSearch(start2, maxDistance, stats.fromK2);
+    fromK1.reachable.reset(start1);
+    fromK2.reachable.reset(start2);
+    
+    PhaseTimer intersectTimer(diagnostics_.enabled(Verbosity::Summary));
+    std::vector<int> common = GraphUtils::findIntersection(fromK1.reachable, fromK2.reachable);
+    
+    // Уровни профиля - только до глубины, которой достигли обходы:
+    // порог города не больше max(d1, d2) - 1, дальше ответ не меняется
+    std::size_t reached = std::max(fromK1.frontierSizes.size(), fromK2.frontierSizes.size()) - 1;
+    std::size_t lastLevel = std::min(static_cast<std::size_t>(maxL), reached > 0 ? reached - 1 : 0);
+    
+    // Сортировка подсчетом по порогу; внутри порога города уже по возрастанию
+    CommonZoneProfile profile;
+    profile.maxL = maxL;
+    profile.levelEnd.assign(lastLevel + 1, 0);
+    for (int city : common) {
+        int threshold = std::max(fromK1.distances[city], fromK2.distances[city]) - 1;
+        ++profile.levelEnd[threshold];
+    }
+    
+    std::vector<std::size_t> cursor(profile.levelEnd.size(), 0);
+    std::size_t total = 0;
+    for (std::size_t L = 0; L < profile.levelEnd.size(); ++L) {
+        cursor[L] = total;
+        total += profile.levelEnd[L];
+        profile.levelEnd[L] = total;
+    }
+    
+    profile.cities.resize(total);
+    profile.thresholds.resize(total);
+    for (int city : common) {
+        int threshold = std::max(fromK1.distances[city], fromK2.distances[city]) - 1;
+        std::size_t position = cursor[threshold]++;
+        profile.cities[position] = snapshot_->order().toOriginal(city) + 1;
+        profile.thresholds[position] = threshold;
+    }
+    
+    // После перенумерации города внутри порога возвращаются к порядку номеров
+    if (!snapshot_->order().isIdentity()) {
+        std::size_t levelBegin = 0;
+        for (std::size_t L = 0; L < profile.levelEnd.size(); ++L) {
+            std::sort(profile.cities.begin() + levelBegin, profile.cities.begin() + profile.levelEnd[L]);
+            levelBegin = profile.levelEnd[L];
+        }
+    }
+    
+    GRAF7_DIAG(diagnostics_, Verbosity::Summary,
+               stats.intersectSeconds = intersectTimer.seconds();
+               stats.resultSize = total;
+               diagnostics_.reportQuery(stats));
+    
+    return profile;
+}
+
+BitMatrix GraphAnalyzer::neighborhoodMatrix(int L) {
+    if (!GraphUtils::isValidL(L)) {
+        throw std::runtime_error("Некорректное значение L: " + std::to_string(L));
+    }
+    
+    int n = snapshot_->cityCount();
+    BitMatrix neighborhoods(n, n);
+    if (reachIndex_.covers(L)) {
+        for (int v = 0; v < n; ++v) {
+            std::copy(reachIndex_.row(L, v), reachIndex_.row(L, v) + neighborhoods.wordsPerRow(),
+                      neighborhoods.row(v));
+        }
+        return toCityOrder(neighborhoods);
+    }
+    
+    // Каждый проход MS-BFS заполняет строки своих 256 источников
+    std::unique_ptr<ThreadPool> owned;
+    ThreadPool* pool = bulkPool(owned);
+    std::size_t sweeps = (static_cast<std::size_t>(n) + GraphUtils::kMaxSources - 1) /
+                         GraphUtils::kMaxSources;
+    auto runSweeps = [&](std::size_t begin, std::size_t end, int) {
+        for (std::size_t sweep = begin; sweep < end; ++sweep) {
+            int first = static_cast<int>(sweep) * GraphUtils::kMaxSources;
+            int last = std::min(n, first + GraphUtils::kMaxSources);
+            std::vector<int> sources;
+            for (int v = first; v < last; ++v) {
+                sources.push_back(v);
+            }
+            std::vector<int> maxDistances(sources.size(), boundedL(L) + 1);
+            MultiSourceBFSResult result = GraphUtils::multiSourceBFS(snapshot_->graph(), sources, maxDistances);
+            for (int city : result.touched) {
+                for (std::size_t lane = 0; lane < sources.size(); ++lane) {
+                    if (result.reached(city, static_cast<int>(lane))) {
+                        neighborhoods.set(sources[lane], city);
+                    }
+                }
+            }
+        }
+    };
+    
+    if (pool) {
+        pool->parallelFor(sweeps, 1, runSweeps);
+    } else {
+        runSweeps(0, sweeps, 0);
+    }
+    
+    return toCityOrder(neighborhoods);
+}
+
+void GraphAnalyzer::writeCommonZoneSizes(int L, const std::string& filename) {
+    BitMatrix neighborhoods = neighborhoodMatrix(L);
+    std::unique_ptr<ThreadPool> owned;
+    CommonZoneMatrix::write(neighborhoods, L, snapshot_->sourceChecksum(), filename, bulkPool(owned));
+}
+
+NeighborhoodEstimate GraphAnalyzer::estimateNeighborhoodSizes(int L, double relativeError) {
+    if (!GraphUtils::isValidL(L)) {
+        throw std::runtime_error("Некорректное значение L: " + std::to_string(L));
+    }
+    NeighborhoodEstimator estimator(snapshot_->graph(), relativeError);
+    std::unique_ptr<ThreadPool> owned;
+    NeighborhoodEstimate estimate = estimator.estimate(boundedL(L) + 1, bulkPool(owned));
+    
+    // Сам город в ответ не входит, как и в findCommonCities
+    const VertexPermutation& order = snapshot_->order();
+    std::vector<double> sizes(estimate.sizes.size());
+    for (std::size_t v = 0; v < sizes.size(); ++v) {
+        sizes[order.toOriginal(static_cast<int>(v))] = std::max(estimate.sizes[v] - 1.0, 0.0);
+    }
+    estimate.sizes.swap(sizes);
+    for (double& total : estimate.totals) {
+        total -= static_cast<double>(snapshot_->cityCount());
+    }
+    return estimate;
+}
+
 int GraphAnalyzer::getCityCount() const {
-    return cityCount_;
+    return snapshot_->cityCount();
+}
+
+bool GraphAnalyzer::usesDenseGraph() const {
+    return snapshot_->isDense();
+}
+
+bool GraphAnalyzer::isLargeGraph(const CSRGraph& graph) {
+    return graph.arcCount() >= kParallelMinArcs && std::thread::hardware_concurrency() > 1;
+}
+
+int GraphAnalyzer::boundedL(int L) const {
+    return std::min(L, snapshot_->cityCount() - 1);
 }
 
-std::set<int> GraphAnalyzer::findReachableCities(int startCity, int maxDistance) {
-    BFSResult result = GraphUtils::breadthFirstSearch(graph_, startCity, maxDistance);
-    return result.reachable;
+bool GraphAnalyzer::answerFromComponents(int start1, int start2, int L, std::vector<int>& answer) const {
+    const ComponentIndex& components = snapshot_->components();
+    if (!components.connected(start1, start2)) {
+        answer.assign(1, -1);
+        return true;
+    }
+    
+    // Оценки эксцентриситетов не учитывают направление дуг
+    int maxDistance = L + 1;
+    if (snapshot_->isDirected() ||
+        maxDistance < components.eccentricityBound(start1) ||
+        maxDistance < components.eccentricityBound(start2)) {
+        return false;
+    }
+    
+    // Обе зоны влияния - вся компонента
+    int component = components.componentOf(start1);
+    answer.clear();
+    for (const int* it = components.membersBegin(component); it != components.membersEnd(component); ++it) {
+        if (*it != start1 && *it != start2) {
+            answer.push_back(*it);
+        }
+    }
+    toCityNumbers(answer);
+    if (answer.empty()) {
+        answer.push_back(-1);
+    }
+    return true;
+}
+
+ThreadPool* GraphAnalyzer::bulkPool(std::unique_ptr<ThreadPool>& owned) {
+    if (pool_ || requestedThreads_ == 1) {
+        return pool_.get();
+    }
+    owned.reset(new ThreadPool(std::max(requestedThreads_, 0)));
+    return owned.get();
+}
+
+DenseBitset GraphAnalyzer::findReachableCities(int startCity, int maxDistance, TraversalStats& stats,
+                                               bool againstArcs) {
+    return std::move(runBreadthFirstSearch(startCity, maxDistance, stats, againstArcs).reachable);
+}
+
+BFSResult GraphAnalyzer::runBreadthFirstSearch(int startCity, int maxDistance, TraversalStats& stats,
+                                               bool againstArcs) {
+    // Обход против дуг - тот же BFS по графу входящих дуг,
+    // а исходящие дуги служат ему родителями при обходе снизу вверх.
+    // Сжатый снимок не хранит CSR, плотного графа при сжатии не бывает
+    PhaseTimer timer(diagnostics_.enabled(Verbosity::Summary));
+    BFSResult result;
+    if (snapshot_->isCompressed()) {
+        const CompressedGraph& compressed = againstArcs ? snapshot_->compressedReverse() : snapshot_->compressed();
+        const CompressedGraph* compressedInbound = nullptr;
+        if (snapshot_->isDirected()) {
+            compressedInbound = againstArcs ? &snapshot_->compressed() : &snapshot_->compressedReverse();
+        }
+        result = GraphUtils::breadthFirstSearch(compressed, startCity, maxDistance, tuning_, compressedInbound);
+    } else if (snapshot_->isDense() && !againstArcs) {
+        result = GraphUtils::breadthFirstSearch(snapshot_->denseGraph(), startCity, maxDistance);
+    } else {
+        const CSRGraph& graph = againstArcs ? snapshot_->reverse() : snapshot_->graph();
+        const CSRGraph* inbound = nullptr;
+        if (snapshot_->isDirected()) {
+            inbound = againstArcs ? &snapshot_->graph() : &snapshot_->reverse();
+        }
+        if (pool_) {
+            result = GraphUtils::parallelBreadthFirstSearch(graph, startCity, maxDistance, *pool_, tuning_, inbound);
+        } else {
+            result = GraphUtils::breadthFirstSearch(graph, startCity, maxDistance, tuning_, inbound);
+        }
+    }
+    
+    GRAF7_DIAG(diagnostics_, Verbosity::Summary,
+               stats.seconds = timer.seconds();
+               stats.edgesScanned = result.edgesScanned;
+               stats.frontierSizes = result.frontierSizes;
+               stats.bottomUpLevels = result.bottomUpLevels);
+    
+    return result;
+}
+
+int GraphAnalyzer::vertexOf(int city) const {
+    return snapshot_->order().toInternal(city - 1);
+}
+
+void GraphAnalyzer::toCityNumbers(std::vector<int>& vertices) const {
+    const VertexPermutation& order = snapshot_->order();
+    for (int& city : vertices) {
+        city = order.toOriginal(city) + 1;
+    }
+    if (!order.isIdentity()) {
+        std::sort(vertices.begin(), vertices.end());
+    }
+}
+
+BitMatrix GraphAnalyzer::toCityOrder(const BitMatrix& neighborhoods) const {
+    const VertexPermutation& order = snapshot_->order();
+    if (order.isIdentity()) {
+        return neighborhoods;
+    }
+    
+    // Строки и столбцы переставляются по установленным битам
+    BitMatrix cities(neighborhoods.rowCount(), neighborhoods.columnCount());
+    for (int r = 0; r < neighborhoods.rowCount(); ++r) {
+        const std::uint64_t* row = neighborhoods.row(r);
+        int city = order.toOriginal(r);
+        for (std::size_t w = 0; w < neighborhoods.wordsPerRow(); ++w) {
+            for (std::uint64_t bits = row[w]; bits != 0; bits &= bits - 1) {
+                int column = static_cast<int>(w * 64) + __builtin_ctzll(bits);
+                cities.set(city, order.toOriginal(column));
+            }
+        }
+    }
+    return cities;
 }
 
 void GraphAnalyzer::validateInput(int k1, int k2, int L) const {
-    if (!GraphUtils::isValidCity(k1, cityCount_)) {
+    if (!GraphUtils::isValidCity(k1, snapshot_->cityCount())) {
         throw std::runtime_error("Некорректный номер города K1: " + std::to_string(k1));
     }
     
-    if (!GraphUtils::isValidCity(k2, cityCount_)) {
+    if (!GraphUtils::isValidCity(k2, snapshot_->cityCount())) {
         throw std::runtime_error("Некорректный номер города K2: " + std::to_string(k2));
     }
     
@@ -115,4 +649,18 @@ void GraphAnalyzer::validateInput(int k1, int k2, int L) const {
     if (k1 == k2) {
         throw std::runtime_error("K1 и K2 не могут быть одинаковыми");
     }
-}
\ No newline at end of file
+}
+std::vector<int> CommonZoneProfile::citiesFor(int L) const {
+    if (L < 0 || L > maxL) {
+        throw std::runtime_error("L вне диапазона профиля: " + std::to_string(L));
+    }
+    
+    std::size_t end = levelEnd[std::min(static_cast<std::size_t>(L), levelEnd.size() - 1)];
+    if (end == 0) {
+        return {-1};
+    }
+    
+    std::vector<int> result(cities.begin(), cities.begin() + end);
+    std::sort(result.begin(), result.end());
+    return result;
+}
@@ -1,39 +1,150 @@
 /**
  * @file graph_analyzer.h
  * @brief Анализатор графа для поиска общих городов
- * @version 2.0
+ * @version 3.0
  * 
- * Класс для поиска городов, достижимых из двух штаб-квартир
+ * Класс для поиска городов, достижимых из двух и более штаб-квартир
  */
 
 #ifndef GRAPH_ANALYZER_H
 #define GRAPH_ANALYZER_H
 
+#include "diagnostics.h"
+#include "graph_snapshot.h"
 #include "graph_utils.h"
+#include "neighborhood_estimator.h"
+#include "reachability_index.h"
+#include "thread_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <vector>
 
+/**
+ * @struct CityQuery
+ * @brief Запрос на поиск общих городов
+ */
+struct CityQuery {
+    int k1;  ///< Первая штаб-квартира (1..cityCount)
+    int k2;  ///< Вторая штаб-квартира (1..cityCount)
+    int L;   ///< Максимальное количество промежуточных городов
+};
+
+/**
+ * @enum ReachMode
+ * @brief Направление достижимости для ориентированного графа
+ * 
+ * У неориентированного графа все режимы дают один ответ
+ */
+enum class ReachMode {
+    FromBoth,  ///< Города, достижимые из K1 и из K2
+    ToBoth,    ///< Города, из которых достижимы K1 и K2
+    Mixed      ///< Города, достижимые из K1, из которых достижим K2
+};
+
+/**
+ * @struct CommonZoneProfile
+ * @brief Общие города для всех L от 0 до maxL
+ * 
+ * Город становится общим при L = max(d1, d2) - 1, где d1, d2 -
+ * расстояния в ребрах от штаб-квартир, и остается общим при больших L.
+ * Записи упорядочены по порогу, при равном пороге - по номеру города.
+ * Уровни хранятся только до глубины, которой достигли обходы: при
+ * больших L ответ совпадает с последним уровнем.
+ */
+struct CommonZoneProfile {
+    std::vector<int> cities;            ///< Номера городов (1-based)
+    std::vector<int> thresholds;        ///< Минимальное L, при котором город общий
+    std::vector<std::size_t> levelEnd;  ///< levelEnd[L] - число записей с порогом ≤ L (не больше maxL + 1 уровней)
+    int maxL = 0;                       ///< Наибольшее L запроса
+    
+    /**
+     * @brief Последнее L, на котором ответ еще меняется
+     * @return int При L от lastLevel() до maxL ответ тот же
+     */
+    int lastLevel() const { return static_cast<int>(levelEnd.size()) - 1; }
+    
+    /**
+     * @brief Ответ findCommonCities для конкретного L
+     * @param L Количество промежуточных городов (0..maxL)
+     * @return std::vector<int> Отсортированные номера городов или {-1}
+     * @throws std::runtime_error если L вне 0..maxL
+     */
+    std::vector<int> citiesFor(int L) const;
+};
+
 /**
  * @class GraphAnalyzer
  * @brief Анализатор пересекающихся зон влияния
  * 
  * Находит города, достижимые из двух штаб-квартир
- * с ограничением по количеству промежуточных городов
+ * с ограничением по количеству промежуточных городов.
+ * Граф и построенные по нему индексы берутся из разделяемого снимка
+ * (GraphSnapshot). Сам анализатор не потокобезопасен: каждый поток
+ * создает свой анализатор над общим снимком.
+ * Если вершины снимка перенумерованы, номера городов переводятся
+ * во внутренние на входе и обратно на выходе; индекс достижимости
+ * строится по графу снимка.
  */
 class GraphAnalyzer {
 private:
-    AdjacencyMatrix graph_;
-    int cityCount_;
+    std::shared_ptr<const GraphSnapshot> snapshot_;  ///< Текущая версия графа
+    Diagnostics diagnostics_;  ///< Уровень и приемник диагностики (по умолчанию молчит)
+    BFSTuning tuning_;         ///< Переключение направления BFS по CSR
+    std::unique_ptr<ThreadPool> pool_;  ///< Пул для многопоточного BFS (только для больших графов)
+    ReachabilityIndex reachIndex_;      ///< Готовые строки R_{L+1} (по умолчанию пуст)
+    int requestedThreads_;              ///< Значение setThreadCount (-1 - не задано)
     
 public:
+    /**
+     * @brief Минимальное количество дуг для многопоточного BFS
+     */
+    static const std::int64_t kParallelMinArcs = 1 << 20;
+    
     /**
      * @brief Конструктор
-     * @param graph Матрица смежности
+     * 
+     * Строит собственный снимок графа (GraphSnapshot::create): для
+     * плотных графов BFS выполняется бит-параллельно по битовой матрице.
+     * Для больших разреженных графов (от kParallelMinArcs дуг) создается
+     * пул потоков по числу аппаратных потоков, и BFS выполняется многопоточно
+     * @param graph Граф в формате CSR
      * @param cityCount Количество городов
      */
-    GraphAnalyzer(const AdjacencyMatrix& graph, int cityCount);
+    GraphAnalyzer(const CSRGraph& graph, int cityCount);
+    
+    /**
+     * @brief Конструктор над готовым снимком
+     * 
+     * Ничего не копирует и не строит, кроме пула потоков для больших графов
+     * @param snapshot Снимок (например, SnapshotStore::current())
+     * @throws std::runtime_error если снимок пуст
+     */
+    explicit GraphAnalyzer(std::shared_ptr<const GraphSnapshot> snapshot);
+    
+    /**
+     * @brief Переход на другую версию графа
+     * 
+     * Индекс достижимости отключается, если версия другая. Пул потоков
+     * выбирается заново, если setThreadCount не вызывался
+     * @param snapshot Новый снимок
+     * @throws std::runtime_error если снимок пуст
+     */
+    void setSnapshot(std::shared_ptr<const GraphSnapshot> snapshot);
+    
+    /**
+     * @brief Текущий снимок графа
+     * @return const std::shared_ptr<const GraphSnapshot>& Снимок
+     */
+    const std::shared_ptr<const GraphSnapshot>& snapshot() const;
     
     /**
      * @brief Поиск общих городов для двух штаб-квартир
+     * 
+     * Без обхода графа: штаб-квартиры в разных компонентах - {-1} за O(1);
+     * L + 1 не меньше оценки эксцентриситета обеих - вся компонента без
+     * штаб-квартир; индекс достижимости покрывает L - AND двух его строк
      * @param k1 Первая штаб-квартира (1..cityCount)
      * @param k2 Вторая штаб-квартира (1..cityCount)
      * @param L Максимальное количество промежуточных городов
@@ -42,20 +153,256 @@ public:
      */
     std::vector<int> findCommonCities(int k1, int k2, int L);
     
+    /**
+     * @brief Поиск общих городов с учетом направления дорог
+     * 
+     * Обход против дуг идет по графу входящих дуг снимка (строится при
+     * загрузке), поэтому стоит столько же, сколько обычный BFS.
+     * Индекс достижимости используется только в режиме FromBoth
+     * @param k1 Первая штаб-квартира (1..cityCount)
+     * @param k2 Вторая штаб-квартира (1..cityCount)
+     * @param L Максимальное количество промежуточных городов
+     * @param mode Направление достижимости
+     * @return std::vector<int> Номера общих городов или {-1} если нет общих
+     * @throws std::runtime_error при некорректных параметрах
+     */
+    std::vector<int> findCommonCities(int k1, int k2, int L, ReachMode mode);
+    
+    /**
+     * @brief Поиск городов, достижимых из каждой из нескольких штаб-квартир
+     * 
+     * Один проход MS-BFS с маской штаб-квартир у каждого города вместо
+     * попарных обходов и пересечений; проход прерывается, как только
+     * ни один город уже не может быть достигнут из всех
+     * (GraphUtils::commonReach). Без обхода, как и для двух штаб-квартир:
+     * разные компоненты - {-1}, L + 1 не меньше оценок эксцентриситетов
+     * всех - вся компонента; индекс достижимости, покрывающий L, - AND строк.
+     * У ориентированного графа - города, достижимые по дугам из всех
+     * @param headquarters Штаб-квартиры (1..cityCount, от 2 до 64 без повторов)
+     * @param L Максимальное количество промежуточных городов
+     * @return std::vector<int> Номера общих городов (без штаб-квартир) или {-1}
+     * @throws std::runtime_error при некорректных параметрах
+     */
+    std::vector<int> findCommonCities(const std::vector<int>& headquarters, int L);
+    
+    /**
+     * @brief Поиск общих городов с бюджетом времени в пути
+     * 
+     * Города, до которых из обеих штаб-квартир можно доехать не дольше
+     * budget (веса ребер - время в пути; у невзвешенного графа каждое
+     * ребро стоит 1, и budget = L + 1 дает ответ findCommonCities).
+     * Две Дейкстры с бюджетом (GraphUtils::boundedDijkstra)
+     * @param k1 Первая штаб-квартира (1..cityCount)
+     * @param k2 Вторая штаб-квартира (1..cityCount)
+     * @param budget Максимальное время в пути (≥ 0)
+     * @return std::vector<int> Номера общих городов или {-1} если нет общих
+     * @throws std::runtime_error при некорректных параметрах
+     */
+    std::vector<int> findCommonCitiesWithin(int k1, int k2, std::int64_t budget);
+    
+    /**
+     * @brief Пакетный поиск общих городов для многих запросов
+     * 
+     * Все штаб-квартиры пакета обходятся одновременно (MS-BFS):
+     * до 128 запросов (256 источников) на один проход по ребрам.
+     * Запросы, на которые отвечает индекс компонент, в проход не попадают
+     * @param queries Запросы
+     * @return std::vector<std::vector<int>> Ответы в порядке запросов,
+     *         каждый - как у findCommonCities
+     * @throws std::runtime_error если хотя бы один запрос некорректен
+     */
+    std::vector<std::vector<int>> findCommonCitiesBatch(const std::vector<CityQuery>& queries);
+    
+    /**
+     * @brief Общие города сразу для всех L от 0 до maxL
+     * 
+     * Один BFS глубины maxL + 1 из каждой штаб-квартиры вместо
+     * двух обходов на каждое значение L
+     * @param k1 Первая штаб-квартира (1..cityCount)
+     * @param k2 Вторая штаб-квартира (1..cityCount)
+     * @param maxL Наибольшее значение L
+     * @return CommonZoneProfile Города с порогами появления
+     * @throws std::runtime_error при некорректных параметрах
+     */
+    CommonZoneProfile findCommonCitiesProfile(int k1, int k2, int maxL);
+    
+    /**
+     * @brief Окрестности всех городов
+     * 
+     * Строка v - города в пределах L + 1 ребер от v, включая сам v.
+     * Берется из индекса достижимости, если он покрывает L, иначе
+     * строится проходами MS-BFS по 256 источников, распределенными
+     * по потокам
+     * @param L Количество промежуточных городов
+     * @return BitMatrix Матрица n × n
+     * @throws std::runtime_error при некорректном L
+     */
+    BitMatrix neighborhoodMatrix(int L);
+    
+    /**
+     * @brief Размеры общих зон для всех пар городов в двоичный файл
+     * 
+     * Формат файла описан в CommonZoneMatrix
+     * @param L Количество промежуточных городов
+     * @param filename Имя файла
+     * @throws std::runtime_error при некорректном L или ошибке записи
+     */
+    void writeCommonZoneSizes(int L, const std::string& filename);
+    
+    /**
+     * @brief Приближенное число городов в пределах L промежуточных от каждого города
+     * 
+     * HyperANF (NeighborhoodEstimator): L + 1 раундов объединения
+     * счетчиков HyperLogLog вдоль дуг, распределенных по потокам.
+     * У ориентированного графа - города, достижимые из данного
+     * @param L Количество промежуточных городов
+     * @param relativeError Допустимая относительная погрешность оценки (0 < e < 1)
+     * @return NeighborhoodEstimate sizes[city - 1] - оценка для города без него самого,
+     *         totals - суммы оценок по раундам (без самих городов)
+     * @throws std::runtime_error при некорректных L или погрешности
+     */
+    NeighborhoodEstimate estimateNeighborhoodSizes(int L, double relativeError);
+    
+    /**
+     * @brief Проверка корректности запроса
+     * @param query Запрос
+     * @throws std::runtime_error с описанием ошибки, если запрос некорректен
+     */
+    void validateQuery(const CityQuery& query) const;
+    
+    /**
+     * @brief Диагностика запросов
+     * 
+     * Уровень задается через diagnostics().setVerbosity(), сообщения
+     * по умолчанию идут в std::cerr (см. DiagnosticsSink::redirect)
+     * @return Diagnostics& Настройки диагностики
+     */
+    Diagnostics& diagnostics();
+    
+    /**
+     * @brief Параметры переключения направления BFS по CSR
+     * @return BFSTuning& Изменяемые параметры (действуют на следующие запросы)
+     */
+    BFSTuning& traversalTuning();
+    
+    /**
+     * @brief Подключение индекса достижимости
+     * @param index Индекс, построенный по графу снимка (пустой - отключить)
+     * @throws std::runtime_error если индекс построен для другого числа вершин
+     */
+    void setReachabilityIndex(const ReachabilityIndex& index);
+    
+    /**
+     * @brief Подключенный индекс достижимости
+     * @return const ReachabilityIndex& Индекс (пустой, если не подключен)
+     */
+    const ReachabilityIndex& reachabilityIndex() const;
+    
+    /**
+     * @brief Установка количества потоков BFS по CSR
+     * 
+     * Заменяет выбор по размеру графа
+     * @param threadCount Количество потоков (0 - по числу аппаратных, 1 - без пула)
+     */
+    void setThreadCount(int threadCount);
+    
+    /**
+     * @brief Количество потоков BFS по CSR
+     * @return int 1 если обход последовательный
+     */
+    int threadCount() const;
+    
     /**
      * @brief Получение количества городов
      * @return int Количество городов
      */
     int getCityCount() const;
+    
+    /**
+     * @brief Используется ли бит-параллельный BFS по битовой матрице
+     * @return true если граф признан плотным
+     */
+    bool usesDenseGraph() const;
 
 private:
+    /**
+     * @brief Пакетный поиск проходами MS-BFS (запросы уже проверены)
+     * @param queries Запросы
+     * @return std::vector<std::vector<int>> Ответы в порядке запросов
+     */
+    std::vector<std::vector<int>> findCommonCitiesBySweeps(const std::vector<CityQuery>& queries);
+    
+    /**
+     * @brief Ответ по индексу компонент без обхода графа
+     * @param start1 Первая штаб-квартира (0-based)
+     * @param start2 Вторая штаб-квартира (0-based)
+     * @param L Максимальное количество промежуточных городов
+     * @param[out] answer Ответ в формате findCommonCities
+     * @return true если ответ найден (разные компоненты или L покрывает компоненту)
+     */
+    bool answerFromComponents(int start1, int start2, int L, std::vector<int>& answer) const;
+    
+    /**
+     * @brief Выгоден ли многопоточный BFS для графа
+     * @param graph Граф в формате CSR
+     * @return true если дуг не меньше kParallelMinArcs и есть больше одного ядра
+     */
+    static bool isLargeGraph(const CSRGraph& graph);
+    
+    /**
+     * @brief Пул для массовых вычислений по всем городам
+     * 
+     * Пул анализатора, если он есть; иначе временный пул по числу
+     * аппаратных потоков, если setThreadCount(1) не вызывался
+     * @param[out] owned Владелец временного пула
+     * @return ThreadPool* Пул или nullptr для вычисления в одном потоке
+     */
+    ThreadPool* bulkPool(std::unique_ptr<ThreadPool>& owned);
+    
     /**
      * @brief Поиск достижимых городов из заданной точки
      * @param startCity Стартовый город (0-based)
      * @param maxIntermediates Максимальное количество промежуточных городов
-     * @return std::set<int> Множество достижимых городов (0-based)
+     * @param[out] stats Статистика обхода (заполняется при включенной диагностике)
+     * @param againstArcs true - города, из которых достижим startCity
+     * @return DenseBitset Множество достижимых городов (0-based)
+     */
+    DenseBitset findReachableCities(int startCity, int maxIntermediates, TraversalStats& stats,
+                                    bool againstArcs = false);
+    
+    /**
+     * @brief BFS по подходящему представлению графа
+     * 
+     * Битовая матрица, BFS по сжатым спискам (если снимок сжат),
+     * многопоточный BFS по CSR (если есть пул) или последовательный BFS по CSR
+     * @param startCity Стартовый город (0-based)
+     * @param maxDistance Максимальное расстояние в ребрах
+     * @param[out] stats Статистика обхода (заполняется при включенной диагностике)
+     * @param againstArcs true - обход по входящим дугам (ориентированный граф)
+     * @return BFSResult Расстояния и достижимые города
+     */
+    BFSResult runBreadthFirstSearch(int startCity, int maxDistance, TraversalStats& stats,
+                                    bool againstArcs = false);
+    
+    /**
+     * @brief Вершина снимка для города
+     * @param city Номер города (1-based, исходная нумерация)
+     * @return int Вершина во внутренней нумерации (0-based)
      */
-    std::set<int> findReachableCities(int startCity, int maxIntermediates);
+    int vertexOf(int city) const;
+    
+    /**
+     * @brief Перевод вершин снимка в номера городов
+     * @param[in,out] vertices Вершины (0-based); на выходе - номера городов (1-based) по возрастанию
+     */
+    void toCityNumbers(std::vector<int>& vertices) const;
+    
+    /**
+     * @brief Матрица окрестностей в исходной нумерации городов
+     * @param neighborhoods Матрица во внутренней нумерации
+     * @return BitMatrix Матрица с переставленными строками и столбцами
+     */
+    BitMatrix toCityOrder(const BitMatrix& neighborhoods) const;
     
     /**
      * @brief Валидация входных параметров
@@ -64,6 +411,16 @@ private:
      * @param L Максимальное количество промежуточных городов
      */
     void validateInput(int k1, int k2, int L) const;
+    
+    /**
+     * @brief Ограничение L числом городов
+     * 
+     * Расстояния не превышают cityCount - 1, так что при больших L
+     * ответ тот же, а глубина L + 1 не переполняет int
+     * @param L Максимальное количество промежуточных городов (≥ 0)
+     * @return int min(L, cityCount - 1)
+     */
+    int boundedL(int L) const;
 };
 
 #endif // GRAPH_ANALYZER_H
\ No newline at end of file
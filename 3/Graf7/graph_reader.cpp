@@ -1,80 +1,681 @@
 /**
  * @file graph_reader.cpp
  * @brief Реализация чтения графа из файла
- * @version 2.0
+ * @version 3.5
  */
 
 #include "graph_reader.h"
+#include "external_io.h"
+#include "mapped_file.h"
+#include "text_scanner.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
-#include <sstream>
+#include <limits>
 #include <stdexcept>
 #include <string>  // Добавлен этот заголовок
+#include <utility>
+#include <vector>
 
-AdjacencyMatrix GraphReader::readFromFile(const std::string& filename, int& cityCount) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Не удалось открыть файл: " + filename);
+const std::int64_t GraphReader::kMaxCityCount = std::numeric_limits<int>::max();
+const std::int64_t GraphReader::kMaxWeight = std::numeric_limits<std::uint32_t>::max();
+
+namespace {
+    const char kSnapshotMagic[8] = {'G', 'R', 'A', 'F', '7', 'C', 'S', 'R'};
+    const std::uint32_t kSnapshotVersion = 2;       ///< 2 - добавлены веса дуг
+    const std::uint32_t kWeightedFlag = 1;          ///< flags: после соседей лежат веса
+    const std::uint32_t kDirectedFlag = 2;          ///< flags: граф ориентированный
+    
+    /**
+     * @struct SnapshotHeader
+     * @brief Заголовок двоичного снимка (64 байта)
+     */
+    struct SnapshotHeader {
+        char magic[8];              ///< Сигнатура "GRAF7CSR"
+        std::uint32_t version;      ///< Версия формата
+        std::uint32_t flags;        ///< kWeightedFlag | kDirectedFlag
+        std::uint64_t vertexCount;  ///< Количество вершин
+        std::uint64_t arcCount;     ///< Длина массива соседей
+        std::uint64_t offsetsPos;   ///< Позиция массива смещений
+        std::uint64_t neighborsPos; ///< Позиция массива соседей
+        std::uint64_t checksum;     ///< CSRGraph::checksum()
+        std::uint64_t weightsPos;   ///< Позиция массива весов uint32 (0 - без весов; в версии 1 всегда 0)
+    };
+    
+    static_assert(sizeof(SnapshotHeader) == 64, "Заголовок снимка должен занимать 64 байта");
+    
+    /**
+     * @struct SnapshotArc
+     * @brief Дуга при внешней сортировке (по источнику, соседу, весу)
+     */
+    struct SnapshotArc {
+        int source;
+        int target;
+        std::uint32_t weight;
+        
+        bool operator<(const SnapshotArc& other) const {
+            if (source != other.source) {
+                return source < other.source;
+            }
+            if (target != other.target) {
+                return target < other.target;
+            }
+            return weight < other.weight;
+        }
+        
+        bool operator==(const SnapshotArc& other) const {
+            return source == other.source && target == other.target && weight == other.weight;
+        }
+    };
+    
+    /**
+     * @brief Проверка заголовка снимка против размера файла
+     * @param header Заголовок
+     * @param fileSize Размер файла
+     * @param filename Имя файла для сообщений об ошибках
+     * @param allowDirected false - ориентированный снимок считается ошибкой
+     * @return bool true если в снимке есть веса
+     * @throws std::runtime_error если заголовок некорректен
+     */
+    bool checkSnapshotHeader(const SnapshotHeader& header, std::uint64_t fileSize,
+                             const std::string& filename, bool allowDirected) {
+        if (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+            throw std::runtime_error("Файл не является снимком графа: " + filename);
+        }
+        if (header.version != kSnapshotVersion && header.version != 1) {
+            throw std::runtime_error("Неподдерживаемая версия снимка: " +
+                                     std::to_string(header.version));
+        }
+        if (!allowDirected && header.version >= 2 && (header.flags & kDirectedFlag) != 0) {
+            throw std::runtime_error("Снимок содержит ориентированный граф (нужен --directed): " + filename);
+        }
+        if (header.vertexCount < 1 || header.vertexCount > static_cast<std::uint64_t>(GraphReader::kMaxCityCount)) {
+            throw std::runtime_error("Некорректное количество городов в снимке: " +
+                                     std::to_string(header.vertexCount));
+        }
+        
+        std::uint64_t offsetsBytes = sizeof(std::int64_t) * (header.vertexCount + 1);
+        std::uint64_t neighborsBytes = sizeof(int) * header.arcCount;
+        bool weighted = header.version >= 2 && (header.flags & kWeightedFlag) != 0;
+        std::uint64_t end = header.neighborsPos + neighborsBytes;
+        if (weighted) {
+            if (header.weightsPos != end) {
+                throw std::runtime_error("Размер снимка не совпадает с заголовком: " + filename);
+            }
+            end += sizeof(std::uint32_t) * header.arcCount;
+        }
+        if (header.offsetsPos != sizeof(SnapshotHeader) ||
+            header.neighborsPos != header.offsetsPos + offsetsBytes ||
+            end != fileSize) {
+            throw std::runtime_error("Размер снимка не совпадает с заголовком: " + filename);
+        }
+        return weighted;
+    }
+}
+
+CSRGraph GraphReader::readFromFile(const std::string& filename, int& cityCount, LoadStats* stats,
+                                   bool verifyChecksum) {
+    return readGraph(filename, cityCount, stats, false, verifyChecksum);
+}
+
+DirectedGraph GraphReader::readDirectedFromFile(const std::string& filename, int& cityCount,
+                                                LoadStats* stats, bool verifyChecksum) {
+    auto startTime = std::chrono::steady_clock::now();
+    DirectedGraph graph;
+    graph.forward = readGraph(filename, cityCount, stats, true, verifyChecksum);
+    graph.reverse = graph.forward.transposed();
+    if (stats != nullptr) {
+        stats->seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - startTime).count();
+    }
+    return graph;
+}
+
+CSRGraph GraphReader::readGraph(const std::string& filename, int& cityCount, LoadStats* stats,
+                                bool directed, bool verifyChecksum) {
+    auto startTime = std::chrono::steady_clock::now();
+    
+    std::shared_ptr<MappedFile> mapped = std::make_shared<MappedFile>(filename);
+    const MappedFile& file = *mapped;
+    
+    // Двоичный снимок: отображение без разбора; полная контрольная сумма -
+    // проход по всем массивам, поэтому только по запросу
+    if (file.size() >= sizeof(kSnapshotMagic) &&
+        std::memcmp(file.data(), kSnapshotMagic, sizeof(kSnapshotMagic)) == 0) {
+        CSRGraph graph = graphFromSnapshot(mapped, filename, verifyChecksum, directed);
+        cityCount = graph.vertexCount();
+        if (stats != nullptr) {
+            stats->bytes = file.size();
+            stats->seconds = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - startTime).count();
+        }
+        return graph;
     }
     
-    // Чтение количества городов
-    file >> cityCount;
+    TextScanner scanner(file.data(), file.data() + file.size());
+    std::int64_t edgeCount = -1;
+    bool isEdgeList = readTextHeader(scanner, cityCount, edgeCount);
     
-    if (!isValidCityCount(cityCount)) {
-        throw std::runtime_error("Некорректное количество городов: " + std::to_string(cityCount));
+    // Значения и симметричность проверяются во время разбора,
+    // отдельный проход validateGraph не нужен
+    CSRGraph graph = isEdgeList ? readEdgeListBody(scanner, cityCount, edgeCount, directed)
+                                : readMatrixBody(scanner, cityCount, directed);
+    
+    if (stats != nullptr) {
+        stats->bytes = file.size();
+        stats->seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - startTime).count();
     }
     
-    // Чтение матрицы смежности
-    AdjacencyMatrix matrix(cityCount, std::vector<int>(cityCount));
+    return graph;
+}
+
+CompressedGraph GraphReader::readCompressedFromFile(const std::string& filename, int& cityCount, LoadStats* stats,
+                                                    bool directed, bool verifyChecksum) {
+    auto startTime = std::chrono::steady_clock::now();
+    
+    std::shared_ptr<MappedFile> mapped = std::make_shared<MappedFile>(filename);
+    const MappedFile& file = *mapped;
+    
+    // Снимок сжимается построчно прямо из отображения; матрица
+    // смежности занимает в тексте больше, чем ее CSR, и читается в CSR
+    CompressedGraph graph;
+    if (file.size() >= sizeof(kSnapshotMagic) &&
+        std::memcmp(file.data(), kSnapshotMagic, sizeof(kSnapshotMagic)) == 0) {
+        graph = CompressedGraph::fromCSR(graphFromSnapshot(mapped, filename, verifyChecksum, directed));
+    } else {
+        TextScanner scanner(file.data(), file.data() + file.size());
+        std::int64_t edgeCount = -1;
+        graph = readTextHeader(scanner, cityCount, edgeCount)
+            ? readCompressedEdgeListBody(scanner, cityCount, edgeCount, directed)
+            : CompressedGraph::fromCSR(readMatrixBody(scanner, cityCount, directed));
+    }
+    cityCount = graph.vertexCount();
+    
+    if (stats != nullptr) {
+        stats->bytes = file.size();
+        stats->seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - startTime).count();
+    }
+    
+    return graph;
+}
+
+bool GraphReader::readTextHeader(TextScanner& scanner, int& cityCount, std::int64_t& edgeCount) {
+    // Заголовок: "n" (матрица) или "n m" (список ребер)
+    std::int64_t count = 0;
+    if (!scanner.nextOnLine(count)) {
+        throw std::runtime_error("Ошибка чтения количества городов");
+    }
+    bool isEdgeList = scanner.nextOnLine(edgeCount);
+    scanner.skipLine();
+    
+    if (!isValidCityCount(count)) {
+        throw std::runtime_error("Некорректное количество городов: " + std::to_string(count));
+    }
+    cityCount = static_cast<int>(count);
+    return isEdgeList;
+}
+
+CSRGraph GraphReader::readMatrixBody(TextScanner& scanner, int cityCount, bool directed) {
+    // Чтение матрицы смежности построчно сразу в CSR
+    std::vector<std::int64_t> offsets(static_cast<size_t>(cityCount) + 1, 0);
+    std::vector<int> neighbors;
+    std::vector<std::uint32_t> weights;
+    bool weighted = false;
+    
+    // cursor[j] - первый еще не сверенный сосед j, больший j.
+    // Ячейка (i, j) при j < i сверяется с уже прочитанной (j, i)
+    std::vector<std::int64_t> cursor(static_cast<size_t>(cityCount), 0);
     
     for (int i = 0; i < cityCount; ++i) {
         for (int j = 0; j < cityCount; ++j) {
-            if (!(file >> matrix[i][j])) {
+            std::int64_t value;
+            if (!scanner.next(value)) {
                 throw std::runtime_error("Ошибка чтения матрицы смежности");
             }
             
-            if (!isValidMatrixValue(matrix[i][j])) {
+            if (!isValidMatrixValue(value)) {
                 throw std::runtime_error("Некорректное значение в матрице: " + 
-                                       std::to_string(matrix[i][j]));
+                                       std::to_string(value));
+            }
+            
+            if (j < i && !directed) {
+                bool mirrored = cursor[j] < offsets[j + 1] && neighbors[cursor[j]] == i;
+                if (mirrored != (value != 0) || (mirrored && weights[cursor[j]] != value)) {
+                    throw std::runtime_error("Матрица смежности не симметрична: (" +
+                                             std::to_string(i + 1) + ", " +
+                                             std::to_string(j + 1) + ")");
+                }
+                cursor[j] += mirrored;
+            }
+            
+            if (value != 0) {
+                neighbors.push_back(j);
+                weights.push_back(static_cast<std::uint32_t>(value));
+                weighted = weighted || value != 1;
             }
         }
+        offsets[i + 1] = static_cast<std::int64_t>(neighbors.size());
+        cursor[i] = std::upper_bound(neighbors.begin() + offsets[i], neighbors.end(), i) -
+                    neighbors.begin();
     }
     
-    // Дополнительная валидация
-    if (!validateMatrix(matrix, cityCount)) {
-        throw std::runtime_error("Матрица смежности не прошла валидацию");
+    // Матрица из 0 и 1 - невзвешенный граф, веса не хранятся
+    if (!weighted) {
+        return CSRGraph(cityCount, std::move(offsets), std::move(neighbors));
+    }
+    return CSRGraph(cityCount, std::move(offsets), std::move(neighbors), std::move(weights));
+}
+
+std::vector<std::int64_t> GraphReader::countEdgeList(TextScanner& scanner, int cityCount, std::int64_t edgeCount,
+                                                     bool directed, bool& weighted) {
+    if (edgeCount < 0) {
+        throw std::runtime_error("Некорректное количество ребер: " + std::to_string(edgeCount));
+    }
+    
+    // Веса есть, если в первой строке ребра третье число ("u v w");
+    // остальные строки должны быть в том же формате
+    std::vector<std::int64_t> offsets(static_cast<size_t>(cityCount) + 1, 0);
+    weighted = false;
+    for (std::int64_t e = 0; e < edgeCount; ++e) {
+        WeightedEdge edge = readEdge(scanner, e, cityCount, weighted);
+        ++offsets[edge.u + 1];
+        if (!directed && edge.u != edge.v) {
+            ++offsets[edge.v + 1];
+        }
     }
     
-    return matrix;
+    if (!scanner.atEnd()) {
+        throw std::runtime_error("Лишние данные после " + std::to_string(edgeCount) + " ребер");
+    }
+    
+    for (int v = 0; v < cityCount; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    return offsets;
 }
 
-bool GraphReader::validateMatrix(const AdjacencyMatrix& matrix, int cityCount) {
-    // Проверка размеров матрицы
-    if (matrix.size() != static_cast<size_t>(cityCount)) {
-        return false;
+CSRGraph GraphReader::readEdgeListBody(TextScanner& scanner, int cityCount, std::int64_t edgeCount,
+                                       bool directed) {
+    // Первый проход по отображенному тексту: проверка ребер и степени
+    bool symmetric = !directed;
+    TextScanner body = scanner;
+    bool weighted = false;
+    std::vector<std::int64_t> offsets = countEdgeList(scanner, cityCount, edgeCount, directed, weighted);
+    
+    // Второй проход: дуги сразу на свои места в строках CSR,
+    // список ребер целиком в памяти не хранится
+    std::vector<int> neighbors(static_cast<size_t>(offsets[cityCount]));
+    std::vector<std::uint32_t> weights(weighted ? neighbors.size() : 0);
+    std::vector<std::int64_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (std::int64_t e = 0; e < edgeCount; ++e) {
+        WeightedEdge edge = readEdge(body, e, cityCount, weighted);
+        std::int64_t position = cursor[edge.u]++;
+        neighbors[position] = edge.v;
+        if (weighted) {
+            weights[position] = edge.weight;
+        }
+        if (symmetric && edge.u != edge.v) {
+            position = cursor[edge.v]++;
+            neighbors[position] = edge.u;
+            if (weighted) {
+                weights[position] = edge.weight;
+            }
+        }
     }
     
-    for (const auto& row : matrix) {
-        if (row.size() != static_cast<size_t>(cityCount)) {
-            return false;
+    // Сортировка строк и удаление кратных ребер с уплотнением на месте;
+    // из кратных ребер остается самое легкое
+    std::vector<std::pair<int, std::uint32_t>> row;
+    std::int64_t write = 0;
+    for (int v = 0; v < cityCount; ++v) {
+        std::int64_t rowBegin = offsets[v];
+        std::int64_t rowEnd = offsets[v + 1];
+        offsets[v] = write;
+        if (!weighted) {
+            std::sort(neighbors.begin() + rowBegin, neighbors.begin() + rowEnd);
+            auto uniqueEnd = std::unique(neighbors.begin() + rowBegin, neighbors.begin() + rowEnd);
+            write = std::copy(neighbors.begin() + rowBegin, uniqueEnd, neighbors.begin() + write) -
+                    neighbors.begin();
+            continue;
+        }
+        
+        row.clear();
+        for (std::int64_t i = rowBegin; i < rowEnd; ++i) {
+            row.push_back(std::make_pair(neighbors[i], weights[i]));
+        }
+        std::sort(row.begin(), row.end());
+        for (const auto& arc : row) {
+            if (write > offsets[v] && neighbors[write - 1] == arc.first) {
+                continue;
+            }
+            neighbors[write] = arc.first;
+            weights[write] = arc.second;
+            ++write;
         }
     }
+    offsets[cityCount] = write;
+    neighbors.resize(static_cast<size_t>(write));
+    neighbors.shrink_to_fit();
     
-    // Проверка симметричности (для неориентированного графа)
-    for (int i = 0; i < cityCount; ++i) {
-        for (int j = 0; j < cityCount; ++j) {
-            if (matrix[i][j] != matrix[j][i]) {
-                return false;
+    if (!weighted) {
+        return CSRGraph(cityCount, std::move(offsets), std::move(neighbors));
+    }
+    weights.resize(static_cast<size_t>(write));
+    weights.shrink_to_fit();
+    return CSRGraph(cityCount, std::move(offsets), std::move(neighbors), std::move(weights));
+}
+
+CompressedGraph GraphReader::readCompressedEdgeListBody(TextScanner& scanner, int cityCount, std::int64_t edgeCount,
+                                                        bool directed) {
+    TextScanner body = scanner;
+    bool weighted = false;
+    std::vector<std::int64_t> offsets = countEdgeList(scanner, cityCount, edgeCount, directed, weighted);
+    
+    // Каждый диапазон вершин - еще один проход по тексту; дуги из
+    // других диапазонов пропускаются. Веса сжатым спискам не нужны
+    return CompressedGraph::fromArcs(offsets, [&](CompressedGraph::RowRange& range) {
+        TextScanner pass = body;
+        bool passWeighted = weighted;
+        for (std::int64_t e = 0; e < edgeCount; ++e) {
+            WeightedEdge edge = readEdge(pass, e, cityCount, passWeighted);
+            range.add(edge.u, edge.v);
+            if (!directed && edge.u != edge.v) {
+                range.add(edge.v, edge.u);
+            }
+        }
+    });
+}
+
+WeightedEdge GraphReader::readEdge(TextScanner& scanner, std::int64_t index, int cityCount, bool& weighted) {
+    std::int64_t u, v, w = 1;
+    if (!scanner.next(u) || !scanner.next(v)) {
+        throw std::runtime_error("Ошибка чтения ребра №" + std::to_string(index + 1));
+    }
+    bool hasWeight = scanner.nextOnLine(w);
+    if (index == 0) {
+        weighted = hasWeight;
+    } else if (hasWeight != weighted) {
+        throw std::runtime_error("Ребро №" + std::to_string(index + 1) +
+                                 (weighted ? ": нет веса" : ": лишнее число в строке"));
+    }
+    
+    if (u < 1 || u > cityCount || v < 1 || v > cityCount) {
+        throw std::runtime_error("Некорректное ребро: " + std::to_string(u) + " " +
+                                 std::to_string(v));
+    }
+    if (weighted && (w == 0 || !isValidMatrixValue(w))) {
+        throw std::runtime_error("Некорректный вес ребра №" + std::to_string(index + 1) + ": " +
+                                 std::to_string(w));
+    }
+    
+    WeightedEdge edge = {static_cast<int>(u - 1), static_cast<int>(v - 1), static_cast<std::uint32_t>(w)};
+    return edge;
+}
+
+void GraphReader::writeSnapshot(const CSRGraph& graph, const std::string& filename, bool directed) {
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.version = kSnapshotVersion;
+    header.vertexCount = static_cast<std::uint64_t>(graph.vertexCount());
+    header.arcCount = static_cast<std::uint64_t>(graph.arcCount());
+    header.offsetsPos = sizeof(SnapshotHeader);
+    header.neighborsPos = header.offsetsPos + sizeof(std::int64_t) * (header.vertexCount + 1);
+    header.checksum = graph.checksum();
+    if (directed) {
+        header.flags |= kDirectedFlag;
+    }
+    if (graph.isWeighted()) {
+        header.flags |= kWeightedFlag;
+        header.weightsPos = header.neighborsPos + sizeof(int) * header.arcCount;
+    }
+    
+    // Запись во временный файл и атомарная замена: читатели
+    // никогда не увидят недописанный снимок
+    std::string tempName = filename + ".tmp";
+    {
+        std::ofstream out(tempName, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("Не удалось создать файл снимка: " + tempName);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(graph.offsetsData()),
+                  static_cast<std::streamsize>(sizeof(std::int64_t) * (header.vertexCount + 1)));
+        out.write(reinterpret_cast<const char*>(graph.neighborsData()),
+                  static_cast<std::streamsize>(sizeof(int) * header.arcCount));
+        if (graph.isWeighted()) {
+            out.write(reinterpret_cast<const char*>(graph.weightsData()),
+                      static_cast<std::streamsize>(sizeof(std::uint32_t) * header.arcCount));
+        }
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Ошибка записи снимка: " + tempName);
+        }
+    }
+    
+    if (std::rename(tempName.c_str(), filename.c_str()) != 0) {
+        std::remove(tempName.c_str());
+        throw std::runtime_error("Не удалось переименовать снимок в " + filename);
+    }
+}
+
+CSRGraph GraphReader::mapSnapshot(const std::string& filename, bool verifyChecksum) {
+    return graphFromSnapshot(std::make_shared<MappedFile>(filename), filename, verifyChecksum, true);
+}
+
+bool GraphReader::isSnapshot(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(kSnapshotMagic)];
+    return file.read(magic, sizeof(magic)) &&
+           std::memcmp(magic, kSnapshotMagic, sizeof(kSnapshotMagic)) == 0;
+}
+
+SnapshotLayout GraphReader::readSnapshotLayout(const std::string& filename) {
+    DiskFile file(filename);
+    std::uint64_t fileSize = file.size();
+    if (fileSize < sizeof(SnapshotHeader)) {
+        throw std::runtime_error("Файл слишком мал для снимка: " + filename);
+    }
+    
+    SnapshotHeader header;
+    file.readAt(&header, sizeof(header), 0);
+    SnapshotLayout layout;
+    layout.weighted = checkSnapshotHeader(header, fileSize, filename, true);
+    layout.directed = header.version >= 2 && (header.flags & kDirectedFlag) != 0;
+    layout.vertexCount = static_cast<int>(header.vertexCount);
+    layout.arcCount = static_cast<std::int64_t>(header.arcCount);
+    layout.offsetsPos = header.offsetsPos;
+    layout.neighborsPos = header.neighborsPos;
+    return layout;
+}
+
+IOCounters GraphReader::convertToSnapshot(const std::string& filename, const std::string& snapshotFile,
+                                          std::size_t memoryBudget, const std::string& tempDirectory) {
+    MappedFile text(filename);
+    if (text.size() >= sizeof(kSnapshotMagic) &&
+        std::memcmp(text.data(), kSnapshotMagic, sizeof(kSnapshotMagic)) == 0) {
+        throw std::runtime_error("Файл уже является снимком: " + filename);
+    }
+    
+    TextScanner scanner(text.data(), text.data() + text.size());
+    std::int64_t count = 0;
+    std::int64_t edgeCount = -1;
+    if (!scanner.nextOnLine(count)) {
+        throw std::runtime_error("Ошибка чтения количества городов");
+    }
+    if (!scanner.nextOnLine(edgeCount)) {
+        throw std::runtime_error("Преобразование с ограничением памяти поддерживает только список ребер");
+    }
+    scanner.skipLine();
+    if (!isValidCityCount(count)) {
+        throw std::runtime_error("Некорректное количество городов: " + std::to_string(count));
+    }
+    if (edgeCount < 0) {
+        throw std::runtime_error("Некорректное количество ребер: " + std::to_string(edgeCount));
+    }
+    int cityCount = static_cast<int>(count);
+    
+    // Половина бюджета - сортировке, по 1/16 - трем буферам записи
+    IOCounters counters;
+    std::size_t streamBytes = std::max<std::size_t>(ExternalSorter<SnapshotArc>::kMinStreamBytes, memoryBudget / 16);
+    ExternalSorter<SnapshotArc> sorter(memoryBudget / 2, tempDirectory, true, &counters);
+    bool weighted = false;
+    for (std::int64_t e = 0; e < edgeCount; ++e) {
+        WeightedEdge edge = readEdge(scanner, e, cityCount, weighted);
+        SnapshotArc arc = {edge.u, edge.v, edge.weight};
+        sorter.push(arc);
+        if (edge.u != edge.v) {
+            SnapshotArc back = {edge.v, edge.u, edge.weight};
+            sorter.push(back);
+        }
+    }
+    if (!scanner.atEnd()) {
+        throw std::runtime_error("Лишние данные после " + std::to_string(edgeCount) + " ребер");
+    }
+    
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.version = kSnapshotVersion;
+    header.vertexCount = static_cast<std::uint64_t>(cityCount);
+    header.offsetsPos = sizeof(SnapshotHeader);
+    header.neighborsPos = header.offsetsPos + sizeof(std::int64_t) * (header.vertexCount + 1);
+    
+    // Смещения и соседи пишутся на свои места сразу, веса - во
+    // временный файл: их позиция известна только в конце
+    std::string tempName = snapshotFile + ".tmp";
+    try {
+        DiskFile out = DiskFile::create(tempName);
+        DiskFile weightsFile = DiskFile::temporary(tempDirectory);
+        RecordWriter<std::int64_t> offsets(out, header.offsetsPos, streamBytes, &counters);
+        RecordWriter<int> neighbors(out, header.neighborsPos, streamBytes, &counters);
+        RecordWriter<std::uint32_t> weights(weightsFile, 0, streamBytes, &counters);
+        int nextVertex = 0;
+        SnapshotArc previous = {-1, -1, 0};
+        sorter.finish([&](const SnapshotArc& arc) {
+            // Из кратных дуг первой идет самая легкая
+            if (arc.source == previous.source && arc.target == previous.target) {
+                return;
             }
+            previous = arc;
+            for (; nextVertex <= arc.source; ++nextVertex) {
+                offsets.push(static_cast<std::int64_t>(neighbors.count()));
+            }
+            neighbors.push(arc.target);
+            if (weighted) {
+                weights.push(arc.weight);
+            }
+        });
+        for (; nextVertex <= cityCount; ++nextVertex) {
+            offsets.push(static_cast<std::int64_t>(neighbors.count()));
+        }
+        offsets.flush();
+        neighbors.flush();
+        weights.flush();
+        
+        header.arcCount = neighbors.count();
+        if (weighted) {
+            header.flags |= kWeightedFlag;
+            header.weightsPos = header.neighborsPos + sizeof(int) * header.arcCount;
+            RecordReader<std::uint32_t> weightsIn(weightsFile, 0, weights.count(), streamBytes, &counters);
+            RecordWriter<std::uint32_t> weightsOut(out, header.weightsPos, streamBytes, &counters);
+            std::uint32_t weight;
+            while (weightsIn.next(weight)) {
+                weightsOut.push(weight);
+            }
+            weightsOut.flush();
+        }
+        
+        // Та же сумма, что CSRGraph::checksum, по отображенному файлу
+        MappedFile written(tempName);
+        header.checksum = CSRGraph::checksum(written.data() + header.offsetsPos,
+                                             sizeof(std::int64_t) * (header.vertexCount + 1), header.vertexCount);
+        header.checksum = CSRGraph::checksum(written.data() + header.neighborsPos,
+                                             sizeof(int) * header.arcCount, header.checksum);
+        if (weighted) {
+            header.checksum = CSRGraph::checksum(written.data() + header.weightsPos,
+                                                 sizeof(std::uint32_t) * header.arcCount, header.checksum);
         }
+        counters.bytesRead += written.size();
+        out.writeAt(&header, sizeof(header), 0);
+    } catch (...) {
+        std::remove(tempName.c_str());
+        throw;
     }
     
-    return true;
+    if (std::rename(tempName.c_str(), snapshotFile.c_str()) != 0) {
+        std::remove(tempName.c_str());
+        throw std::runtime_error("Не удалось переименовать снимок в " + snapshotFile);
+    }
+    return counters;
+}
+
+CSRGraph GraphReader::graphFromSnapshot(const std::shared_ptr<MappedFile>& file,
+                                        const std::string& filename, bool verifyChecksum,
+                                        bool allowDirected) {
+    if (file->size() < sizeof(SnapshotHeader)) {
+        throw std::runtime_error("Файл слишком мал для снимка: " + filename);
+    }
+    
+    SnapshotHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    bool weighted = checkSnapshotHeader(header, file->size(), filename, allowDirected);
+    
+    const std::int64_t* offsets = reinterpret_cast<const std::int64_t*>(file->data() + header.offsetsPos);
+    const int* neighbors = reinterpret_cast<const int*>(file->data() + header.neighborsPos);
+    const std::uint32_t* weights = weighted
+        ? reinterpret_cast<const std::uint32_t*>(file->data() + header.weightsPos) : nullptr;
+    if (offsets[0] != 0 || offsets[header.vertexCount] != static_cast<std::int64_t>(header.arcCount)) {
+        throw std::runtime_error("Массив смещений снимка поврежден: " + filename);
+    }
+    
+    // Структура проверяется при каждой загрузке, чтобы BFS не вышел за
+    // массивы: смещения не убывают (значит, лежат в 0..arcCount), соседи -
+    // номера вершин. Это простые сравнения без хеширования; полная
+    // контрольная сумма - только по запросу
+    for (std::uint64_t v = 0; v < header.vertexCount; ++v) {
+        if (offsets[v] > offsets[v + 1]) {
+            throw std::runtime_error("Массив смещений снимка поврежден: " + filename);
+        }
+    }
+    std::uint32_t vertexLimit = static_cast<std::uint32_t>(header.vertexCount);
+    bool outOfRange = false;
+    for (std::uint64_t i = 0; i < header.arcCount; ++i) {
+        outOfRange |= static_cast<std::uint32_t>(neighbors[i]) >= vertexLimit;
+    }
+    if (outOfRange) {
+        throw std::runtime_error("Номер соседа в снимке вне диапазона вершин: " + filename);
+    }
+    
+    CSRGraph graph = CSRGraph::fromExternal(static_cast<int>(header.vertexCount),
+                                            static_cast<std::int64_t>(header.arcCount),
+                                            offsets, neighbors, file, weights);
+    if (verifyChecksum && graph.checksum() != header.checksum) {
+        throw std::runtime_error("Контрольная сумма снимка не совпадает: " + filename);
+    }
+    
+    file->adviseRandomAccess();
+    return graph;
+}
+
+bool GraphReader::validateGraph(const CSRGraph& graph, int cityCount) {
+    // Проверка размеров графа
+    if (graph.vertexCount() != cityCount) {
+        return false;
+    }
+    
+    // Проверка симметричности (для неориентированного графа)
+    return graph.isSymmetric();
 }
 
-bool GraphReader::isValidCityCount(int count) {
-    return count >= 1 && count <= 25;
+bool GraphReader::isValidCityCount(std::int64_t count) {
+    return count >= 1 && count <= kMaxCityCount;
 }
 
-bool GraphReader::isValidMatrixValue(int value) {
-    return value == 0 || value == 1;
+bool GraphReader::isValidMatrixValue(std::int64_t value) {
+    return value >= 0 && value <= kMaxWeight;
 }
\ No newline at end of file
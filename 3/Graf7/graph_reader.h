@@ -1,56 +1,308 @@
 /**
  * @file graph_reader.h
  * @brief Чтение графа из файла
- * @version 2.0
+ * @version 2.5
  * 
- * Класс для чтения матрицы смежности из текстового файла
+ * Класс для чтения графа из текстового файла (матрица смежности
+ * или список ребер) в компактное представление CSR.
+ * Файл отображается в память и разбирается за один проход.
  */
 
 #ifndef GRAPH_READER_H
 #define GRAPH_READER_H
 
+#include "compressed_graph.h"
+#include "external_io.h"
 #include "graph_utils.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
+
+class MappedFile;
+class TextScanner;
+
+/**
+ * @struct LoadStats
+ * @brief Статистика загрузки графа
+ */
+struct LoadStats {
+    std::uint64_t bytes = 0;  ///< Размер прочитанного файла
+    double seconds = 0.0;     ///< Время чтения и построения графа
+
+    /**
+     * @brief Пропускная способность загрузки
+     * @return double Мегабайт в секунду (0 если время не измерено)
+     */
+    double megabytesPerSecond() const {
+        return seconds > 0.0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0;
+    }
+};
+
+/**
+ * @struct SnapshotLayout
+ * @brief Размеры и расположение массивов в файле снимка
+ */
+struct SnapshotLayout {
+    int vertexCount = 0;             ///< Количество вершин
+    std::int64_t arcCount = 0;       ///< Длина массива соседей
+    std::uint64_t offsetsPos = 0;    ///< Позиция массива смещений int64 (vertexCount + 1)
+    std::uint64_t neighborsPos = 0;  ///< Позиция массива соседей int32
+    bool weighted = false;           ///< После соседей лежат веса
+    bool directed = false;           ///< Граф ориентированный
+};
 
 /**
  * @class GraphReader
  * @brief Читатель графа из файла
  * 
- * Обеспечивает чтение и валидацию матрицы смежности из файла
+ * Обеспечивает чтение и валидацию графа из файла.
+ * Формат определяется по первой строке:
+ * - "n" - далее матрица смежности n×n: 0 - нет дороги, иначе время в пути
+ *   (матрица только из 0 и 1 дает невзвешенный граф);
+ * - "n m" - далее m строк "u v" или "u v w" (ребра, номера городов 1..n,
+ *   w - время в пути, формат задает первая строка).
+ * Ориентированный граф (readDirectedFromFile) читается из тех же
+ * форматов: матрица может быть несимметричной, строка "u v" - дуга u → v.
+ * Файл, начинающийся с сигнатуры снимка, отображается в память
+ * без разбора (см. writeSnapshot).
  */
 class GraphReader {
 public:
     /**
-     * @brief Чтение графа из файла
+     * @brief Максимальное количество городов (2^31 - 1, номера хранятся в int)
+     */
+    static const std::int64_t kMaxCityCount;
+    
+    /**
+     * @brief Максимальный вес ребра (веса хранятся в uint32)
+     */
+    static const std::int64_t kMaxWeight;
+
+    /**
+     * @brief Чтение графа из файла (формат определяется автоматически)
      * @param filename Имя файла
      * @param[out] cityCount Количество городов
-     * @return AdjacencyMatrix Матрица смежности
+     * @param[out] stats Статистика загрузки (может быть nullptr)
+     * @param verifyChecksum true - проверить контрольную сумму снимка (проход
+     *        по всем массивам); без нее у снимка проверяются только заголовок и размеры
+     * @return CSRGraph Граф в формате CSR (плотная матрица в памяти не хранится)
+     * @throws std::runtime_error при ошибках чтения или валидации
+     */
+    static CSRGraph readFromFile(const std::string& filename, int& cityCount,
+                                 LoadStats* stats = nullptr, bool verifyChecksum = false);
+    
+    /**
+     * @brief Чтение ориентированного графа
+     * 
+     * Файл разбирается один раз; обратный граф строится транспонированием
+     * подсчетом, без повторного чтения
+     * @param filename Имя файла (текст или снимок)
+     * @param[out] cityCount Количество городов
+     * @param[out] stats Статистика загрузки, включая построение обратного графа (может быть nullptr)
+     * @param verifyChecksum true - проверить контрольную сумму снимка
+     * @return DirectedGraph Исходящие и входящие дуги
+     * @throws std::runtime_error при ошибках чтения или валидации
+     */
+    static DirectedGraph readDirectedFromFile(const std::string& filename, int& cityCount,
+                                              LoadStats* stats = nullptr, bool verifyChecksum = false);
+    
+    /**
+     * @brief Чтение графа сразу в сжатые списки соседей
+     * 
+     * Массивы CSR целиком не строятся. Список ребер раскладывается
+     * по диапазонам вершин (CompressedGraph::fromArcs): после прохода
+     * с подсчетом степеней - по проходу по тексту на диапазон. Снимок
+     * сжимается построчно из отображенного файла. Матрица смежности
+     * читается в CSR (он меньше текста матрицы) и сжимается. Веса
+     * не сохраняются
+     * @param filename Имя файла (текст или снимок)
+     * @param[out] cityCount Количество городов
+     * @param[out] stats Статистика загрузки (может быть nullptr)
+     * @param directed true - у ориентированного графа сжимаются исходящие дуги
+     * @param verifyChecksum true - проверить контрольную сумму снимка
+     * @return CompressedGraph Сжатый граф в исходной нумерации
      * @throws std::runtime_error при ошибках чтения или валидации
      */
-    static AdjacencyMatrix readFromFile(const std::string& filename, int& cityCount);
+    static CompressedGraph readCompressedFromFile(const std::string& filename, int& cityCount,
+                                                  LoadStats* stats = nullptr, bool directed = false,
+                                                  bool verifyChecksum = false);
+    
+    /**
+     * @brief Запись двоичного снимка графа
+     * 
+     * Формат (порядок байт платформы): заголовок 64 байта
+     * (сигнатура, версия, размеры, контрольная сумма), затем массив
+     * смещений int64, массив соседей int32 и, у взвешенного графа,
+     * массив весов uint32 (версия 2). Файл пишется во временный
+     * и атомарно переименовывается.
+     * @param graph Граф для записи (у ориентированного - исходящие дуги)
+     * @param filename Имя файла снимка
+     * @param directed true - граф ориентированный (отмечается в заголовке)
+     * @throws std::runtime_error при ошибке записи
+     */
+    static void writeSnapshot(const CSRGraph& graph, const std::string& filename,
+                              bool directed = false);
+    
+    /**
+     * @brief Отображение снимка в память без разбора и копирования
+     * 
+     * У ориентированного снимка возвращаются исходящие дуги
+     * @param filename Имя файла снимка
+     * @param verifyChecksum true - проверить контрольную сумму массивов
+     * @return CSRGraph Граф, ссылающийся на отображенный файл
+     * @throws std::runtime_error если файл не является корректным снимком
+     */
+    static CSRGraph mapSnapshot(const std::string& filename, bool verifyChecksum = false);
+    
+    /**
+     * @brief Проверка, является ли файл двоичным снимком
+     * @param filename Имя файла
+     * @return true если файл начинается с сигнатуры снимка
+     */
+    static bool isSnapshot(const std::string& filename);
     
     /**
-     * @brief Валидация матрицы смежности
-     * @param matrix Матрица для проверки
+     * @brief Чтение и проверка заголовка снимка без отображения массивов
+     * @param filename Имя файла снимка
+     * @return SnapshotLayout Размеры и позиции массивов
+     * @throws std::runtime_error если файл не является корректным снимком
+     */
+    static SnapshotLayout readSnapshotLayout(const std::string& filename);
+    
+    /**
+     * @brief Преобразование списка ребер в снимок с ограничением памяти
+     * 
+     * Для графов, которые не помещаются в память: дуги (обе
+     * стороны каждого ребра) сортируются внешней сортировкой, затем
+     * смещения, соседи и веса пишутся последовательно. Кратные
+     * ребра удаляются, из них остается самое легкое - снимок совпадает
+     * с записанным writeSnapshot после обычной загрузки. Контрольная
+     * сумма считается отдельным последовательным проходом по файлу
+     * @param filename Текстовый файл "n m" со списком ребер
+     * @param snapshotFile Имя файла снимка (пишется через временный)
+     * @param memoryBudget Память под сортировку и буферы, байт
+     * @param tempDirectory Каталог временных файлов (пусто - $TMPDIR или /tmp)
+     * @return IOCounters Объем ввода-вывода сортировки и записи
+     * @throws std::runtime_error при ошибках чтения, формата или записи
+     */
+    static IOCounters convertToSnapshot(const std::string& filename, const std::string& snapshotFile,
+                                        std::size_t memoryBudget, const std::string& tempDirectory = "");
+    
+    /**
+     * @brief Валидация графа
+     * @param graph Граф для проверки
      * @param cityCount Количество городов
-     * @return true если матрица корректна
+     * @return true если граф корректен (размер совпадает, ребра симметричны)
      */
-    static bool validateMatrix(const AdjacencyMatrix& matrix, int cityCount);
+    static bool validateGraph(const CSRGraph& graph, int cityCount);
 
 private:
+    /**
+     * @brief Чтение графа в одном из форматов
+     * @param filename Имя файла
+     * @param[out] cityCount Количество городов
+     * @param[out] stats Статистика загрузки (может быть nullptr)
+     * @param directed true - дуги не симметризуются и симметричность не проверяется
+     * @param verifyChecksum true - проверить контрольную сумму снимка
+     * @return CSRGraph Граф (у ориентированного - исходящие дуги)
+     */
+    static CSRGraph readGraph(const std::string& filename, int& cityCount, LoadStats* stats,
+                              bool directed, bool verifyChecksum);
+    
+    /**
+     * @brief Построение графа поверх отображенного снимка
+     * @param file Отображенный файл (удерживается графом)
+     * @param filename Имя файла для сообщений об ошибках
+     * @param verifyChecksum true - проверить контрольную сумму
+     * @param allowDirected false - ориентированный снимок считается ошибкой
+     * @return CSRGraph Граф без копирования данных
+     */
+    static CSRGraph graphFromSnapshot(const std::shared_ptr<MappedFile>& file,
+                                      const std::string& filename, bool verifyChecksum,
+                                      bool allowDirected);
+    
+    /**
+     * @brief Чтение строки заголовка текстового файла
+     * @param scanner Сканер в начале файла (на выходе - после заголовка)
+     * @param[out] cityCount Количество городов
+     * @param[out] edgeCount Количество ребер (только у списка ребер)
+     * @return true если это список ребер ("n m"), false - матрица ("n")
+     * @throws std::runtime_error при ошибке формата или количества городов
+     */
+    static bool readTextHeader(TextScanner& scanner, int& cityCount, std::int64_t& edgeCount);
+    
+    /**
+     * @brief Чтение матрицы смежности после строки заголовка
+     * 
+     * Диапазон значений и симметричность проверяются в том же проходе
+     * @param scanner Сканер, установленный после заголовка
+     * @param cityCount Количество городов
+     * @param directed true - строка i задает исходящие дуги, симметричность не требуется
+     * @return CSRGraph Граф в формате CSR
+     */
+    static CSRGraph readMatrixBody(TextScanner& scanner, int cityCount, bool directed);
+    
+    /**
+     * @brief Чтение списка ребер после строки заголовка (два прохода по тексту)
+     * @param scanner Сканер, установленный после заголовка
+     * @param cityCount Количество городов
+     * @param edgeCount Количество ребер из заголовка
+     * @param directed true - строка "u v" задает одну дугу u → v
+     * @return CSRGraph Граф в формате CSR
+     */
+    static CSRGraph readEdgeListBody(TextScanner& scanner, int cityCount, std::int64_t edgeCount,
+                                     bool directed);
+    
+    /**
+     * @brief Проход по списку ребер: проверка строк и подсчет степеней
+     * @param scanner Сканер, установленный после заголовка (на выходе - в конце файла)
+     * @param cityCount Количество городов
+     * @param edgeCount Количество ребер из заголовка
+     * @param directed true - строка "u v" дает дугу только из u
+     * @param[out] weighted Есть ли веса
+     * @return std::vector<std::int64_t> Префиксные суммы степеней с кратными ребрами (cityCount + 1)
+     * @throws std::runtime_error при ошибке формата, значения или лишних данных
+     */
+    static std::vector<std::int64_t> countEdgeList(TextScanner& scanner, int cityCount, std::int64_t edgeCount,
+                                                   bool directed, bool& weighted);
+    
+    /**
+     * @brief Чтение списка ребер сразу в сжатые списки (проход на диапазон вершин)
+     * @param scanner Сканер, установленный после заголовка
+     * @param cityCount Количество городов
+     * @param edgeCount Количество ребер из заголовка
+     * @param directed true - строка "u v" задает одну дугу u → v
+     * @return CompressedGraph Сжатый граф без весов
+     */
+    static CompressedGraph readCompressedEdgeListBody(TextScanner& scanner, int cityCount,
+                                                      std::int64_t edgeCount, bool directed);
+    
+    /**
+     * @brief Чтение одной строки списка ребер
+     * @param scanner Сканер, установленный на строку ребра
+     * @param index Номер ребра (0-based); по строке 0 определяется наличие весов
+     * @param cityCount Количество городов
+     * @param[in,out] weighted Есть ли веса (задается на ребре 0)
+     * @return WeightedEdge Ребро с 0-based номерами (вес 1, если весов нет)
+     * @throws std::runtime_error при ошибке формата или значения
+     */
+    static WeightedEdge readEdge(TextScanner& scanner, std::int64_t index, int cityCount, bool& weighted);
+    
     /**
      * @brief Проверка корректности количества городов
      * @param count Количество городов
-     * @return true если количество корректно
+     * @return true если 1 ≤ count ≤ kMaxCityCount
      */
-    static bool isValidCityCount(int count);
+    static bool isValidCityCount(std::int64_t count);
     
     /**
      * @brief Проверка корректности значения в матрице
      * @param value Значение для проверки
-     * @return true если значение 0 или 1
+     * @return true если значение от 0 до kMaxWeight
      */
-    static bool isValidMatrixValue(int value);
+    static bool isValidMatrixValue(std::int64_t value);
 };
 
 #endif // GRAPH_READER_H
\ No newline at end of file
@@ -0,0 +1,238 @@
+/**
+ * @file graph_snapshot.cpp
+ * @brief Реализация неизменяемых версий графа
+ * @version 1.6
+ */
+
+#include "graph_snapshot.h"
+#include "adjacency.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Сжатие графа сразу во внутренней нумерации
+ *
+ * Строка вершины u - соседи исходной вершины toOriginal(u),
+ * переведенные во внутренние номера и отсортированные; перенумерованная
+ * копия графа не строится
+ * @param graph Граф в исходной нумерации (adjacency.h)
+ * @param order Перестановка вершин
+ * @return CompressedGraph Сжатый граф во внутренней нумерации
+ */
+template <class Adjacency>
+CompressedGraph encodeRelabeled(Adjacency& graph, const VertexPermutation& order) {
+    CompressedGraph::Encoder encoder(graph.vertexCount());
+    std::vector<int> row;
+    for (int u = 0; u < graph.vertexCount(); ++u) {
+        NeighborRange range = graph.neighbors(order.toOriginal(u));
+        if (order.isIdentity()) {
+            encoder.addRow(range.first, static_cast<int>(range.second - range.first));
+            continue;
+        }
+        row.clear();
+        for (const int* it = range.first; it != range.second; ++it) {
+            row.push_back(order.toInternal(*it));
+        }
+        std::sort(row.begin(), row.end());
+        encoder.addRow(row.data(), static_cast<int>(row.size()));
+    }
+    return encoder.finish();
+}
+
+} // namespace
+
+GraphSnapshot::GraphSnapshot(const CSRGraph& graph, const CSRGraph* reverse, int cityCount,
+                             std::uint64_t version, VertexPermutation order, std::uint64_t sourceChecksum)
+    : graph_(graph), reverse_(reverse != nullptr ? *reverse : graph), directed_(reverse != nullptr),
+      cityCount_(cityCount), version_(version),
+      components_(ComponentIndex::build(graph, reverse)), dense_(isDenseGraph(graph)),
+      order_(std::move(order)), sourceChecksum_(sourceChecksum), compressedLists_(false) {
+    if (dense_) {
+        denseGraph_ = BitMatrix::fromGraph(graph_);
+    }
+}
+
+GraphSnapshot::GraphSnapshot(CompressedGraph graph, CompressedGraph reverse, bool directed, int cityCount,
+                             std::uint64_t version, VertexPermutation order)
+    : directed_(directed), cityCount_(cityCount), version_(version), dense_(false), order_(std::move(order)),
+      sourceChecksum_(0), compressedLists_(true), compressed_(std::move(graph)),
+      compressedReverse_(std::move(reverse)) {
+    // Массивов CSR нет: компоненты ищутся по сжатым спискам
+    components_ = ComponentIndex::build(compressed_, directed_ ? &compressedReverse_ : nullptr);
+}
+
+std::shared_ptr<const GraphSnapshot> GraphSnapshot::create(const CSRGraph& graph, int cityCount,
+                                                           std::uint64_t version) {
+    return create(graph, cityCount, GraphLayout(), version);
+}
+
+std::shared_ptr<const GraphSnapshot> GraphSnapshot::create(const CSRGraph& graph, int cityCount,
+                                                           const GraphLayout& layout, std::uint64_t version) {
+    if (cityCount != graph.vertexCount()) {
+        throw std::runtime_error("Количество городов " + std::to_string(cityCount) +
+                                 " не совпадает с числом вершин графа " +
+                                 std::to_string(graph.vertexCount()));
+    }
+    if (layout.compressed) {
+        VertexPermutation permutation = VertexPermutation::compute(graph, layout.order);
+        CSRAdjacency adjacency(graph);
+        CompressedGraph compressed = encodeRelabeled(adjacency, permutation);
+        return std::shared_ptr<const GraphSnapshot>(
+            new GraphSnapshot(std::move(compressed), CompressedGraph(), false, cityCount, version,
+                              std::move(permutation)));
+    }
+    if (layout.order == VertexOrder::Original) {
+        return std::shared_ptr<const GraphSnapshot>(
+            new GraphSnapshot(graph, nullptr, cityCount, version, VertexPermutation(), 0));
+    }
+
+    VertexPermutation permutation = VertexPermutation::compute(graph, layout.order);
+    CSRGraph relabeled = permutation.apply(graph);
+    return std::shared_ptr<const GraphSnapshot>(
+        new GraphSnapshot(relabeled, nullptr, cityCount, version, std::move(permutation), graph.checksum()));
+}
+
+std::shared_ptr<const GraphSnapshot> GraphSnapshot::createDirected(const DirectedGraph& graph, int cityCount,
+                                                                   std::uint64_t version) {
+    return createDirected(graph, cityCount, GraphLayout(), version);
+}
+
+std::shared_ptr<const GraphSnapshot> GraphSnapshot::createDirected(const DirectedGraph& graph, int cityCount,
+                                                                   const GraphLayout& layout,
+                                                                   std::uint64_t version) {
+    if (cityCount != graph.forward.vertexCount() || cityCount != graph.reverse.vertexCount()) {
+        throw std::runtime_error("Количество городов " + std::to_string(cityCount) +
+                                 " не совпадает с числом вершин графа " +
+                                 std::to_string(graph.forward.vertexCount()));
+    }
+    if (layout.compressed) {
+        VertexPermutation permutation = VertexPermutation::compute(graph.forward, layout.order);
+        CSRAdjacency forward(graph.forward);
+        CSRAdjacency backward(graph.reverse);
+        CompressedGraph compressed = encodeRelabeled(forward, permutation);
+        CompressedGraph compressedReverse = encodeRelabeled(backward, permutation);
+        return std::shared_ptr<const GraphSnapshot>(
+            new GraphSnapshot(std::move(compressed), std::move(compressedReverse), true, cityCount, version,
+                              std::move(permutation)));
+    }
+    if (layout.order == VertexOrder::Original) {
+        return std::shared_ptr<const GraphSnapshot>(
+            new GraphSnapshot(graph.forward, &graph.reverse, cityCount, version, VertexPermutation(), 0));
+    }
+
+    VertexPermutation permutation = VertexPermutation::compute(graph.forward, layout.order);
+    DirectedGraph relabeled = permutation.apply(graph);
+    return std::shared_ptr<const GraphSnapshot>(
+        new GraphSnapshot(relabeled.forward, &relabeled.reverse, cityCount, version,
+                          std::move(permutation), graph.forward.checksum()));
+}
+
+std::shared_ptr<const GraphSnapshot> GraphSnapshot::createCompressed(CompressedGraph graph, bool directed,
+                                                                     int cityCount, VertexOrder order,
+                                                                     std::uint64_t version) {
+    if (cityCount != graph.vertexCount()) {
+        throw std::runtime_error("Количество городов " + std::to_string(cityCount) +
+                                 " не совпадает с числом вершин графа " +
+                                 std::to_string(graph.vertexCount()));
+    }
+
+    // Исходные списки отпускаются сразу после повторного сжатия
+    VertexPermutation permutation = VertexPermutation::compute(graph, order);
+    if (!permutation.isIdentity()) {
+        CompressedAdjacency adjacency(graph);
+        CompressedGraph relabeled = encodeRelabeled(adjacency, permutation);
+        graph = std::move(relabeled);
+    }
+    CompressedGraph reverse = directed ? graph.transposed() : CompressedGraph();
+    return std::shared_ptr<const GraphSnapshot>(
+        new GraphSnapshot(std::move(graph), std::move(reverse), directed, cityCount, version,
+                          std::move(permutation)));
+}
+
+const CSRGraph& GraphSnapshot::graph() const {
+    requireArrays();
+    return graph_;
+}
+
+const CSRGraph& GraphSnapshot::reverse() const {
+    requireArrays();
+    return reverse_;
+}
+
+std::int64_t GraphSnapshot::arcCount() const {
+    return compressedLists_ ? compressed_.arcCount() : graph_.arcCount();
+}
+
+std::uint64_t GraphSnapshot::adjacencyBytes() const {
+    if (compressedLists_) {
+        return compressed_.memoryBytes() + (directed_ ? compressedReverse_.memoryBytes() : 0);
+    }
+    std::uint64_t sides = directed_ ? 2 : 1;
+    return sides * arrayBytes(graph_);
+}
+
+std::uint64_t GraphSnapshot::arrayBytes(const CSRGraph& graph) {
+    std::uint64_t arcs = static_cast<std::uint64_t>(graph.arcCount());
+    return (static_cast<std::uint64_t>(graph.vertexCount()) + 1) * sizeof(std::int64_t) + arcs * sizeof(int) +
+           (graph.weightsData() != nullptr ? arcs * sizeof(std::uint32_t) : 0);
+}
+
+void GraphSnapshot::requireArrays() const {
+    if (compressedLists_) {
+        throw std::runtime_error("Снимок хранит только сжатые списки соседей: операция требует массивов CSR");
+    }
+}
+
+GraphLayout GraphSnapshot::layout() const {
+    GraphLayout layout;
+    layout.order = order_.order();
+    layout.compressed = compressedLists_;
+    return layout;
+}
+
+bool GraphSnapshot::isDenseGraph(const CSRGraph& graph) {
+    const std::uint64_t maxMatrixBytes = 256ULL * 1024 * 1024;
+    std::uint64_t matrixBytes = BitMatrix::bytesFor(graph.vertexCount());
+    std::uint64_t neighborsBytes = static_cast<std::uint64_t>(graph.arcCount()) * sizeof(int);
+    return matrixBytes <= maxMatrixBytes && matrixBytes <= neighborsBytes;
+}
+
+SnapshotStore::SnapshotStore(std::shared_ptr<const GraphSnapshot> initial) {
+    if (!initial) {
+        throw std::runtime_error("Пустой снимок графа");
+    }
+    std::atomic_store(&current_, initial);
+}
+
+std::shared_ptr<const GraphSnapshot> SnapshotStore::current() const {
+    return std::atomic_load(&current_);
+}
+
+std::shared_ptr<const GraphSnapshot> SnapshotStore::publish(const CSRGraph& graph, int cityCount) {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    std::shared_ptr<const GraphSnapshot> previous = current();
+    if (previous->isDirected()) {
+        throw std::runtime_error("Версия ориентированного графа публикуется вместе с обратными дугами");
+    }
+    std::shared_ptr<const GraphSnapshot> next =
+        GraphSnapshot::create(graph, cityCount, previous->layout(), previous->version() + 1);
+    std::atomic_store(&current_, next);
+    return next;
+}
+
+std::shared_ptr<const GraphSnapshot> SnapshotStore::publish(const DirectedGraph& graph, int cityCount) {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    std::shared_ptr<const GraphSnapshot> previous = current();
+    if (!previous->isDirected()) {
+        throw std::runtime_error("Ориентированный граф нельзя опубликовать вместо неориентированного");
+    }
+    std::shared_ptr<const GraphSnapshot> next =
+        GraphSnapshot::createDirected(graph, cityCount, previous->layout(), previous->version() + 1);
+    std::atomic_store(&current_, next);
+    return next;
+}
@@ -0,0 +1,333 @@
+/**
+ * @file graph_snapshot.h
+ * @brief Неизменяемые версии графа и их публикация
+ * @version 1.6
+ *
+ * Снимок объединяет граф и все, что по нему строится один раз
+ * (индекс компонент, битовая матрица плотного графа). Снимки
+ * разделяются через std::shared_ptr: любое число анализаторов в разных
+ * потоках читает один снимок без блокировок, а писатель публикует
+ * новую версию, не дожидаясь читателей (в духе RCU). Старая версия
+ * освобождается, когда ее отпускает последний читатель.
+ *
+ * Снимок может хранить граф во внутренней нумерации вершин
+ * (см. vertex_order.h) вместе с перестановкой; все производные
+ * структуры строятся по внутренней нумерации. По запросу вместо
+ * массивов CSR хранятся сжатые списки соседей (compressed_graph.h);
+ * они пишутся сразу во внутренней нумерации, без перенумерованной
+ * копии CSR.
+ */
+
+#ifndef GRAPH_SNAPSHOT_H
+#define GRAPH_SNAPSHOT_H
+
+#include "bit_matrix.h"
+#include "component_index.h"
+#include "compressed_graph.h"
+#include "csr_graph.h"
+#include "vertex_order.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+/**
+ * @struct GraphLayout
+ * @brief Представление графа в снимке
+ */
+struct GraphLayout {
+    VertexOrder order = VertexOrder::Original;  ///< Перенумерация вершин
+    bool compressed = false;                    ///< Сжатые списки соседей вместо CSR
+};
+
+/**
+ * @class GraphSnapshot
+ * @brief Одна неизменяемая версия графа с производными структурами
+ */
+class GraphSnapshot {
+private:
+    CSRGraph graph_;              ///< Исходящие дуги (пуст, если хранятся сжатые списки)
+    CSRGraph reverse_;            ///< Входящие дуги (у неориентированного графа - тот же graph_)
+    bool directed_;
+    int cityCount_;
+    std::uint64_t version_;
+    ComponentIndex components_;   ///< Компоненты связности и оценки эксцентриситетов
+    bool dense_;
+    BitMatrix denseGraph_;        ///< Битовая матрица (только для плотных графов)
+    VertexPermutation order_;     ///< Исходные номера вершин ↔ внутренние
+    std::uint64_t sourceChecksum_;///< Контрольная сумма графа в исходной нумерации (0 - не перенумерован или сжат)
+    bool compressedLists_;
+    CompressedGraph compressed_;        ///< Сжатые исходящие дуги (если compressedLists_)
+    CompressedGraph compressedReverse_; ///< Сжатые входящие дуги (у ориентированного графа)
+
+    GraphSnapshot(const CSRGraph& graph, const CSRGraph* reverse, int cityCount, std::uint64_t version,
+                  VertexPermutation order, std::uint64_t sourceChecksum);
+
+    GraphSnapshot(CompressedGraph graph, CompressedGraph reverse, bool directed, int cityCount,
+                  std::uint64_t version, VertexPermutation order);
+
+public:
+    /**
+     * @brief Построение снимка
+     *
+     * Граф не копируется (копия CSRGraph разделяет массивы). Строится
+     * индекс компонент, а для плотного графа - битовая матрица смежности
+     * @param graph Граф в формате CSR
+     * @param cityCount Количество городов
+     * @param version Номер версии
+     * @return std::shared_ptr<const GraphSnapshot> Снимок
+     * @throws std::runtime_error если cityCount не совпадает с числом вершин
+     */
+    static std::shared_ptr<const GraphSnapshot> create(const CSRGraph& graph, int cityCount,
+                                                       std::uint64_t version = 1);
+
+    /**
+     * @brief Построение снимка с заданным представлением
+     *
+     * Граф перенумеровывается один раз; снимок хранит граф во
+     * внутренней нумерации и перестановку. Сжатые списки заменяют
+     * CSR и пишутся построчно прямо из исходного графа, с переводом
+     * соседей во внутренние номера; битовая матрица плотного графа
+     * при сжатии не строится
+     * @param graph Граф в исходной нумерации
+     * @param cityCount Количество городов
+     * @param layout Перенумерация и сжатие (по умолчанию - как create)
+     * @param version Номер версии
+     * @return std::shared_ptr<const GraphSnapshot> Снимок
+     * @throws std::runtime_error если cityCount не совпадает с числом вершин
+     */
+    static std::shared_ptr<const GraphSnapshot> create(const CSRGraph& graph, int cityCount,
+                                                       const GraphLayout& layout, std::uint64_t version = 1);
+
+    /**
+     * @brief Построение снимка ориентированного графа
+     *
+     * Индекс компонент строится по слабым компонентам; битовая матрица
+     * плотного графа хранит исходящие дуги
+     * @param graph Исходящие и входящие дуги
+     * @param cityCount Количество городов
+     * @param version Номер версии
+     * @return std::shared_ptr<const GraphSnapshot> Снимок
+     * @throws std::runtime_error если cityCount не совпадает с числом вершин
+     */
+    static std::shared_ptr<const GraphSnapshot> createDirected(const DirectedGraph& graph, int cityCount,
+                                                               std::uint64_t version = 1);
+
+    /**
+     * @brief Построение снимка ориентированного графа с заданным представлением
+     *
+     * Порядок вычисляется по исходящим дугам; сжимаются обе стороны,
+     * каждая построчно из своего CSR
+     * @param graph Исходящие и входящие дуги в исходной нумерации
+     * @param cityCount Количество городов
+     * @param layout Перенумерация и сжатие
+     * @param version Номер версии
+     * @return std::shared_ptr<const GraphSnapshot> Снимок
+     * @throws std::runtime_error если cityCount не совпадает с числом вершин
+     */
+    static std::shared_ptr<const GraphSnapshot> createDirected(const DirectedGraph& graph, int cityCount,
+                                                               const GraphLayout& layout,
+                                                               std::uint64_t version = 1);
+
+    /**
+     * @brief Построение снимка из сжатых списков без массивов CSR
+     *
+     * Для графа, прочитанного сразу в сжатые списки
+     * (GraphReader::readCompressedFromFile). Перестановка вычисляется
+     * по сжатым спискам, строки сжимаются заново во внутренней
+     * нумерации, и исходные списки освобождаются. Входящие дуги
+     * ориентированного графа получаются транспонированием
+     * (CompressedGraph::transposed)
+     * @param graph Сжатые исходящие дуги в исходной нумерации
+     * @param directed true - граф ориентированный
+     * @param cityCount Количество городов
+     * @param order Перенумерация вершин
+     * @param version Номер версии
+     * @return std::shared_ptr<const GraphSnapshot> Снимок
+     * @throws std::runtime_error если cityCount не совпадает с числом вершин
+     */
+    static std::shared_ptr<const GraphSnapshot> createCompressed(CompressedGraph graph, bool directed, int cityCount,
+                                                                 VertexOrder order, std::uint64_t version = 1);
+
+    /**
+     * @brief Граф
+     * @return const CSRGraph& Граф в формате CSR (во внутренней нумерации)
+     * @throws std::runtime_error если снимок хранит только сжатые списки
+     */
+    const CSRGraph& graph() const;
+
+    /**
+     * @brief Граф входящих дуг
+     * @return const CSRGraph& Транспонированный граф (у неориентированного - graph())
+     * @throws std::runtime_error если снимок хранит только сжатые списки
+     */
+    const CSRGraph& reverse() const;
+
+    /**
+     * @brief Количество дуг
+     * @return std::int64_t Дуги графа (в любом представлении)
+     */
+    std::int64_t arcCount() const;
+
+    /**
+     * @brief Память списков смежности
+     * @return std::uint64_t Байт массивов CSR или сжатых списков (обе стороны у ориентированного графа)
+     */
+    std::uint64_t adjacencyBytes() const;
+
+    /**
+     * @brief Ориентирован ли граф
+     * @return true если снимок создан createDirected
+     */
+    bool isDirected() const { return directed_; }
+
+    /**
+     * @brief Количество городов
+     * @return int Количество городов
+     */
+    int cityCount() const { return cityCount_; }
+
+    /**
+     * @brief Номер версии
+     * @return std::uint64_t Номер, заданный при создании
+     */
+    std::uint64_t version() const { return version_; }
+
+    /**
+     * @brief Индекс компонент связности
+     * @return const ComponentIndex& Индекс
+     */
+    const ComponentIndex& components() const { return components_; }
+
+    /**
+     * @brief Построена ли битовая матрица смежности
+     * @return true если граф плотный
+     */
+    bool isDense() const { return dense_; }
+
+    /**
+     * @brief Битовая матрица смежности
+     * @return const BitMatrix& Матрица (пустая, если граф не плотный)
+     */
+    const BitMatrix& denseGraph() const { return denseGraph_; }
+
+    /**
+     * @brief Перестановка вершин
+     * @return const VertexPermutation& Исходные номера ↔ внутренние (тождественная без перенумерации)
+     */
+    const VertexPermutation& order() const { return order_; }
+
+    /**
+     * @brief Представление графа
+     * @return GraphLayout Способ перенумерации и наличие сжатых списков
+     */
+    GraphLayout layout() const;
+
+    /**
+     * @brief Есть ли сжатые списки соседей
+     *
+     * Сжатые списки заменяют CSR: graph() и reverse() недоступны,
+     * BFS идет по compressed() и compressedReverse()
+     * @return true если снимок построен с GraphLayout::compressed
+     */
+    bool isCompressed() const { return compressedLists_; }
+
+    /**
+     * @brief Сжатые исходящие дуги
+     * @return const CompressedGraph& Сжатый граф (пустой без сжатия)
+     */
+    const CompressedGraph& compressed() const { return compressed_; }
+
+    /**
+     * @brief Сжатые входящие дуги
+     * @return const CompressedGraph& У неориентированного графа - compressed()
+     */
+    const CompressedGraph& compressedReverse() const { return directed_ ? compressedReverse_ : compressed_; }
+
+    /**
+     * @brief Контрольная сумма графа в исходной нумерации
+     * @return std::uint64_t То же, что CSRGraph::checksum() загруженного графа (0 у сжатого снимка)
+     */
+    std::uint64_t sourceChecksum() const {
+        return order_.isIdentity() && !compressedLists_ ? graph().checksum() : sourceChecksum_;
+    }
+
+    /**
+     * @brief Выгодна ли битовая матрица для графа
+     *
+     * Матрица не больше массива соседей CSR и не превышает 256 МБ
+     * @param graph Граф в формате CSR
+     * @return true если граф плотный
+     */
+    static bool isDenseGraph(const CSRGraph& graph);
+
+private:
+    /**
+     * @brief Проверка, что массивы CSR хранятся
+     * @throws std::runtime_error у снимка только со сжатыми списками
+     */
+    void requireArrays() const;
+
+    /**
+     * @brief Память массивов CSR графа
+     * @param graph Граф
+     * @return std::uint64_t Байт смещений, соседей и весов
+     */
+    static std::uint64_t arrayBytes(const CSRGraph& graph);
+};
+
+/**
+ * @class SnapshotStore
+ * @brief Текущая версия графа для читателей и писателей
+ *
+ * Читатели берут current() и работают со своей ссылкой сколько угодно
+ * долго; publish() атомарно подменяет указатель и не ждет читателей.
+ * Писатели упорядочены мьютексом, номера версий возрастают.
+ */
+class SnapshotStore {
+private:
+    std::shared_ptr<const GraphSnapshot> current_;  ///< Только через std::atomic_load/atomic_store
+    std::mutex writerMutex_;
+
+public:
+    /**
+     * @brief Конструктор с первой версией
+     * @param initial Снимок
+     * @throws std::runtime_error если снимок пуст
+     */
+    explicit SnapshotStore(std::shared_ptr<const GraphSnapshot> initial);
+
+    /**
+     * @brief Текущая версия
+     * @return std::shared_ptr<const GraphSnapshot> Снимок (удерживает версию, пока жив)
+     */
+    std::shared_ptr<const GraphSnapshot> current() const;
+
+    /**
+     * @brief Публикация новой версии графа
+     *
+     * Снимок строится до подмены, так что читатели не видят
+     * частично построенную версию. Представление (перенумерация,
+     * сжатие) берется у текущей версии
+     * @param graph Новый граф (в исходной нумерации)
+     * @param cityCount Количество городов
+     * @return std::shared_ptr<const GraphSnapshot> Опубликованный снимок
+     * @throws std::runtime_error если cityCount не совпадает с числом вершин
+     *         или текущая версия ориентированная
+     */
+    std::shared_ptr<const GraphSnapshot> publish(const CSRGraph& graph, int cityCount);
+
+    /**
+     * @brief Публикация новой версии ориентированного графа
+     *
+     * Как publish для неориентированного графа, но снимок хранит
+     * и обратные дуги
+     * @param graph Исходящие и входящие дуги (в исходной нумерации)
+     * @param cityCount Количество городов
+     * @return std::shared_ptr<const GraphSnapshot> Опубликованный снимок
+     * @throws std::runtime_error если cityCount не совпадает с числом вершин
+     *         или текущая версия неориентированная
+     */
+    std::shared_ptr<const GraphSnapshot> publish(const DirectedGraph& graph, int cityCount);
+};
+
+#endif // GRAPH_SNAPSHOT_H
@@ -1,44 +1,590 @@
 /**
  * @file graph_utils.cpp
  * @brief Реализация вспомогательных функций для работы с графами
- * @version 2.3
+ * @version 2.6
  */
 
 #include "graph_utils.h"
+#include "adjacency.h"
+#include "radix_heap.h"
+#include "thread_pool.h"
 #include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
-BFSResult GraphUtils::breadthFirstSearch(const AdjacencyMatrix& graph, int start, int maxDistance) {
-    int n = graph.size();
+namespace {
+    /**
+     * @brief Направление следующего уровня BFS по CSR
+     * @param tuning Пороги переключения
+     * @param bottomUp Направление предыдущего уровня
+     * @param frontierArcs Сумма степеней вершин фронта
+     * @param unvisitedArcs Сумма степеней непосещенных вершин
+     * @param frontierSize Количество вершин фронта
+     * @param n Количество вершин графа
+     * @return true если уровень проходится снизу вверх
+     */
+    bool chooseBottomUp(const BFSTuning& tuning, bool bottomUp, std::int64_t frontierArcs,
+                        std::int64_t unvisitedArcs, std::size_t frontierSize, int n) {
+        if (!tuning.directionOptimizing) {
+            return false;
+        }
+        if (!bottomUp) {
+            return frontierArcs > unvisitedArcs / tuning.alpha;
+        }
+        return frontierSize >= n / tuning.beta;
+    }
+    
+    /**
+     * @struct WorkerFrontier
+     * @brief Локальные данные исполнителя параллельного BFS на уровне
+     */
+    struct WorkerFrontier {
+        std::vector<int> next;        ///< Вершины, захваченные исполнителем
+        std::int64_t edges = 0;       ///< Просмотренные ребра
+        std::int64_t arcs = 0;        ///< Сумма степеней захваченных вершин
+    };
+    
+    /**
+     * @brief Последовательный BFS с переключением направления
+     * @param graph Исходящие дуги
+     * @param parents Входящие дуги (у неориентированного графа - тот же объект)
+     * @param start Стартовая вершина (0-based)
+     * @param maxDistance Максимальное расстояние (количество ребер)
+     * @param tuning Пороги переключения направления
+     * @return BFSResult Результат обхода
+     */
+    template <class Adjacency>
+    BFSResult directionOptimizingSearch(Adjacency& graph, Adjacency& parents, int start, int maxDistance,
+                                        const BFSTuning& tuning) {
+        int n = graph.vertexCount();
+        BFSResult result;
+        result.distances.resize(n, -1);
+        result.reachable = DenseBitset(n);
+        
+        std::vector<int> frontier(1, start);
+        std::vector<int> next;
+        DenseBitset frontierBits;
+        result.distances[start] = 0;
+        result.frontierSizes.push_back(1);
+        
+        // Ребра фронта и ребра еще не посещенных вершин
+        std::int64_t frontierArcs = graph.degree(start);
+        std::int64_t unvisitedArcs = graph.arcCount() - frontierArcs;
+        bool bottomUp = false;
+        
+        for (int level = 1; level <= maxDistance && !frontier.empty(); ++level) {
+            bottomUp = chooseBottomUp(tuning, bottomUp, frontierArcs, unvisitedArcs, frontier.size(), n);
+        
+            next.clear();
+            if (bottomUp) {
+                // Снизу вверх: непосещенная вершина ищет любого соседа во фронте
+                if (frontierBits.size() == 0) {
+                    frontierBits = DenseBitset(n);
+                } else {
+                    frontierBits.clear();
+                }
+                for (int v : frontier) {
+                    frontierBits.set(v);
+                }
+                for (int v = 0; v < n; ++v) {
+                    if (result.distances[v] != -1) {
+                        continue;
+                    }
+                    // Просмотренные дуги считаются один раз на вершину
+                    NeighborRange range = parents.neighbors(v);
+                    const int* it = range.first;
+                    while (it != range.second && !frontierBits.test(*it)) {
+                        ++it;
+                    }
+                    bool found = it != range.second;
+                    result.edgesScanned += (it - range.first) + found;
+                    if (found) {
+                        next.push_back(v);
+                    }
+                }
+                for (int v : next) {
+                    result.distances[v] = level;
+                }
+                ++result.bottomUpLevels;
+            } else {
+                // Сверху вниз: обход соседей вершин фронта
+                for (int current : frontier) {
+                    result.edgesScanned += graph.degree(current);
+                    NeighborRange range = graph.neighbors(current);
+                    for (const int* it = range.first; it != range.second; ++it) {
+                        int neighbor = *it;
+                        if (result.distances[neighbor] == -1) {
+                            result.distances[neighbor] = level;
+                            next.push_back(neighbor);
+                        }
+                    }
+                }
+            }
+        
+            if (next.empty()) {
+                break;
+            }
+        
+            // Добавляем только новые вершины (не стартовый город)
+            frontierArcs = 0;
+            for (int v : next) {
+                result.reachable.set(v);
+                frontierArcs += graph.degree(v);
+            }
+            unvisitedArcs -= frontierArcs;
+            result.frontierSizes.push_back(static_cast<int>(next.size()));
+            frontier.swap(next);
+        }
+        
+        return result;
+    }
+}
+
+BFSResult GraphUtils::breadthFirstSearch(const CSRGraph& graph, int start, int maxDistance) {
+    return breadthFirstSearch(graph, start, maxDistance, BFSTuning());
+}
+
+BFSResult GraphUtils::breadthFirstSearch(const CSRGraph& graph, int start, int maxDistance,
+                                         const BFSTuning& tuning, const CSRGraph* inbound) {
+    CSRAdjacency forward(graph);
+    CSRAdjacency backward(inbound != nullptr ? *inbound : graph);
+    return directionOptimizingSearch(forward, backward, start, maxDistance, tuning);
+}
+
+BFSResult GraphUtils::breadthFirstSearch(const CompressedGraph& graph, int start, int maxDistance,
+                                         const BFSTuning& tuning, const CompressedGraph* inbound) {
+    CompressedAdjacency forward(graph);
+    if (inbound == nullptr) {
+        return directionOptimizingSearch(forward, forward, start, maxDistance, tuning);
+    }
+    CompressedAdjacency backward(*inbound);
+    return directionOptimizingSearch(forward, backward, start, maxDistance, tuning);
+}
+
+BFSResult GraphUtils::parallelBreadthFirstSearch(const CSRGraph& graph, int start, int maxDistance,
+                                                 ThreadPool& pool, const BFSTuning& tuning,
+                                                 const CSRGraph* inbound) {
+    const std::size_t frontierGrain = 256;   // вершин фронта на блок (сверху вниз)
+    const std::size_t vertexGrain = 4096;    // вершин графа на блок (снизу вверх)
+    int n = graph.vertexCount();
+    const CSRGraph& parents = inbound != nullptr ? *inbound : graph;
     BFSResult result;
-    result.distances.resize(n, -1);
+    result.distances.assign(n, -1);
+    int* distances = result.distances.data();
+    
+    std::vector<int> frontier(1, start);
+    std::vector<int> next;
+    std::vector<WorkerFrontier> workers(pool.size());
+    DenseBitset frontierBits;
+    distances[start] = 0;
+    result.frontierSizes.push_back(1);
+    
+    std::int64_t frontierArcs = graph.degree(start);
+    std::int64_t unvisitedArcs = graph.arcCount() - frontierArcs;
+    bool bottomUp = false;
     
-    std::queue<int> q;
-    q.push(start);
+    for (int level = 1; level <= maxDistance && !frontier.empty(); ++level) {
+        bottomUp = chooseBottomUp(tuning, bottomUp, frontierArcs, unvisitedArcs, frontier.size(), n);
+        
+        if (bottomUp) {
+            if (frontierBits.size() == 0) {
+                frontierBits = DenseBitset(n);
+            } else {
+                frontierBits.clear();
+            }
+            for (int v : frontier) {
+                frontierBits.set(v);
+            }
+            // Каждая вершина принадлежит одному блоку - захват без CAS
+            pool.parallelFor(static_cast<std::size_t>(n), vertexGrain,
+                             [&](std::size_t begin, std::size_t end, int worker) {
+                WorkerFrontier& local = workers[worker];
+                std::int64_t edges = 0;
+                for (std::size_t v = begin; v < end; ++v) {
+                    if (distances[v] != -1) {
+                        continue;
+                    }
+                    int vertex = static_cast<int>(v);
+                    const int* begin = parents.neighborsBegin(vertex);
+                    const int* end = parents.neighborsEnd(vertex);
+                    const int* it = begin;
+                    while (it != end && !frontierBits.test(*it)) {
+                        ++it;
+                    }
+                    bool found = it != end;
+                    edges += (it - begin) + found;
+                    if (found) {
+                        distances[v] = level;
+                        local.next.push_back(vertex);
+                        local.arcs += graph.degree(vertex);
+                    }
+                }
+                local.edges += edges;
+            });
+            ++result.bottomUpLevels;
+        } else {
+            // Вершину получает исполнитель, первым заменивший -1 на level
+            pool.parallelFor(frontier.size(), frontierGrain,
+                             [&](std::size_t begin, std::size_t end, int worker) {
+                WorkerFrontier& local = workers[worker];
+                std::int64_t edges = 0;
+                for (std::size_t i = begin; i < end; ++i) {
+                    int current = frontier[i];
+                    edges += graph.degree(current);
+                    for (const int* it = graph.neighborsBegin(current); it != graph.neighborsEnd(current); ++it) {
+                        int* slot = &distances[*it];
+                        int expected = -1;
+                        if (__atomic_load_n(slot, __ATOMIC_RELAXED) == -1 &&
+                            __atomic_compare_exchange_n(slot, &expected, level, false,
+                                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                            local.next.push_back(*it);
+                            local.arcs += graph.degree(*it);
+                        }
+                    }
+                }
+                local.edges += edges;
+            });
+        }
+        
+        // Слияние локальных фронтов
+        next.clear();
+        frontierArcs = 0;
+        for (WorkerFrontier& local : workers) {
+            next.insert(next.end(), local.next.begin(), local.next.end());
+            result.edgesScanned += local.edges;
+            frontierArcs += local.arcs;
+            local.next.clear();
+            local.edges = 0;
+            local.arcs = 0;
+        }
+        
+        if (next.empty()) {
+            break;
+        }
+        unvisitedArcs -= frontierArcs;
+        result.frontierSizes.push_back(static_cast<int>(next.size()));
+        frontier.swap(next);
+    }
+    
+    // Достижимые вершины - все с расстоянием от 1, по 64 за слово
+    result.reachable = DenseBitset(n);
+    std::uint64_t* words = result.reachable.words();
+    pool.parallelFor(result.reachable.wordCount(), 1024,
+                     [&](std::size_t begin, std::size_t end, int) {
+        for (std::size_t w = begin; w < end; ++w) {
+            std::uint64_t bits = 0;
+            std::size_t last = std::min(static_cast<std::size_t>(n), w * 64 + 64);
+            for (std::size_t v = w * 64; v < last; ++v) {
+                bits |= std::uint64_t(distances[v] > 0) << (v & 63);
+            }
+            words[w] = bits;
+        }
+    });
+    
+    return result;
+}
+
+WeightedSearchResult GraphUtils::boundedDijkstra(const CSRGraph& graph, int start, std::int64_t budget) {
+    int n = graph.vertexCount();
+    WeightedSearchResult result;
+    result.distances.assign(n, -1);
+    result.reachable = DenseBitset(n);
+    
+    const std::uint32_t* weights = graph.weightsData();
+    std::vector<std::int64_t>& distances = result.distances;
+    RadixHeap heap;
+    distances[start] = 0;
+    heap.push(0, start);
+    
+    while (!heap.empty()) {
+        std::pair<std::uint64_t, int> top = heap.pop();
+        int current = top.second;
+        std::int64_t distance = static_cast<std::int64_t>(top.first);
+        if (distance != distances[current]) {
+            continue;  // Устаревшая запись: вершина уже извлечена с меньшим ключом
+        }
+        ++result.settled;
+        result.reachable.set(current);
+        
+        const int* begin = graph.neighborsBegin(current);
+        const int* end = graph.neighborsEnd(current);
+        result.edgesScanned += end - begin;
+        const std::uint32_t* weight = weights != nullptr ? graph.weightsBegin(current) : nullptr;
+        for (const int* it = begin; it != end; ++it) {
+            std::int64_t next = distance + (weight != nullptr ? weight[it - begin] : 1);
+            if (next <= budget && (distances[*it] == -1 || next < distances[*it])) {
+                distances[*it] = next;
+                heap.push(static_cast<std::uint64_t>(next), *it);
+            }
+        }
+    }
+    
+    return result;
+}
+
+BFSResult GraphUtils::breadthFirstSearch(const BitMatrix& graph, int start, int maxDistance) {
+    int n = graph.rowCount();
+    std::size_t words = graph.wordsPerRow();
+    BFSResult result;
+    result.distances.resize(n, -1);
     result.distances[start] = 0;
+    result.reachable = DenseBitset(n);
+    
+    std::vector<std::uint64_t> visited(words, 0);
+    std::vector<std::uint64_t> frontier(words, 0);
+    std::vector<std::uint64_t> next(words, 0);
+    visited[start >> 6] |= std::uint64_t(1) << (start & 63);
+    frontier[start >> 6] = visited[start >> 6];
+    result.frontierSizes.push_back(1);
+    
+    for (int level = 1; level <= maxDistance; ++level) {
+        std::fill(next.begin(), next.end(), 0);
+        
+        // Объединение строк всех вершин фронта
+        for (std::size_t w = 0; w < words; ++w) {
+            std::uint64_t bits = frontier[w];
+            while (bits != 0) {
+                int v = static_cast<int>(w * 64) + __builtin_ctzll(bits);
+                bits &= bits - 1;
+                result.edgesScanned += graph.columnCount();
+                const std::uint64_t* row = graph.row(v);
+                for (std::size_t k = 0; k < words; ++k) {
+                    next[k] |= row[k];
+                }
+            }
+        }
+        
+        // Отсечение посещенных и запись расстояний новым вершинам
+        bool grown = false;
+        int frontierSize = 0;
+        for (std::size_t w = 0; w < words; ++w) {
+            std::uint64_t fresh = next[w] & ~visited[w];
+            next[w] = fresh;
+            visited[w] |= fresh;
+            grown |= fresh != 0;
+            frontierSize += __builtin_popcountll(fresh);
+            while (fresh != 0) {
+                int v = static_cast<int>(w * 64) + __builtin_ctzll(fresh);
+                fresh &= fresh - 1;
+                result.distances[v] = level;
+                result.reachable.set(v);
+            }
+        }
+        
+        if (!grown) {
+            break;
+        }
+        result.frontierSizes.push_back(frontierSize);
+        frontier.swap(next);
+    }
+    
+    return result;
+}
+
+namespace {
+    /**
+     * @brief Проход MS-BFS с масками фиксированной ширины
+     * 
+     * Маска вершины занимает Words слов: 64 источника для Words = 1,
+     * 256 для Words = 4 (операции над маской векторизуются компилятором)
+     */
+    template <int Words>
+    bool isZeroMask(const std::uint64_t* mask) {
+        std::uint64_t any = 0;
+        for (int k = 0; k < Words; ++k) {
+            any |= mask[k];
+        }
+        return any == 0;
+    }
+    
+    template <int Words>
+    void runMultiSourceBFS(const CSRGraph& graph, const std::vector<int>& sources,
+                           const std::vector<int>& maxDistances, MultiSourceBFSResult& result) {
+        std::size_t n = static_cast<std::size_t>(graph.vertexCount());
+        std::vector<std::uint64_t>& seen = result.seen;
+        std::vector<std::uint64_t> visit(n * Words, 0);
+        std::vector<std::uint64_t> visitNext(n * Words, 0);
+        std::vector<int> frontier;
+        std::vector<int> nextFrontier;
+        
+        int maxLevel = 0;
+        for (size_t i = 0; i < sources.size(); ++i) {
+            std::size_t s = static_cast<std::size_t>(sources[i]) * Words;
+            if (isZeroMask<Words>(&visit[s])) {
+                frontier.push_back(sources[i]);
+            }
+            seen[s + (i >> 6)] |= std::uint64_t(1) << (i & 63);
+            visit[s + (i >> 6)] |= std::uint64_t(1) << (i & 63);
+            maxLevel = std::max(maxLevel, maxDistances[i]);
+        }
+        result.touched = frontier;
+        
+        for (int level = 1; level <= maxLevel && !frontier.empty(); ++level) {
+            // Источники, которым еще разрешено расширяться на этом уровне
+            std::uint64_t active[Words] = {};
+            for (size_t i = 0; i < sources.size(); ++i) {
+                if (maxDistances[i] >= level) {
+                    active[i >> 6] |= std::uint64_t(1) << (i & 63);
+                }
+            }
+            
+            nextFrontier.clear();
+            for (int v : frontier) {
+                std::size_t vi = static_cast<std::size_t>(v) * Words;
+                std::uint64_t spread[Words];
+                for (int k = 0; k < Words; ++k) {
+                    spread[k] = visit[vi + k] & active[k];
+                }
+                if (isZeroMask<Words>(spread)) {
+                    continue;
+                }
+                
+                for (const int* it = graph.neighborsBegin(v); it != graph.neighborsEnd(v); ++it) {
+                    std::size_t ui = static_cast<std::size_t>(*it) * Words;
+                    std::uint64_t fresh = 0;
+                    std::uint64_t pending = 0;
+                    for (int k = 0; k < Words; ++k) {
+                        std::uint64_t bits = spread[k] & ~seen[ui + k];
+                        pending |= visitNext[ui + k];
+                        visitNext[ui + k] |= bits;
+                        fresh |= bits;
+                    }
+                    if (fresh != 0 && pending == 0) {
+                        nextFrontier.push_back(*it);
+                    }
+                }
+            }
+            
+            // Фиксация уровня: новые биты становятся посещенными
+            for (int v : frontier) {
+                std::size_t vi = static_cast<std::size_t>(v) * Words;
+                for (int k = 0; k < Words; ++k) {
+                    visit[vi + k] = 0;
+                }
+            }
+            for (int v : nextFrontier) {
+                std::size_t vi = static_cast<std::size_t>(v) * Words;
+                if (isZeroMask<Words>(&seen[vi])) {
+                    result.touched.push_back(v);
+                }
+                for (int k = 0; k < Words; ++k) {
+                    seen[vi + k] |= visitNext[vi + k];
+                    visit[vi + k] = visitNext[vi + k];
+                    visitNext[vi + k] = 0;
+                }
+            }
+            frontier.swap(nextFrontier);
+        }
+        
+        std::sort(result.touched.begin(), result.touched.end());
+    }
+}
+
+MultiSourceBFSResult GraphUtils::multiSourceBFS(const CSRGraph& graph, const std::vector<int>& sources,
+                                                const std::vector<int>& maxDistances) {
+    if (sources.size() != maxDistances.size()) {
+        throw std::runtime_error("Количество источников и ограничений расстояния не совпадает");
+    }
+    if (sources.size() > static_cast<size_t>(kMaxSources)) {
+        throw std::runtime_error("Слишком много источников MS-BFS: " + std::to_string(sources.size()));
+    }
+    
+    MultiSourceBFSResult result;
+    result.laneWords = sources.size() <= 64 ? 1 : 4;
+    result.seen.assign(static_cast<std::size_t>(graph.vertexCount()) * result.laneWords, 0);
+    
+    if (result.laneWords == 1) {
+        runMultiSourceBFS<1>(graph, sources, maxDistances, result);
+    } else {
+        runMultiSourceBFS<4>(graph, sources, maxDistances, result);
+    }
+    
+    return result;
+}
+
+CommonReachResult GraphUtils::commonReach(const CSRGraph& graph, const std::vector<int>& sources,
+                                          int maxDistance) {
+    if (sources.empty() || sources.size() > static_cast<size_t>(kMaxCommonSources)) {
+        throw std::runtime_error("Некорректное количество источников: " + std::to_string(sources.size()));
+    }
     
-    // НЕ добавляем стартовый город в достижимые
-    // result.reachable.insert(start); // ЗАКОММЕНТИРОВАНО!
+    std::size_t n = static_cast<std::size_t>(graph.vertexCount());
+    std::uint64_t all = sources.size() == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << sources.size()) - 1;
+    std::vector<std::uint64_t> seen(n, 0);
+    std::vector<std::uint64_t> visit(n, 0);
+    std::vector<std::uint64_t> visitNext(n, 0);
+    std::vector<int> frontier;
+    std::vector<int> nextFrontier;
+    std::vector<int> touched;
     
-    while (!q.empty()) {
-        int current = q.front();
-        q.pop();
+    for (size_t i = 0; i < sources.size(); ++i) {
+        int s = sources[i];
+        if (seen[s] == 0) {
+            frontier.push_back(s);
+            touched.push_back(s);
+        }
+        seen[s] |= std::uint64_t(1) << i;
+        visit[s] |= std::uint64_t(1) << i;
+    }
+    
+    CommonReachResult result;
+    std::uint64_t finished = 0;
+    for (int level = 1; level <= maxDistance && !frontier.empty(); ++level) {
+        // Источники без вершин на границе закончили обход
+        std::uint64_t spreading = 0;
+        for (int v : frontier) {
+            spreading |= visit[v];
+        }
+        if ((all & ~spreading) != finished) {
+            finished = all & ~spreading;
+            bool candidate = false;
+            for (size_t i = 0; i < touched.size() && !candidate; ++i) {
+                candidate = (seen[touched[i]] & finished) == finished;
+            }
+            if (!candidate) {
+                result.touched = touched.size();
+                result.stoppedEarly = true;
+                return result;
+            }
+        }
         
-        // Если достигли максимального расстояния, не идем дальше
-        if (result.distances[current] >= maxDistance) {
-            continue;
+        nextFrontier.clear();
+        for (int v : frontier) {
+            std::uint64_t spread = visit[v];
+            for (const int* it = graph.neighborsBegin(v); it != graph.neighborsEnd(v); ++it) {
+                std::uint64_t bits = spread & ~seen[*it];
+                if (bits != 0 && visitNext[*it] == 0) {
+                    nextFrontier.push_back(*it);
+                }
+                visitNext[*it] |= bits;
+            }
         }
         
-        // Обход соседей
-        for (int neighbor = 0; neighbor < n; ++neighbor) {
-            if (graph[current][neighbor] == 1 && result.distances[neighbor] == -1) {
-                result.distances[neighbor] = result.distances[current] + 1;
-                // Добавляем только соседей (не стартовый город)
-                result.reachable.insert(neighbor);
-                q.push(neighbor);
+        // Фиксация уровня: новые биты становятся посещенными
+        for (int v : frontier) {
+            visit[v] = 0;
+        }
+        for (int v : nextFrontier) {
+            if (seen[v] == 0) {
+                touched.push_back(v);
             }
+            seen[v] |= visitNext[v];
+            visit[v] = visitNext[v];
+            visitNext[v] = 0;
         }
+        frontier.swap(nextFrontier);
+        result.levels = level;
     }
     
+    for (int v : touched) {
+        if (seen[v] == all) {
+            result.vertices.push_back(v);
+        }
+    }
+    std::sort(result.vertices.begin(), result.vertices.end());
+    result.touched = touched.size();
     return result;
 }
 
@@ -50,15 +596,21 @@ bool GraphUtils::isValidL(int L) {
     return L >= 0;
 }
 
-std::vector<int> GraphUtils::findIntersection(const std::set<int>& set1, const std::set<int>& set2) {
-    std::vector<int> intersection;
+std::vector<int> GraphUtils::findIntersection(const DenseBitset& set1, const DenseBitset& set2) {
+    DenseBitset common;
+    std::size_t count = DenseBitset::intersect(set1, set2, common);
     
-    for (int city : set1) {
-        if (set2.find(city) != set2.end()) {
-            intersection.push_back(city);
+    // Размер известен заранее: одно выделение памяти, элементы по возрастанию
+    std::vector<int> intersection;
+    intersection.reserve(count);
+    const std::uint64_t* words = common.words();
+    for (std::size_t w = 0; w < common.wordCount() && intersection.size() < count; ++w) {
+        std::uint64_t bits = words[w];
+        while (bits != 0) {
+            intersection.push_back(static_cast<int>(w * 64 + __builtin_ctzll(bits)));
+            bits &= bits - 1;
         }
     }
     
-    std::sort(intersection.begin(), intersection.end());
     return intersection;
-}
\ No newline at end of file
+}
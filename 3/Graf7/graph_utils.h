@@ -1,23 +1,23 @@
 /**
  * @file graph_utils.h
  * @brief Вспомогательные функции и структуры для работы с графами
- * @version 2.0
+ * @version 2.7
  * 
- * Определяет типы и функции для работы с матрицами смежности и BFS
+ * Определяет типы и функции для работы с графами в формате CSR и BFS
  */
 
 #ifndef GRAPH_UTILS_H
 #define GRAPH_UTILS_H
 
+#include "bit_matrix.h"
+#include "compressed_graph.h"
+#include "csr_graph.h"
+#include "dense_bitset.h"
+#include <cstddef>
+#include <cstdint>
 #include <vector>
-#include <queue>
-#include <set>
 
-/**
- * @typedef AdjacencyMatrix
- * @brief Матрица смежности графа
- */
-using AdjacencyMatrix = std::vector<std::vector<int>>;
+class ThreadPool;
 
 /**
  * @struct BFSResult
@@ -25,18 +25,206 @@ using AdjacencyMatrix = std::vector<std::vector<int>>;
  */
 struct BFSResult {
     std::vector<int> distances;  ///< Расстояния от стартовой вершины
-    std::set<int> reachable;     ///< Множество достижимых вершин
+    DenseBitset reachable;       ///< Множество достижимых вершин (битовое)
+    std::vector<int> frontierSizes;  ///< Размер фронта по уровням (уровень 0 - старт)
+    std::int64_t edgesScanned = 0;   ///< Просмотренные ребра (для битовой матрицы - биты строк)
+    int bottomUpLevels = 0;          ///< Уровни, пройденные снизу вверх
+};
+
+/**
+ * @struct BFSTuning
+ * @brief Параметры переключения направления BFS по спискам соседей
+ * 
+ * Сверху вниз → снизу вверх, когда ребра фронта превышают 1/alpha
+ * ребер непосещенных вершин; обратно, когда во фронте меньше n/beta вершин
+ */
+struct BFSTuning {
+    bool directionOptimizing = true;  ///< false - всегда сверху вниз
+    double alpha = 15.0;              ///< Порог перехода к обходу снизу вверх
+    double beta = 18.0;               ///< Порог возврата к обходу сверху вниз
+};
+
+/**
+ * @struct WeightedSearchResult
+ * @brief Результат поиска кратчайших путей с бюджетом
+ */
+struct WeightedSearchResult {
+    std::vector<std::int64_t> distances;  ///< Время в пути от старта или -1 (дальше бюджета)
+    DenseBitset reachable;                ///< Вершины в пределах бюджета
+    std::int64_t edgesScanned = 0;        ///< Просмотренные дуги
+    std::int64_t settled = 0;             ///< Вершины с окончательным расстоянием
+};
+
+/**
+ * @struct MultiSourceBFSResult
+ * @brief Результат одновременного BFS из нескольких источников
+ * 
+ * Каждому источнику соответствует бит (дорожка) в маске вершины
+ */
+struct MultiSourceBFSResult {
+    int laneWords = 1;                ///< Количество 64-битных слов в маске вершины
+    std::vector<std::uint64_t> seen;  ///< Маски достижимости, vertexCount × laneWords
+    std::vector<int> touched;         ///< Вершины с ненулевой маской (по возрастанию)
+    
+    /**
+     * @brief Достигнута ли вершина из источника
+     * @param vertex Вершина (0-based)
+     * @param lane Номер источника
+     * @return true если вершина в пределах расстояния источника
+     */
+    bool reached(int vertex, int lane) const {
+        return (seen[static_cast<std::size_t>(vertex) * laneWords + (lane >> 6)] >> (lane & 63)) & 1;
+    }
+};
+
+/**
+ * @struct CommonReachResult
+ * @brief Результат поиска вершин, достижимых из всех источников
+ */
+struct CommonReachResult {
+    std::vector<int> vertices;      ///< Вершины, до которых дошли все источники (по возрастанию)
+    int levels = 0;                 ///< Пройдено уровней
+    std::size_t touched = 0;        ///< Вершин, до которых дошел хотя бы один источник
+    bool stoppedEarly = false;      ///< Обход прерван: общих вершин уже не будет
 };
 
 namespace GraphUtils {
     /**
      * @brief Поиск в ширину (BFS) с ограничением по расстоянию
-     * @param graph Матрица смежности
+     * 
+     * Обходит только списки соседей, сложность O(V + E).
+     * Параметры переключения направления - по умолчанию (BFSTuning())
+     * @param graph Граф в формате CSR
+     * @param start Стартовая вершина
+     * @param maxDistance Максимальное расстояние (количество ребер)
+     * @return BFSResult Результат обхода
+     */
+    BFSResult breadthFirstSearch(const CSRGraph& graph, int start, int maxDistance);
+    
+    /**
+     * @brief BFS с переключением направления (direction-optimizing)
+     * 
+     * Пока фронт мал, соседи вершин фронта просматриваются сверху вниз.
+     * Когда фронт разрастается, каждая непосещенная вершина ищет соседа
+     * во фронте (битовое множество) и прекращает поиск на первом найденном -
+     * на графах с малым диаметром это избавляет от повторного просмотра
+     * большинства ребер. У неориентированного графа соседи вершины
+     * и есть ее возможные родители, у ориентированного родители берутся
+     * из входящих дуг (inbound). Расстояния те же, что и без переключения.
+     * @param graph Граф в формате CSR (исходящие дуги)
      * @param start Стартовая вершина
      * @param maxDistance Максимальное расстояние (количество ребер)
+     * @param tuning Пороги переключения
+     * @param inbound Входящие дуги (транспонированный graph); nullptr - граф неориентированный
      * @return BFSResult Результат обхода
      */
-    BFSResult breadthFirstSearch(const AdjacencyMatrix& graph, int start, int maxDistance);
+    BFSResult breadthFirstSearch(const CSRGraph& graph, int start, int maxDistance,
+                                 const BFSTuning& tuning, const CSRGraph* inbound = nullptr);
+    
+    /**
+     * @brief BFS по сжатым спискам соседей
+     * 
+     * Тот же обход с переключением направления; список соседей
+     * распаковывается в буфер при раскрытии вершины, в памяти
+     * остаются только сжатые списки. Результат совпадает с вариантом для CSR
+     * @param graph Сжатый граф (исходящие дуги)
+     * @param start Стартовая вершина
+     * @param maxDistance Максимальное расстояние (количество ребер)
+     * @param tuning Пороги переключения
+     * @param inbound Сжатые входящие дуги; nullptr - граф неориентированный
+     * @return BFSResult Результат обхода
+     */
+    BFSResult breadthFirstSearch(const CompressedGraph& graph, int start, int maxDistance,
+                                 const BFSTuning& tuning, const CompressedGraph* inbound = nullptr);
+    
+    /**
+     * @brief Многопоточный BFS по уровням
+     * 
+     * Фронт уровня делится между исполнителями пула блоками. Сверху вниз
+     * вершина достается исполнителю, первым заменившему -1 на номер уровня
+     * атомарным compare-and-swap в массиве расстояний; снизу вверх каждая
+     * непосещенная вершина принадлежит ровно одному блоку. Новые вершины
+     * копятся в локальных буферах исполнителей и сливаются в конце уровня.
+     * Расстояния и размеры фронтов - те же, что у последовательного BFS.
+     * @param graph Граф в формате CSR
+     * @param start Стартовая вершина
+     * @param maxDistance Максимальное расстояние (количество ребер)
+     * @param pool Пул потоков
+     * @param tuning Пороги переключения направления
+     * @param inbound Входящие дуги (транспонированный graph); nullptr - граф неориентированный
+     * @return BFSResult Результат обхода
+     */
+    BFSResult parallelBreadthFirstSearch(const CSRGraph& graph, int start, int maxDistance,
+                                         ThreadPool& pool, const BFSTuning& tuning = BFSTuning(),
+                                         const CSRGraph* inbound = nullptr);
+    
+    /**
+     * @brief Бит-параллельный BFS по битовой матрице смежности
+     * 
+     * Фронт хранится битовым множеством: следующий фронт - OR строк
+     * всех вершин фронта с маской непосещенных, по 64 вершины за операцию.
+     * Выгоден для плотных графов.
+     * @param graph Битовая матрица смежности
+     * @param start Стартовая вершина
+     * @param maxDistance Максимальное расстояние (количество ребер)
+     * @return BFSResult Результат обхода (тот же, что и у варианта для CSR)
+     */
+    BFSResult breadthFirstSearch(const BitMatrix& graph, int start, int maxDistance);
+    
+    /**
+     * @brief Дейкстра с бюджетом на монотонной поразрядной куче
+     * 
+     * В кучу попадают только вершины с расстоянием не больше budget,
+     * поэтому поиск заканчивается ровно на бюджете и не просматривает
+     * ребра вершин за ним. У невзвешенного графа вес каждого ребра - 1,
+     * и результат совпадает с BFS глубины budget
+     * @param graph Граф в формате CSR (веса - weightsBegin)
+     * @param start Стартовая вершина
+     * @param budget Максимальное время в пути (≥ 0)
+     * @return WeightedSearchResult Расстояния и вершины в пределах бюджета
+     */
+    WeightedSearchResult boundedDijkstra(const CSRGraph& graph, int start, std::int64_t budget);
+    
+    /**
+     * @brief Одновременный BFS из нескольких источников (MS-BFS)
+     * 
+     * Каждая вершина хранит маску источников, которые до нее дошли;
+     * один проход по ребрам уровня продвигает все источники сразу.
+     * Источник i перестает расширяться после maxDistances[i] ребер.
+     * @param graph Граф в формате CSR
+     * @param sources Стартовые вершины (не более kMaxSources)
+     * @param maxDistances Максимальное расстояние для каждого источника
+     * @return MultiSourceBFSResult Маски достижимости
+     * @throws std::runtime_error при несогласованных размерах или слишком многих источниках
+     */
+    MultiSourceBFSResult multiSourceBFS(const CSRGraph& graph, const std::vector<int>& sources,
+                                        const std::vector<int>& maxDistances);
+    
+    /**
+     * @brief Максимальное количество источников одного прохода MS-BFS
+     */
+    const int kMaxSources = 256;
+    
+    /**
+     * @brief Вершины в пределах maxDistance от каждого источника
+     * 
+     * Один проход MS-BFS с 64-битной маской источников у вершины.
+     * Источник, граница которого опустела, больше битов не добавит,
+     * поэтому вершины без его бита выбывают; когда не остается ни
+     * одной вершины со всеми битами завершившихся источников, обход
+     * прерывается с пустым ответом
+     * @param graph Граф в формате CSR
+     * @param sources Стартовые вершины (1..kMaxCommonSources, без повторов)
+     * @param maxDistance Максимальное расстояние (количество ребер)
+     * @return CommonReachResult Общие вершины (источники - если до них дошли остальные)
+     * @throws std::runtime_error при неверном количестве источников
+     */
+    CommonReachResult commonReach(const CSRGraph& graph, const std::vector<int>& sources, int maxDistance);
+    
+    /**
+     * @brief Максимальное количество источников commonReach
+     */
+    const int kMaxCommonSources = 64;
     
     /**
      * @brief Проверка корректности номера города
@@ -55,11 +243,14 @@ namespace GraphUtils {
     
     /**
      * @brief Поиск пересечения двух множеств
+     * 
+     * Словарное AND с подсчетом popcount, затем извлечение элементов
+     * по count-trailing-zeros - результат уже отсортирован
      * @param set1 Первое множество
      * @param set2 Второе множество
      * @return std::vector<int> Отсортированный вектор общих элементов
      */
-    std::vector<int> findIntersection(const std::set<int>& set1, const std::set<int>& set2);
+    std::vector<int> findIntersection(const DenseBitset& set1, const DenseBitset& set2);
 }
 
 #endif // GRAPH_UTILS_H
\ No newline at end of file
@@ -1,16 +1,29 @@
 /**
  * @file main.cpp
  * @brief Основная программа анализатора графа
- * @version 2.1
+ * @version 3.1
  * 
  * Главный модуль программы для поиска общих городов
  * между двумя штаб-квартирами корпораций
  */
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "external_analyzer.h"
 #include "graph_reader.h"
 #include "graph_analyzer.h"
+#include "partitioned_analyzer.h"
+#include "query_server.h"
+#include "reachability_index.h"
+#include "thread_pool.h"
+#include <unistd.h>
 
 /**
  * @brief Вывод результата
@@ -35,51 +48,666 @@ void printResult(const std::vector<int>& result) {
  * @param cities Множество городов (0-based)
  * @param name Название множества
  */
-void printReachableCities(const std::set<int>& cities, const std::string& name) {
+void printReachableCities(const DenseBitset& cities, const std::string& name) {
     std::cout << name << ": ";
-    for (int city : cities) {
+    cities.forEach([](int city) {
         std::cout << (city + 1) << " ";
-    }
+    });
     std::cout << std::endl;
 }
 
 /**
  * @brief Вывод информации о графе
- * @param cityCount Количество городов
- * @param matrix Матрица смежности
+ * @param snapshot Снимок графа (у ориентированного списки - исходящие дуги)
  */
-void printGraphInfo(int cityCount, const AdjacencyMatrix& matrix) {
+void printGraphInfo(const GraphSnapshot& snapshot) {
+    const VertexPermutation& order = snapshot.order();
+    int cityCount = snapshot.cityCount();
     std::cout << "=== АНАЛИЗ ГРАФА ГОРОДОВ ===" << std::endl;
     std::cout << "Количество городов: " << cityCount << std::endl;
+    if (snapshot.isDirected()) {
+        std::cout << "Количество дорог с односторонним движением (дуг): " << snapshot.arcCount() << std::endl;
+    } else {
+        std::cout << "Количество дорог: " << snapshot.arcCount() / 2 << std::endl;
+    }
     std::cout << std::endl;
     
-    std::cout << "Матрица смежности:" << std::endl;
+    // Списки смежности печатаются только для небольших графов
+    const int maxPrintedCities = 25;
+    if (cityCount > maxPrintedCities) {
+        return;
+    }
+    
+    // Списки печатаются в исходной нумерации городов
+    std::cout << "Списки смежности:" << std::endl;
     for (int i = 0; i < cityCount; ++i) {
-        for (int j = 0; j < cityCount; ++j) {
-            std::cout << matrix[i][j] << " ";
+        int vertex = order.toInternal(i);
+        std::vector<int> cities;
+        if (snapshot.isCompressed()) {
+            cities.resize(snapshot.compressed().degree(vertex));
+            snapshot.compressed().decode(vertex, cities.data());
+        } else {
+            const CSRGraph& graph = snapshot.graph();
+            cities.assign(graph.neighborsBegin(vertex), graph.neighborsEnd(vertex));
+        }
+        for (int& city : cities) {
+            city = order.toOriginal(city);
+        }
+        std::sort(cities.begin(), cities.end());
+        std::cout << (i + 1) << ": ";
+        for (int city : cities) {
+            std::cout << (city + 1) << " ";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @struct ProgramOptions
+ * @brief Параметры командной строки
+ */
+struct ProgramOptions {
+    std::string filename = "cities.txt";  ///< Текстовый граф или двоичный снимок
+    std::string snapshotOutput;           ///< Куда сохранить снимок (пусто - не сохранять)
+    bool verifySnapshot = false;          ///< Проверить контрольные суммы снимка и индекса (--verify-snapshot)
+    Verbosity verbosity = Verbosity::Silent;  ///< Уровень диагностики (-v, -vv)
+    bool serveStdin = false;              ///< Режим сервера: запросы из stdin (--serve)
+    std::string socketPath;               ///< Режим сервера: Unix-сокет (--socket путь)
+    int sweepMaxL = -1;                   ///< Ответы для всех L = 0..sweepMaxL (--sweep)
+    int threadCount = -1;                 ///< Потоки BFS (--threads, -1 - по размеру графа)
+    int indexMaxL = -1;                   ///< Построить индекс достижимости для L = 0..indexMaxL
+    int matrixL = -1;                     ///< L матрицы размеров общих зон (--common-matrix)
+    std::string matrixOutput;             ///< Файл матрицы размеров общих зон
+    long long budget = -1;                ///< Бюджет времени в пути (--budget, -1 - запрос по L)
+    bool directed = false;                ///< Ориентированный граф (--directed)
+    ReachMode mode = ReachMode::FromBoth; ///< Направление достижимости (--mode from|to|mixed)
+    GraphLayout layout;                   ///< Перенумерация (--reorder none|degree|bfs|rcm) и сжатие (--compress)
+    std::size_t externalMegabytes = 0;    ///< Бюджет памяти внешнего BFS (--external МБ, 0 - граф в памяти)
+    std::string tempDirectory;            ///< Каталог временных файлов (--temp-dir)
+    int workerCount = 0;                  ///< Процессы распределенного BFS (--workers N, 0 - один процесс)
+    int headquarterCount = 0;             ///< Штаб-квартир в запросе (--headquarters M, 0 - две: K1 и K2)
+    int neighborhoodL = -1;               ///< L оценок окрестностей всех городов (--neighborhood-sizes)
+    std::string neighborhoodOutput;       ///< Файл оценок окрестностей
+    double estimateError = 0.1;           ///< Относительная погрешность оценок (--estimate-error)
+};
+
+/**
+ * @brief Разбор параметров командной строки
+ * 
+ * graph_analyzer [файл] [--save-snapshot снимок] [--verify-snapshot] [-v | -vv] [--threads N] [--reorder none|degree|bfs|rcm]
+ *                [--compress] [--directed [--mode from|to|mixed]] [--build-index Lmax] [--serve | --socket путь | --sweep Lmax |
+ *                 --budget T | --common-matrix L файл | --external МБ [--temp-dir каталог] | --workers N | --headquarters M |
+ *                 --neighborhood-sizes L файл [--estimate-error e]]
+ * @param argc Количество аргументов
+ * @param argv Аргументы
+ * @return ProgramOptions Разобранные параметры
+ * @throws std::runtime_error при неизвестном параметре
+ */
+ProgramOptions parseArguments(int argc, char* argv[]) {
+    ProgramOptions options;
+    bool filenameSet = false;
+    
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--save-snapshot" && i + 1 < argc) {
+            options.snapshotOutput = argv[++i];
+        } else if (arg == "--verify-snapshot") {
+            options.verifySnapshot = true;
+        } else if (arg == "--serve") {
+            options.serveStdin = true;
+        } else if (arg == "--socket" && i + 1 < argc) {
+            options.socketPath = argv[++i];
+        } else if (arg == "--sweep" && i + 1 < argc) {
+            options.sweepMaxL = std::stoi(argv[++i]);
+            if (!GraphUtils::isValidL(options.sweepMaxL)) {
+                throw std::runtime_error("Некорректное значение Lmax: " + std::string(argv[i]));
+            }
+        } else if (arg == "--budget" && i + 1 < argc) {
+            options.budget = std::stoll(argv[++i]);
+            if (options.budget < 0) {
+                throw std::runtime_error("Некорректный бюджет времени: " + std::string(argv[i]));
+            }
+        } else if (arg == "--directed") {
+            options.directed = true;
+        } else if (arg == "--mode" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "from") {
+                options.mode = ReachMode::FromBoth;
+            } else if (mode == "to") {
+                options.mode = ReachMode::ToBoth;
+            } else if (mode == "mixed") {
+                options.mode = ReachMode::Mixed;
+            } else {
+                throw std::runtime_error("Неизвестный режим: " + mode + " (from, to или mixed)");
+            }
+        } else if (arg == "--reorder" && i + 1 < argc) {
+            options.layout.order = VertexPermutation::parseOrder(argv[++i]);
+        } else if (arg == "--compress") {
+            options.layout.compressed = true;
+        } else if (arg == "--external" && i + 1 < argc) {
+            long long megabytes = std::stoll(argv[++i]);
+            if (megabytes < static_cast<long long>(ExternalAnalyzer::kMinMemoryBudget >> 20)) {
+                throw std::runtime_error("Некорректный бюджет памяти: " + std::string(argv[i]));
+            }
+            options.externalMegabytes = static_cast<std::size_t>(megabytes);
+        } else if (arg == "--temp-dir" && i + 1 < argc) {
+            options.tempDirectory = argv[++i];
+        } else if (arg == "--workers" && i + 1 < argc) {
+            options.workerCount = std::stoi(argv[++i]);
+            if (options.workerCount < 1 || options.workerCount > PartitionedAnalyzer::kMaxWorkers) {
+                throw std::runtime_error("Некорректное количество процессов: " + std::string(argv[i]));
+            }
+        } else if (arg == "--headquarters" && i + 1 < argc) {
+            options.headquarterCount = std::stoi(argv[++i]);
+            if (options.headquarterCount < 2 || options.headquarterCount > GraphUtils::kMaxCommonSources) {
+                throw std::runtime_error("Некорректное количество штаб-квартир: " + std::string(argv[i]));
+            }
+        } else if (arg == "--neighborhood-sizes" && i + 2 < argc) {
+            options.neighborhoodL = std::stoi(argv[++i]);
+            if (!GraphUtils::isValidL(options.neighborhoodL)) {
+                throw std::runtime_error("Некорректное значение L: " + std::string(argv[i]));
+            }
+            options.neighborhoodOutput = argv[++i];
+        } else if (arg == "--estimate-error" && i + 1 < argc) {
+            options.estimateError = std::stod(argv[++i]);
+            NeighborhoodEstimator::precisionFor(options.estimateError);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.threadCount = std::stoi(argv[++i]);
+            if (options.threadCount < 0) {
+                throw std::runtime_error("Некорректное количество потоков: " + std::string(argv[i]));
+            }
+        } else if (arg == "--build-index" && i + 1 < argc) {
+            options.indexMaxL = std::stoi(argv[++i]);
+            if (!GraphUtils::isValidL(options.indexMaxL)) {
+                throw std::runtime_error("Некорректное значение Lmax: " + std::string(argv[i]));
+            }
+        } else if (arg == "--common-matrix" && i + 2 < argc) {
+            options.matrixL = std::stoi(argv[++i]);
+            if (!GraphUtils::isValidL(options.matrixL)) {
+                throw std::runtime_error("Некорректное значение L: " + std::string(argv[i]));
+            }
+            options.matrixOutput = argv[++i];
+        } else if (arg == "-v") {
+            options.verbosity = Verbosity::Summary;
+        } else if (arg == "-vv") {
+            options.verbosity = Verbosity::Trace;
+        } else if (!arg.empty() && arg[0] != '-' && !filenameSet) {
+            options.filename = arg;
+            filenameSet = true;
+        } else {
+            throw std::runtime_error("Неизвестный параметр: " + arg);
+        }
+    }
+    
+    // Внешний BFS читает снимок как есть: перенумерация, сжатие
+    // и остальные режимы к нему не применяются
+    if (options.externalMegabytes > 0 &&
+        (options.directed || options.verifySnapshot || options.serveStdin || !options.socketPath.empty() || options.sweepMaxL >= 0 ||
+         options.budget >= 0 || options.matrixL >= 0 || options.indexMaxL >= 0 ||
+         options.layout.order != VertexOrder::Original || options.layout.compressed ||
+         options.mode != ReachMode::FromBoth || options.workerCount > 0 || options.headquarterCount > 0 ||
+         options.neighborhoodL >= 0)) {
+        throw std::runtime_error("--external поддерживает только запрос K1 K2 L по неориентированному графу "
+                                 "без --reorder и --compress");
+    }
+    if (options.workerCount > 0 &&
+        (options.externalMegabytes > 0 || options.layout.compressed || options.serveStdin ||
+         !options.socketPath.empty() || options.sweepMaxL >= 0 || options.budget >= 0 ||
+         options.matrixL >= 0 || options.indexMaxL >= 0)) {
+        throw std::runtime_error("--workers поддерживает только запрос K1 K2 L по несжатому графу в памяти");
+    }
+    if (options.headquarterCount > 0 &&
+        (options.externalMegabytes > 0 || options.workerCount > 0 || options.serveStdin ||
+         !options.socketPath.empty() || options.sweepMaxL >= 0 || options.budget >= 0 ||
+         options.matrixL >= 0 || options.mode != ReachMode::FromBoth)) {
+        throw std::runtime_error("--headquarters поддерживает только запрос по L в режиме from");
+    }
+    // Сжатый снимок не хранит CSR: доступны только одиночные BFS
+    if (options.layout.compressed &&
+        (options.serveStdin || !options.socketPath.empty() || options.budget >= 0 || options.matrixL >= 0 ||
+         options.indexMaxL >= 0 || options.headquarterCount > 0 || options.neighborhoodL >= 0)) {
+        throw std::runtime_error("--compress поддерживает только запрос K1 K2 L и --sweep");
+    }
+    if (options.mode != ReachMode::FromBoth &&
+        (options.serveStdin || !options.socketPath.empty() || options.sweepMaxL >= 0 ||
+         options.budget >= 0 || options.matrixL >= 0)) {
+        throw std::runtime_error("--mode to|mixed поддерживается только запросом K1 K2 L");
+    }
+    if (options.sweepMaxL >= 0 && (options.serveStdin || !options.socketPath.empty())) {
+        throw std::runtime_error("--sweep несовместим с режимом сервера");
+    }
+    if (options.budget >= 0 && (options.sweepMaxL >= 0 || options.serveStdin || !options.socketPath.empty())) {
+        throw std::runtime_error("--budget несовместим с --sweep и режимом сервера");
+    }
+    if (options.matrixL >= 0 && (options.sweepMaxL >= 0 || options.budget >= 0)) {
+        throw std::runtime_error("--common-matrix несовместим с --sweep и --budget");
+    }
+    if (options.neighborhoodL >= 0 &&
+        (options.externalMegabytes > 0 || options.workerCount > 0 || options.headquarterCount > 0 ||
+         options.serveStdin || !options.socketPath.empty() || options.matrixL >= 0 ||
+         options.sweepMaxL >= 0 || options.budget >= 0 || options.indexMaxL >= 0 ||
+         options.mode != ReachMode::FromBoth)) {
+        throw std::runtime_error("--neighborhood-sizes несовместим с другими режимами запросов");
+    }
+    
+    return options;
+}
+
+/**
+ * @brief Запись двоичного снимка графа, если он запрошен (--save-snapshot)
+ * @param options Параметры командной строки
+ * @param graph Загруженный граф (у ориентированного - исходящие дуги)
+ */
+void saveSnapshot(const ProgramOptions& options, const CSRGraph& graph) {
+    if (!options.snapshotOutput.empty()) {
+        GraphReader::writeSnapshot(graph, options.snapshotOutput, options.directed);
+        std::cerr << "Снимок графа сохранен: " << options.snapshotOutput << std::endl;
+    }
+}
+
+/**
+ * @brief Индекс достижимости для графа
+ * 
+ * С --build-index индекс строится и сохраняется рядом с файлом графа,
+ * иначе загружается оттуда, если он есть и построен для этого графа
+ * @param options Параметры командной строки
+ * @param graph Граф снимка (во внутренней нумерации, если вершины перенумерованы)
+ * @return ReachabilityIndex Индекс (пустой, если его нет)
+ */
+ReachabilityIndex prepareReachabilityIndex(const ProgramOptions& options, const CSRGraph& graph) {
+    std::string indexPath = ReachabilityIndex::pathFor(options.filename);
+    
+    if (options.indexMaxL >= 0) {
+        ThreadPool pool(std::max(options.threadCount, 0));
+        ReachabilityIndex index = ReachabilityIndex::build(graph, options.indexMaxL, &pool);
+        index.save(indexPath);
+        std::cerr << "Индекс достижимости сохранен: " << indexPath << " ("
+                  << index.memoryBytes() / (1024 * 1024) << " МБ, L = 0.."
+                  << (index.saturated() ? std::string("∞") : std::to_string(index.levelCount() - 1))
+                  << ")" << std::endl;
+        return index;
+    }
+    
+    if (!std::ifstream(indexPath).good()) {
+        return ReachabilityIndex();
+    }
+    try {
+        return ReachabilityIndex::load(indexPath, graph, options.verifySnapshot);
+    } catch (const std::exception& e) {
+        std::cerr << "Индекс достижимости не используется: " << e.what() << std::endl;
+        return ReachabilityIndex();
+    }
+}
+
+/**
+ * @brief Настройка анализатора по параметрам командной строки
+ * @param analyzer Анализатор
+ * @param options Параметры
+ * @param index Индекс достижимости (может быть пустым)
+ */
+void configureAnalyzer(GraphAnalyzer& analyzer, const ProgramOptions& options,
+                       const ReachabilityIndex& index) {
+    analyzer.diagnostics().setVerbosity(options.verbosity);
+    if (options.threadCount >= 0) {
+        analyzer.setThreadCount(options.threadCount);
+    }
+    analyzer.setReachabilityIndex(index);
+}
+
+/**
+ * @brief Оценки окрестностей всех городов в текстовый файл (--neighborhood-sizes)
+ * 
+ * Строка файла - "город оценка"; сводка с функцией окрестностей
+ * по раундам печатается в stderr
+ * @param analyzer Анализатор
+ * @param options Параметры командной строки
+ * @throws std::runtime_error при ошибке записи
+ */
+void writeNeighborhoodSizes(GraphAnalyzer& analyzer, const ProgramOptions& options) {
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    NeighborhoodEstimate estimate = analyzer.estimateNeighborhoodSizes(options.neighborhoodL, options.estimateError);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    
+    std::ofstream output(options.neighborhoodOutput);
+    output << std::fixed << std::setprecision(1);
+    for (std::size_t city = 0; city < estimate.sizes.size(); ++city) {
+        output << city + 1 << " " << estimate.sizes[city] << "\n";
+    }
+    output.flush();
+    if (!output) {
+        throw std::runtime_error("Ошибка записи файла: " + options.neighborhoodOutput);
+    }
+    
+    std::cerr << "Оценки окрестностей (L = " << options.neighborhoodL << ", 2^" << estimate.precision
+              << " регистров, погрешность " << std::setprecision(1) << std::fixed
+              << 100.0 * estimate.relativeError << "%) сохранены: "
+              << options.neighborhoodOutput << " за " << std::setprecision(2) << seconds << " с" << std::endl;
+    for (std::size_t round = 1; round < estimate.totals.size(); ++round) {
+        std::cerr << "  раунд " << round << ": в среднем " << estimate.totals[round] / estimate.sizes.size()
+                  << " городов" << std::endl;
+    }
+    std::cerr.unsetf(std::ios::fixed);
+}
+
+/**
+ * @brief Объем ввода-вывода одной строкой
+ * @param io Счетчики
+ * @return std::string "прочитано X МБ, записано Y МБ, переходов Z"
+ */
+std::string describeIO(const IOCounters& io) {
+    char text[128];
+    std::snprintf(text, sizeof(text), "прочитано %.2f МБ, записано %.2f МБ, переходов %llu",
+                  io.bytesRead / (1024.0 * 1024.0), io.bytesWritten / (1024.0 * 1024.0),
+                  static_cast<unsigned long long>(io.seeks));
+    return text;
+}
+
+/**
+ * @brief Отчет о внешнем BFS по уровням (в stderr)
+ * @param name Название обхода
+ * @param stats Статистика обхода
+ */
+void printExternalSearch(const std::string& name, const ExternalSearchStats& stats) {
+    std::cerr << name << ":" << std::endl;
+    for (std::size_t level = 0; level < stats.levels.size(); ++level) {
+        std::cerr << "  уровень " << level << ": " << stats.levels[level].frontierSize << " вершин";
+        if (level > 0) {
+            std::cerr << ", " << describeIO(stats.levels[level].io);
+        }
+        std::cerr << std::endl;
+    }
+    std::cerr << "  слияние уровней: " << describeIO(stats.collect) << std::endl;
+}
+
+/**
+ * @brief Запрос без загрузки графа в память (--external)
+ * 
+ * Текстовый список ребер сначала преобразуется в снимок с тем же
+ * бюджетом памяти: в файл --save-snapshot или во временный файл,
+ * который удаляется после запроса
+ * @param options Параметры командной строки
+ * @return int Код завершения
+ */
+int runExternal(const ProgramOptions& options) {
+    std::size_t memoryBudget = options.externalMegabytes << 20;
+    std::string snapshotFile = options.filename;
+    std::string temporaryFile;
+    if (!GraphReader::isSnapshot(options.filename)) {
+        snapshotFile = options.snapshotOutput;
+        if (snapshotFile.empty()) {
+            temporaryFile = DiskFile::temporaryDirectory(options.tempDirectory) + "/graf7-" +
+                            std::to_string(getpid()) + ".bin";
+            snapshotFile = temporaryFile;
+        }
+        IOCounters io = GraphReader::convertToSnapshot(options.filename, snapshotFile, memoryBudget,
+                                                       options.tempDirectory);
+        std::cerr << "Снимок для внешнего BFS: " << snapshotFile << " (" << describeIO(io) << ")" << std::endl;
+    }
+    
+    try {
+        ExternalAnalyzer analyzer(snapshotFile, memoryBudget, options.tempDirectory);
+        std::cout << "Граф на диске: " << analyzer.cityCount() << " городов, " << analyzer.arcCount()
+                  << " дуг; бюджет памяти " << options.externalMegabytes << " МБ" << std::endl;
+        std::cout << std::endl;
+        
+        int k1, k2, L;
+        std::cout << "Введите номера городов для штаб-квартир K1 и K2 (1-"
+                  << analyzer.cityCount() << "): ";
+        std::cin >> k1 >> k2;
+        std::cout << "Введите максимальное количество промежуточных городов L: ";
+        std::cin >> L;
+        if (std::cin.fail()) {
+            throw std::runtime_error("Ошибка ввода данных");
         }
+        
+        ExternalQueryStats stats;
+        std::vector<int> result = analyzer.findCommonCities(k1, k2, L, &stats);
+        if (options.verbosity != Verbosity::Silent) {
+            printExternalSearch("Внешний BFS из K1=" + std::to_string(k1), stats.fromK1);
+            printExternalSearch("Внешний BFS из K2=" + std::to_string(k2), stats.fromK2);
+            std::cerr << "Пересечение: " << describeIO(stats.intersect) << std::endl;
+            std::cerr << "Всего: " << describeIO(stats.total()) << " за " << stats.seconds << " с" << std::endl;
+        }
+        
         std::cout << std::endl;
+        std::cout << "РЕЗУЛЬТАТ:" << std::endl;
+        std::cout << "Города, достижимые из обоих штаб-квартир K1=" << k1 << " и K2=" << k2
+                  << " (максимум " << L << " промежуточных городов):" << std::endl;
+        printResult(result);
+    } catch (...) {
+        if (!temporaryFile.empty()) {
+            std::remove(temporaryFile.c_str());
+        }
+        throw;
+    }
+    
+    if (!temporaryFile.empty()) {
+        std::remove(temporaryFile.c_str());
+    }
+    return 0;
+}
+
+/**
+ * @brief Заголовок результата запроса K1 K2 L
+ * @param options Параметры командной строки (направление достижимости)
+ * @param k1 Первая штаб-квартира
+ * @param k2 Вторая штаб-квартира
+ * @param L Максимальное количество промежуточных городов
+ */
+void printResultHeading(const ProgramOptions& options, int k1, int k2, int L) {
+    std::cout << "РЕЗУЛЬТАТ:" << std::endl;
+    if (!options.directed || options.mode == ReachMode::FromBoth) {
+        std::cout << "Города, достижимые из обоих штаб-квартир ";
+    } else if (options.mode == ReachMode::ToBoth) {
+        std::cout << "Города, из которых достижимы обе штаб-квартиры ";
+    } else {
+        std::cout << "Города, достижимые из K1, из которых достижима K2: ";
+    }
+    std::cout << "K1=" << k1 << " и K2=" << k2;
+    std::cout << " (максимум " << L << " промежуточных городов):" << std::endl;
+}
+
+/**
+ * @brief Отчет о распределенном BFS по уровням (в stderr)
+ * @param name Название обхода
+ * @param levels Уровни (суммы по процессам)
+ */
+void printPartitionedSearch(const std::string& name, const std::vector<PartitionLevelStats>& levels) {
+    std::cerr << name << ":" << std::endl;
+    for (std::size_t level = 0; level < levels.size(); ++level) {
+        std::cerr << "  уровень " << level << ": " << levels[level].frontierSize << " вершин, передано "
+                  << levels[level].bytesSent << " байт" << std::endl;
+    }
+}
+
+/**
+ * @brief Запрос на процессах-владельцах частей графа (--workers)
+ * 
+ * Процессы запускаются до создания потоков и живут до конца запроса
+ * @param options Параметры командной строки
+ * @param snapshot Снимок загруженного графа
+ * @return int Код завершения
+ */
+int runPartitioned(const ProgramOptions& options, const std::shared_ptr<const GraphSnapshot>& snapshot) {
+    PartitionedAnalyzer analyzer(snapshot, options.workerCount);
+    std::cout << "Процессов BFS: " << analyzer.workerCount() << std::endl;
+    if (options.verbosity != Verbosity::Silent) {
+        const std::vector<int>& bounds = analyzer.bounds();
+        const std::int64_t* offsets = snapshot->graph().offsetsData();
+        for (int p = 0; p < analyzer.workerCount(); ++p) {
+            std::cerr << "  процесс " << p << ": " << bounds[p + 1] - bounds[p] << " вершин, "
+                      << offsets[bounds[p + 1]] - offsets[bounds[p]] << " дуг" << std::endl;
+        }
     }
     std::cout << std::endl;
+    
+    int k1, k2, L;
+    std::cout << "Введите номера городов для штаб-квартир K1 и K2 (1-"
+              << snapshot->cityCount() << "): ";
+    std::cin >> k1 >> k2;
+    std::cout << "Введите максимальное количество промежуточных городов L: ";
+    std::cin >> L;
+    if (std::cin.fail()) {
+        throw std::runtime_error("Ошибка ввода данных");
+    }
+    
+    PartitionedQueryStats stats;
+    std::vector<int> result = analyzer.findCommonCities(k1, k2, L, options.mode, &stats);
+    if (options.verbosity != Verbosity::Silent) {
+        printPartitionedSearch("Распределенный BFS из K1=" + std::to_string(k1), stats.fromK1);
+        printPartitionedSearch("Распределенный BFS из K2=" + std::to_string(k2), stats.fromK2);
+        std::cerr << "Всего передано границ: " << stats.totalBytes() / 1024.0 << " КБ за "
+                  << stats.seconds << " с" << std::endl;
+    }
+    
+    std::cout << std::endl;
+    printResultHeading(options, k1, k2, L);
+    printResult(result);
+    
+    std::cout << std::endl;
+    std::cout << "Программа завершена успешно." << std::endl;
+    return 0;
 }
 
 /**
  * @brief Основная функция программы
+ * @param argc Количество аргументов
+ * @param argv Аргументы командной строки
  * @return Код завершения программы
  */
-int main() {
+int main(int argc, char* argv[]) {
     try {
-        std::string filename = "cities.txt";
+        ProgramOptions options = parseArguments(argc, argv);
         
-        // Чтение графа из файла
+        // Граф не загружается: BFS читает снимок с диска
+        if (options.externalMegabytes > 0) {
+            return runExternal(options);
+        }
+        
+        // Чтение графа из файла (текст или двоичный снимок);
+        // у ориентированного графа обратные дуги строятся здесь же.
+        // Двоичный снимок пишется в исходной нумерации, до перенумерации.
+        // Со --compress граф читается сразу в сжатые списки, если
+        // снимок не нужно писать из CSR
         int cityCount;
-        AdjacencyMatrix graph = GraphReader::readFromFile(filename, cityCount);
+        LoadStats loadStats;
+        std::shared_ptr<const GraphSnapshot> snapshot;
+        if (options.layout.compressed && options.snapshotOutput.empty()) {
+            CompressedGraph loaded = GraphReader::readCompressedFromFile(options.filename, cityCount, &loadStats,
+                                                                         options.directed, options.verifySnapshot);
+            snapshot = GraphSnapshot::createCompressed(std::move(loaded), options.directed, cityCount,
+                                                       options.layout.order);
+        } else if (options.directed) {
+            DirectedGraph loaded = GraphReader::readDirectedFromFile(options.filename, cityCount, &loadStats,
+                                                                     options.verifySnapshot);
+            saveSnapshot(options, loaded.forward);
+            snapshot = GraphSnapshot::createDirected(loaded, cityCount, options.layout);
+        } else {
+            CSRGraph loaded = GraphReader::readFromFile(options.filename, cityCount, &loadStats,
+                                                      options.verifySnapshot);
+            saveSnapshot(options, loaded);
+            snapshot = GraphSnapshot::create(loaded, cityCount, options.layout);
+        }
+        
+        // Индекс сверяется с CSR, которого у сжатого снимка нет
+        ReachabilityIndex reachIndex = snapshot->isCompressed()
+            ? ReachabilityIndex() : prepareReachabilityIndex(options, snapshot->graph());
+        
+        // Режим сервера: граф остается в памяти, stdout занят ответами
+        if (options.serveStdin || !options.socketPath.empty()) {
+            GraphAnalyzer analyzer(snapshot);
+            configureAnalyzer(analyzer, options, reachIndex);
+            QueryServer server(analyzer);
+            
+            std::cerr << "Граф загружен: " << cityCount << " городов за "
+                      << loadStats.seconds << " с" << std::endl;
+            if (options.serveStdin) {
+                server.serveStream(STDIN_FILENO, STDOUT_FILENO);
+            } else {
+                std::cerr << "Ожидание запросов на сокете " << options.socketPath << std::endl;
+                server.serveSocket(options.socketPath);
+            }
+            return 0;
+        }
+        
+        // Размеры общих зон всех пар: только в файл, stdout не используется
+        if (!options.matrixOutput.empty()) {
+            GraphAnalyzer analyzer(snapshot);
+            configureAnalyzer(analyzer, options, reachIndex);
+            analyzer.writeCommonZoneSizes(options.matrixL, options.matrixOutput);
+            std::cerr << "Матрица размеров общих зон (L = " << options.matrixL
+                      << ") сохранена: " << options.matrixOutput << std::endl;
+            return 0;
+        }
+        
+        // Оценки окрестностей всех городов: только в файл, stdout не используется
+        if (!options.neighborhoodOutput.empty()) {
+            GraphAnalyzer analyzer(snapshot);
+            configureAnalyzer(analyzer, options, reachIndex);
+            writeNeighborhoodSizes(analyzer, options);
+            return 0;
+        }
         
         // Вывод информации о графе
-        printGraphInfo(cityCount, graph);
+        printGraphInfo(*snapshot);
+        std::cout << "Загрузка: " << std::fixed << std::setprecision(2)
+                  << loadStats.bytes / (1024.0 * 1024.0) << " МБ за "
+                  << loadStats.seconds << " с (" << loadStats.megabytesPerSecond()
+                  << " МБ/с)" << std::endl;
+        if (snapshot->isCompressed()) {
+            // В памяти остаются только сжатые списки (со смещениями и степенями)
+            std::int64_t arcs = snapshot->arcCount();
+            std::uint64_t csrBytes = (snapshot->isDirected() ? 2 : 1) *
+                ((static_cast<std::uint64_t>(cityCount) + 1) * sizeof(std::int64_t) +
+                 static_cast<std::uint64_t>(arcs) * sizeof(int));
+            std::cout << "Сжатые списки соседей: " << snapshot->adjacencyBytes() / (1024.0 * 1024.0)
+                      << " МБ в памяти, CSR занял бы " << csrBytes / (1024.0 * 1024.0) << " МБ ("
+                      << (arcs > 0 ? 8.0 * snapshot->compressed().neighborBytes() / arcs : 0.0)
+                      << " бит на дугу)" << std::endl;
+        }
+        std::cout.unsetf(std::ios::fixed);
+        if (options.layout.order != VertexOrder::Original) {
+            std::cout << "Перенумерация вершин: " << VertexPermutation::orderName(options.layout.order) << std::endl;
+        }
+        std::cout << std::endl;
+        
+        // Части графа - в отдельных процессах; потоки анализатора до fork не создаются
+        if (options.workerCount > 0) {
+            return runPartitioned(options, snapshot);
+        }
         
         // Создание анализатора
-        GraphAnalyzer analyzer(graph, cityCount);
+        GraphAnalyzer analyzer(snapshot);
+        configureAnalyzer(analyzer, options, reachIndex);
+        
+        // Города, достижимые из каждой из M штаб-квартир
+        if (options.headquarterCount > 0) {
+            std::vector<int> headquarters(options.headquarterCount);
+            std::cout << "Введите номера " << options.headquarterCount << " штаб-квартир (1-"
+                      << cityCount << "): ";
+            for (int& city : headquarters) {
+                std::cin >> city;
+            }
+            int L;
+            std::cout << "Введите максимальное количество промежуточных городов L: ";
+            std::cin >> L;
+            if (std::cin.fail()) {
+                throw std::runtime_error("Ошибка ввода данных");
+            }
+            std::vector<int> result = analyzer.findCommonCities(headquarters, L);
+            analyzer.diagnostics().sink().flush();
+            
+            std::cout << std::endl;
+            std::cout << "РЕЗУЛЬТАТ:" << std::endl;
+            std::cout << "Города, достижимые из всех штаб-квартир";
+            for (std::size_t i = 0; i < headquarters.size(); ++i) {
+                std::cout << (i == 0 ? " " : ", ") << headquarters[i];
+            }
+            std::cout << " (максимум " << L << " промежуточных городов):" << std::endl;
+            printResult(result);
+            return 0;
+        }
         
         // Ввод параметров
         int k1, k2, L;
@@ -87,6 +715,44 @@ int main() {
                   << cityCount << "): ";
         std::cin >> k1 >> k2;
         
+        // Все L сразу: один BFS на штаб-квартиру
+        if (options.sweepMaxL >= 0) {
+            if (std::cin.fail()) {
+                throw std::runtime_error("Ошибка ввода данных");
+            }
+            CommonZoneProfile profile = analyzer.findCommonCitiesProfile(k1, k2, options.sweepMaxL);
+            analyzer.diagnostics().sink().flush();
+            
+            std::cout << std::endl;
+            std::cout << "РЕЗУЛЬТАТ ДЛЯ L = 0.." << options.sweepMaxL << ":" << std::endl;
+            for (int sweepL = 0; sweepL <= profile.lastLevel(); ++sweepL) {
+                std::cout << "L=" << sweepL << ": ";
+                printResult(profile.citiesFor(sweepL));
+            }
+            
+            // Дальше последнего уровня ответ не меняется - одна строка на остаток
+            if (profile.lastLevel() < options.sweepMaxL) {
+                std::cout << "L=" << profile.lastLevel() + 1 << ".." << options.sweepMaxL << ": ";
+                printResult(profile.citiesFor(options.sweepMaxL));
+            }
+            return 0;
+        }
+        
+        // Бюджет времени в пути вместо L
+        if (options.budget >= 0) {
+            if (std::cin.fail()) {
+                throw std::runtime_error("Ошибка ввода данных");
+            }
+            std::vector<int> result = analyzer.findCommonCitiesWithin(k1, k2, options.budget);
+            
+            std::cout << std::endl;
+            std::cout << "РЕЗУЛЬТАТ:" << std::endl;
+            std::cout << "Города, достижимые из обоих штаб-квартир K1=" << k1 << " и K2=" << k2
+                      << " за время не больше " << options.budget << ":" << std::endl;
+            printResult(result);
+            return 0;
+        }
+        
         std::cout << "Введите максимальное количество промежуточных городов L: ";
         std::cin >> L;
         
@@ -96,14 +762,12 @@ int main() {
         }
         
         // Поиск общих городов
-        std::vector<int> result = analyzer.findCommonCities(k1, k2, L);
+        std::vector<int> result = analyzer.findCommonCities(k1, k2, L, options.mode);
+        analyzer.diagnostics().sink().flush();
         
         // Вывод результата
         std::cout << std::endl;
-        std::cout << "РЕЗУЛЬТАТ:" << std::endl;
-        std::cout << "Города, достижимые из обоих штаб-квартир ";
-        std::cout << "K1=" << k1 << " и K2=" << k2;
-        std::cout << " (максимум " << L << " промежуточных городов):" << std::endl;
+        printResultHeading(options, k1, k2, L);
         
         printResult(result);
         
@@ -118,5 +782,5 @@ int main() {
     return 0;
 }
 
-// g++ -std=c++11 -o graph_analyzer main.cpp graph_reader.cpp graph_analyzer.cpp graph_utils.cpp
-// ./graph_analyzer
+// g++ -std=c++11 -pthread -o graph_analyzer main.cpp csr_graph.cpp bit_matrix.cpp dense_bitset.cpp diagnostics.cpp mapped_file.cpp graph_reader.cpp graph_analyzer.cpp graph_utils.cpp query_server.cpp reachability_index.cpp common_zone_matrix.cpp thread_pool.cpp component_index.cpp dynamic_graph.cpp standing_queries.cpp graph_snapshot.cpp radix_heap.cpp vertex_order.cpp compressed_graph.cpp external_io.cpp external_analyzer.cpp frontier_transport.cpp partitioned_analyzer.cpp neighborhood_estimator.cpp
+// ./graph_analyzer [cities.txt] [--save-snapshot cities.bin] [--verify-snapshot] [-v | -vv] [--threads N] [--reorder none|degree|bfs|rcm] [--compress] [--directed [--mode from|to|mixed]] [--build-index Lmax] [--serve | --socket путь | --sweep Lmax | --budget T | --common-matrix L файл | --external МБ [--temp-dir каталог] | --workers N | --headquarters M | --neighborhood-sizes L файл [--estimate-error e]]
@@ -0,0 +1,70 @@
+/**
+ * @file mapped_file.h
+ * @brief Отображение файла в память (mmap) только для чтения
+ * @version 1.0
+ *
+ * RAII-обертка над mmap: файл доступен как непрерывный массив байт
+ * без копирования в пользовательский буфер
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief Файл, отображенный в память только для чтения
+ *
+ * Отображение снимается в деструкторе. Объект можно перемещать,
+ * но нельзя копировать.
+ */
+class MappedFile {
+private:
+    const char* data_;
+    std::size_t size_;
+
+public:
+    /**
+     * @brief Отображение файла в память
+     * @param filename Имя файла
+     * @throws std::runtime_error если файл не удалось открыть или отобразить
+     */
+    explicit MappedFile(const std::string& filename);
+
+    MappedFile(MappedFile&& other);
+    MappedFile& operator=(MappedFile&& other);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile();
+
+    /**
+     * @brief Начало данных файла
+     * @return const char* Указатель на первый байт (nullptr для пустого файла)
+     */
+    const char* data() const { return data_; }
+
+    /**
+     * @brief Размер файла
+     * @return std::size_t Размер в байтах
+     */
+    std::size_t size() const { return size_; }
+
+    /**
+     * @brief Подсказка ядру о произвольном порядке доступа
+     *
+     * По умолчанию файл читается последовательно; для снимков,
+     * к которым обращаются запросами, упреждающее чтение не нужно
+     */
+    void adviseRandomAccess() const;
+
+private:
+    /**
+     * @brief Снятие отображения
+     */
+    void release();
+};
+
+#endif // MAPPED_FILE_H
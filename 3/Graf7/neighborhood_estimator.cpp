@@ -0,0 +1,209 @@
+/**
+ * @file neighborhood_estimator.cpp
+ * @brief Реализация HyperANF
+ * @version 1.0
+ */
+
+#include "neighborhood_estimator.h"
+#include "thread_pool.h"
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Перемешивание номера вершины (финализатор splitmix64)
+ * @param value Номер вершины с зерном
+ * @return std::uint64_t Хеш
+ */
+std::uint64_t mixHash(std::uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+/**
+ * @brief Регистры target = max(target, source) побайтно
+ * @param target Регистры-приемник
+ * @param source Регистры соседа
+ * @param count Количество регистров (кратно 16)
+ */
+void mergeRegisters(std::uint8_t* target, const std::uint8_t* source, std::size_t count) {
+    std::size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(target + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), _mm_max_epu8(a, b));
+    }
+#endif
+    for (; i < count; ++i) {
+        if (source[i] > target[i]) {
+            target[i] = source[i];
+        }
+    }
+}
+
+/**
+ * @class CardinalityFormula
+ * @brief Оценка мощности по регистрам HyperLogLog
+ */
+class CardinalityFormula {
+private:
+    std::size_t registers_;
+    double alphaMM_;          ///< alpha_m · m²
+    double inversePowers_[65];  ///< 2^-r для значений регистра
+
+public:
+    explicit CardinalityFormula(std::size_t registers) : registers_(registers) {
+        double m = static_cast<double>(registers);
+        double alpha = registers == 16 ? 0.673 : registers == 32 ? 0.697 : registers == 64 ? 0.709
+                                                                         : 0.7213 / (1.0 + 1.079 / m);
+        alphaMM_ = alpha * m * m;
+        for (int r = 0; r <= 64; ++r) {
+            inversePowers_[r] = std::ldexp(1.0, -r);
+        }
+    }
+
+    /**
+     * @brief Оценка с поправкой для малых мощностей (линейный счет)
+     * @param counter Регистры счетчика
+     * @return double Оценка числа элементов
+     */
+    double operator()(const std::uint8_t* counter) const {
+        double sum = 0.0;
+        std::size_t zeros = 0;
+        for (std::size_t j = 0; j < registers_; ++j) {
+            sum += inversePowers_[counter[j]];
+            zeros += counter[j] == 0;
+        }
+        double estimate = alphaMM_ / sum;
+        double m = static_cast<double>(registers_);
+        if (estimate <= 2.5 * m && zeros > 0) {
+            estimate = m * std::log(m / static_cast<double>(zeros));
+        }
+        return estimate;
+    }
+};
+
+} // namespace
+
+NeighborhoodEstimator::NeighborhoodEstimator(const CSRGraph& graph, double relativeError, std::uint64_t seed)
+    : graph_(graph), precision_(precisionFor(relativeError)), seed_(seed) {}
+
+double NeighborhoodEstimator::relativeError() const {
+    return 1.04 / std::sqrt(static_cast<double>(1u << precision_));
+}
+
+std::uint64_t NeighborhoodEstimator::memoryBytes() const {
+    return 2 * static_cast<std::uint64_t>(graph_.vertexCount()) << precision_;
+}
+
+int NeighborhoodEstimator::precisionFor(double relativeError) {
+    if (!(relativeError > 0.0 && relativeError < 1.0)) {
+        throw std::runtime_error("Некорректная погрешность оценки: " + std::to_string(relativeError));
+    }
+    int precision = kMinPrecision;
+    while (precision < kMaxPrecision && 1.04 / std::sqrt(static_cast<double>(1u << precision)) > relativeError) {
+        ++precision;
+    }
+    return precision;
+}
+
+NeighborhoodEstimate NeighborhoodEstimator::estimate(int maxDistance, ThreadPool* pool) const {
+    if (maxDistance < 0) {
+        throw std::runtime_error("Некорректный радиус окрестности: " + std::to_string(maxDistance));
+    }
+
+    std::size_t n = static_cast<std::size_t>(graph_.vertexCount());
+    std::size_t m = std::size_t(1) << precision_;
+    std::vector<std::uint8_t> current(n * m, 0);
+    std::vector<std::uint8_t> next(n * m, 0);
+    std::vector<std::uint8_t> changed(n, 1);
+    std::vector<std::uint8_t> changedNext(n, 0);
+    CardinalityFormula cardinality(m);
+
+    // Счетчик вершины - она сама: регистр по старшим p битам хеша,
+    // значение - позиция первой единицы в остальных битах
+    NeighborhoodEstimate result;
+    result.precision = precision_;
+    result.relativeError = relativeError();
+    result.sizes.assign(n, 0.0);
+    std::uint64_t salt = mixHash(seed_);
+    for (std::size_t v = 0; v < n; ++v) {
+        std::uint64_t hash = mixHash(v ^ salt);
+        std::uint64_t rest = hash << precision_;
+        int rank = rest == 0 ? 64 - precision_ + 1 : __builtin_clzll(rest) + 1;
+        current[v * m + (hash >> (64 - precision_))] = static_cast<std::uint8_t>(rank);
+        next[v * m + (hash >> (64 - precision_))] = static_cast<std::uint8_t>(rank);
+        result.sizes[v] = cardinality(&current[v * m]);
+    }
+    double total = 0.0;
+    for (double size : result.sizes) {
+        total += size;
+    }
+    result.totals.push_back(total);
+
+    std::vector<std::size_t> changedCount(pool ? pool->size() : 1);
+    std::vector<double> totalDelta(changedCount.size());
+    for (int round = 1; round <= maxDistance; ++round) {
+        std::fill(changedCount.begin(), changedCount.end(), 0);
+        std::fill(totalDelta.begin(), totalDelta.end(), 0.0);
+        auto mergeRange = [&](std::size_t begin, std::size_t end, int worker) {
+            std::size_t rangeChanges = 0;
+            double rangeDelta = 0.0;
+            for (std::size_t v = begin; v < end; ++v) {
+                std::uint8_t* target = &next[v * m];
+                const std::uint8_t* own = &current[v * m];
+                // В next лежит счетчик позапрошлого раунда - он устарел,
+                // только если вершина изменилась в прошлом
+                if (changed[v]) {
+                    std::memcpy(target, own, m);
+                }
+                bool merged = false;
+                int vertex = static_cast<int>(v);
+                for (const int* it = graph_.neighborsBegin(vertex); it != graph_.neighborsEnd(vertex); ++it) {
+                    if (changed[*it]) {
+                        mergeRegisters(target, &current[static_cast<std::size_t>(*it) * m], m);
+                        merged = true;
+                    }
+                }
+                changedNext[v] = merged && std::memcmp(target, own, m) != 0;
+                if (changedNext[v]) {
+                    double size = cardinality(target);
+                    rangeDelta += size - result.sizes[v];
+                    result.sizes[v] = size;
+                    ++rangeChanges;
+                }
+            }
+            changedCount[worker] += rangeChanges;
+            totalDelta[worker] += rangeDelta;
+        };
+        if (pool) {
+            pool->parallelFor(n, 1024, mergeRange);
+        } else {
+            mergeRange(0, n, 0);
+        }
+
+        std::size_t changes = 0;
+        for (std::size_t worker = 0; worker < changedCount.size(); ++worker) {
+            changes += changedCount[worker];
+            total += totalDelta[worker];
+        }
+        if (changes == 0) {
+            break;
+        }
+        current.swap(next);
+        changed.swap(changedNext);
+        result.rounds = round;
+        result.totals.push_back(total);
+    }
+    return result;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file neighborhood_estimator.h
+ * @brief Приближенные размеры окрестностей всех вершин (HyperANF)
+ * @version 1.0
+ *
+ * Точный ответ "сколько городов в пределах d ребер от каждой вершины"
+ * требует BFS из каждой вершины. HyperANF хранит у вершины счетчик
+ * HyperLogLog множества ее окрестности: сначала в нем только сама
+ * вершина, а за раунд счетчик объединяется (максимум по регистрам)
+ * со счетчиками соседей, так что после d раундов он оценивает
+ * окрестность радиуса d. Раунд стоит O(дуги × регистры), память -
+ * два массива по 2^p байт на вершину.
+ */
+
+#ifndef NEIGHBORHOOD_ESTIMATOR_H
+#define NEIGHBORHOOD_ESTIMATOR_H
+
+#include "csr_graph.h"
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * @struct NeighborhoodEstimate
+ * @brief Оценки размеров окрестностей
+ */
+struct NeighborhoodEstimate {
+    std::vector<double> sizes;   ///< Оценка числа вершин в пределах maxDistance от каждой (вместе с ней)
+    std::vector<double> totals;  ///< Сумма оценок после каждого раунда (totals[0] - число вершин)
+    int rounds = 0;              ///< Раундов до остановки счетчиков (не больше maxDistance)
+    int precision = 0;           ///< p: у счетчика 2^p регистров
+    double relativeError = 0.0;  ///< Стандартная относительная погрешность оценки
+};
+
+/**
+ * @class NeighborhoodEstimator
+ * @brief Счетчики HyperLogLog, объединяемые вдоль дуг
+ *
+ * Окрестность - вершины, достижимые по дугам графа (у ориентированного
+ * графа - по исходящим). Точность задается стандартной относительной
+ * погрешностью оценки: число регистров 2^p - наименьшая степень двойки,
+ * при которой 1.04 / sqrt(2^p) не больше заданной.
+ */
+class NeighborhoodEstimator {
+private:
+    CSRGraph graph_;
+    int precision_;
+    std::uint64_t seed_;
+
+public:
+    /**
+     * @brief Наименьшая точность (16 регистров)
+     */
+    static const int kMinPrecision = 4;
+
+    /**
+     * @brief Наибольшая точность (65536 регистров)
+     */
+    static const int kMaxPrecision = 16;
+
+    /**
+     * @brief Конструктор
+     * @param graph Граф в формате CSR (не копируется)
+     * @param relativeError Допустимая относительная погрешность (0 < e < 1)
+     * @param seed Зерно хеширования вершин
+     * @throws std::runtime_error при некорректной погрешности
+     */
+    NeighborhoodEstimator(const CSRGraph& graph, double relativeError, std::uint64_t seed = 0);
+
+    /**
+     * @brief Точность счетчика
+     * @return int p: у счетчика 2^p регистров
+     */
+    int precision() const { return precision_; }
+
+    /**
+     * @brief Ожидаемая относительная погрешность оценки
+     * @return double 1.04 / sqrt(2^p)
+     */
+    double relativeError() const;
+
+    /**
+     * @brief Память счетчиков
+     * @return std::uint64_t Байт на два массива регистров
+     */
+    std::uint64_t memoryBytes() const;
+
+    /**
+     * @brief Точность для заданной погрешности
+     * @param relativeError Допустимая относительная погрешность (0 < e < 1)
+     * @return int p в пределах kMinPrecision..kMaxPrecision
+     * @throws std::runtime_error при некорректной погрешности
+     */
+    static int precisionFor(double relativeError);
+
+    /**
+     * @brief Оценка окрестностей радиуса maxDistance
+     *
+     * Раунды синхронные: счетчик раунда t собирается только из счетчиков
+     * раунда t - 1. Пересчитываются лишь вершины, у соседей которых
+     * счетчик изменился в прошлом раунде; если не изменился ни один,
+     * оценки окончательные и раунды прекращаются
+     * @param maxDistance Радиус в ребрах (≥ 0)
+     * @param pool Пул потоков (nullptr - в вызывающем потоке)
+     * @return NeighborhoodEstimate Оценки
+     * @throws std::runtime_error при отрицательном радиусе
+     */
+    NeighborhoodEstimate estimate(int maxDistance, ThreadPool* pool = nullptr) const;
+};
+
+#endif // NEIGHBORHOOD_ESTIMATOR_H
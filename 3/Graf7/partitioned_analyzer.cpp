@@ -0,0 +1,409 @@
+/**
+ * @file partitioned_analyzer.cpp
+ * @brief Реализация распределенного по процессам BFS
+ * @version 1.0
+ */
+
+#include "partitioned_analyzer.h"
+#include "frontier_transport.h"
+#include "graph_utils.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Отправка сообщения управляющего канала: длина и 64-битные числа
+ * @param fd Сокет
+ * @param values Числа
+ */
+void sendValues(int fd, const std::vector<std::int64_t>& values) {
+    std::int64_t count = static_cast<std::int64_t>(values.size());
+    const char* parts[] = {reinterpret_cast<const char*>(&count), reinterpret_cast<const char*>(values.data())};
+    std::size_t sizes[] = {sizeof(count), values.size() * sizeof(std::int64_t)};
+    for (int i = 0; i < 2; ++i) {
+        std::size_t done = 0;
+        while (done < sizes[i]) {
+            ssize_t sent = ::send(fd, parts[i] + done, sizes[i] - done, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("Ошибка управляющего канала: ") + std::strerror(errno));
+            }
+            done += static_cast<std::size_t>(sent);
+        }
+    }
+}
+
+/**
+ * @brief Прием блока данных целиком
+ * @return false если соединение закрыто до конца блока
+ */
+bool receiveAll(int fd, void* data, std::size_t size) {
+    char* out = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t got = ::recv(fd, out, size, 0);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got < 0) {
+            throw std::runtime_error(std::string("Ошибка управляющего канала: ") + std::strerror(errno));
+        }
+        if (got == 0) {
+            return false;
+        }
+        out += got;
+        size -= static_cast<std::size_t>(got);
+    }
+    return true;
+}
+
+/**
+ * @brief Прием сообщения управляющего канала
+ * @param fd Сокет
+ * @param[out] values Числа
+ * @return false если соединение закрыто
+ */
+bool receiveValues(int fd, std::vector<std::int64_t>& values) {
+    std::int64_t count;
+    if (!receiveAll(fd, &count, sizeof(count))) {
+        return false;
+    }
+    values.resize(static_cast<std::size_t>(count));
+    return receiveAll(fd, values.data(), values.size() * sizeof(std::int64_t));
+}
+
+/**
+ * @class PartitionWorker
+ * @brief Процесс-владелец диапазона вершин
+ *
+ * Запрос: стартовые вершины, глубина и направления обходов.
+ * Ответ: общие вершины своего диапазона по возрастанию, затем
+ * для каждого обхода число уровней и пары (размер, байт)
+ */
+class PartitionWorker {
+private:
+    const GraphSnapshot& snapshot_;
+    const std::vector<int>& bounds_;
+    FrontierTransport& transport_;
+    int begin_;
+    int end_;
+    std::vector<int> distanceFromK1_;  ///< Только вершины [begin_, end_)
+    std::vector<int> distanceFromK2_;
+
+public:
+    PartitionWorker(const GraphSnapshot& snapshot, const std::vector<int>& bounds, FrontierTransport& transport)
+        : snapshot_(snapshot), bounds_(bounds), transport_(transport),
+          begin_(bounds[transport.rank()]), end_(bounds[transport.rank() + 1]) {}
+
+    /**
+     * @brief Ответы на запросы до закрытия управляющего канала
+     * @param control Сокет к родительскому процессу
+     */
+    void serve(int control) {
+        std::vector<std::int64_t> query;
+        while (receiveValues(control, query)) {
+            if (query.size() != 5) {
+                throw std::runtime_error("Некорректный запрос процессу BFS");
+            }
+            int start1 = static_cast<int>(query[0]);
+            int start2 = static_cast<int>(query[1]);
+            int maxDistance = static_cast<int>(query[2]);
+
+            std::vector<std::int64_t> levels;
+            search(start1, maxDistance, query[3] != 0, distanceFromK1_, levels);
+            search(start2, maxDistance, query[4] != 0, distanceFromK2_, levels);
+
+            std::vector<std::int64_t> reply(1, 0);
+            for (int v = begin_; v < end_; ++v) {
+                if (distanceFromK1_[v - begin_] >= 0 && distanceFromK2_[v - begin_] >= 0 &&
+                    v != start1 && v != start2) {
+                    reply.push_back(v);
+                }
+            }
+            reply[0] = static_cast<std::int64_t>(reply.size() - 1);
+            reply.insert(reply.end(), levels.begin(), levels.end());
+            sendValues(control, reply);
+        }
+    }
+
+private:
+    bool owns(int v) const { return v >= begin_ && v < end_; }
+
+    int ownerOf(int v) const {
+        return static_cast<int>(std::upper_bound(bounds_.begin(), bounds_.end(), v) - bounds_.begin()) - 1;
+    }
+
+    /**
+     * @brief BFS по уровням с обменом границами
+     * @param start Стартовая вершина
+     * @param maxDistance Глубина в ребрах
+     * @param againstArcs Обход против направления дуг
+     * @param[out] distances Расстояния своих вершин (-1 - не достигнута)
+     * @param[out] levels Дописываются число уровней и пары (размер, байт)
+     */
+    void search(int start, int maxDistance, bool againstArcs, std::vector<int>& distances,
+                std::vector<std::int64_t>& levels) {
+        const CSRGraph& graph = againstArcs ? snapshot_.reverse() : snapshot_.graph();
+        distances.assign(static_cast<std::size_t>(end_ - begin_), -1);
+        std::vector<int> frontier;
+        std::vector<int> next;
+        if (owns(start)) {
+            distances[start - begin_] = 0;
+            frontier.push_back(start);
+        }
+        std::vector<std::vector<int>> outgoing(static_cast<std::size_t>(transport_.size()));
+        std::vector<std::vector<int>> incoming;
+
+        std::size_t countPosition = levels.size();
+        levels.push_back(0);
+        for (int level = 0;; ++level) {
+            std::int64_t frontierSize = static_cast<std::int64_t>(frontier.size());
+            if (level == maxDistance) {
+                levels.push_back(frontierSize);
+                levels.push_back(0);
+                break;
+            }
+
+            next.clear();
+            for (std::vector<int>& bucket : outgoing) {
+                bucket.clear();
+            }
+            for (int v : frontier) {
+                for (const int* u = graph.neighborsBegin(v); u != graph.neighborsEnd(v); ++u) {
+                    if (!owns(*u)) {
+                        outgoing[ownerOf(*u)].push_back(*u);
+                    } else if (distances[*u - begin_] < 0) {
+                        distances[*u - begin_] = level + 1;
+                        next.push_back(*u);
+                    }
+                }
+            }
+            // Вершина, найденная из нескольких своих, пересылается один раз
+            for (std::vector<int>& bucket : outgoing) {
+                std::sort(bucket.begin(), bucket.end());
+                bucket.erase(std::unique(bucket.begin(), bucket.end()), bucket.end());
+            }
+
+            std::uint64_t sentBefore = transport_.bytesSent();
+            std::int64_t globalSize = transport_.exchange(outgoing, frontierSize, incoming);
+            levels.push_back(frontierSize);
+            levels.push_back(static_cast<std::int64_t>(transport_.bytesSent() - sentBefore));
+            if (globalSize == 0) {
+                break;
+            }
+
+            for (const std::vector<int>& received : incoming) {
+                for (int u : received) {
+                    if (distances[u - begin_] < 0) {
+                        distances[u - begin_] = level + 1;
+                        next.push_back(u);
+                    }
+                }
+            }
+            frontier.swap(next);
+        }
+        levels[countPosition] = static_cast<std::int64_t>((levels.size() - countPosition - 1) / 2);
+    }
+};
+
+/**
+ * @brief Тело дочернего процесса
+ * @return int Код завершения
+ */
+int runWorker(const GraphSnapshot& snapshot, const std::vector<int>& bounds,
+              std::unique_ptr<FrontierTransport> transport, int control) {
+    int rank = transport->rank();
+    try {
+        PartitionWorker worker(snapshot, bounds, *transport);
+        worker.serve(control);
+    } catch (const std::exception& e) {
+        std::cerr << "ОШИБКА процесса BFS " << rank << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Разбор уровней одного обхода из ответа процесса
+ * @param reply Ответ
+ * @param[in,out] position Позиция числа уровней
+ * @param[in,out] levels Суммы по процессам
+ */
+void addLevels(const std::vector<std::int64_t>& reply, std::size_t& position,
+               std::vector<PartitionLevelStats>& levels) {
+    std::size_t count = static_cast<std::size_t>(reply.at(position++));
+    if (levels.size() < count) {
+        levels.resize(count);
+    }
+    for (std::size_t level = 0; level < count; ++level) {
+        levels[level].frontierSize += reply.at(position++);
+        levels[level].bytesSent += static_cast<std::uint64_t>(reply.at(position++));
+    }
+}
+
+} // namespace
+
+std::uint64_t PartitionedQueryStats::totalBytes() const {
+    std::uint64_t total = 0;
+    for (const PartitionLevelStats& level : fromK1) {
+        total += level.bytesSent;
+    }
+    for (const PartitionLevelStats& level : fromK2) {
+        total += level.bytesSent;
+    }
+    return total;
+}
+
+PartitionedAnalyzer::PartitionedAnalyzer(std::shared_ptr<const GraphSnapshot> snapshot, int workerCount)
+    : snapshot_(std::move(snapshot)) {
+    if (!snapshot_) {
+        throw std::runtime_error("Пустой снимок графа");
+    }
+    if (workerCount < 1 || workerCount > kMaxWorkers) {
+        throw std::runtime_error("Некорректное количество процессов: " + std::to_string(workerCount));
+    }
+    bounds_ = partitionByArcs(snapshot_->graph(), workerCount);
+
+    // Иначе буферы вывода напечатаются еще раз каждым процессом
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+
+    SocketMesh mesh(workerCount);
+    for (int p = 0; p < workerCount; ++p) {
+        int pair[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+            int error = errno;
+            shutdown();
+            throw std::runtime_error(std::string("Не удалось создать управляющий сокет: ") + std::strerror(error));
+        }
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            int error = errno;
+            ::close(pair[0]);
+            ::close(pair[1]);
+            shutdown();
+            throw std::runtime_error(std::string("Не удалось запустить процесс BFS: ") + std::strerror(error));
+        }
+        if (pid == 0) {
+            ::close(pair[0]);
+            for (int fd : controls_) {
+                ::close(fd);
+            }
+            // _exit: деструкторы и atexit принадлежат родителю
+            ::_exit(runWorker(*snapshot_, bounds_, mesh.endpoint(p), pair[1]));
+        }
+        ::close(pair[1]);
+        controls_.push_back(pair[0]);
+        workers_.push_back(pid);
+    }
+}
+
+PartitionedAnalyzer::~PartitionedAnalyzer() {
+    shutdown();
+}
+
+std::vector<int> PartitionedAnalyzer::findCommonCities(int k1, int k2, int L, ReachMode mode,
+                                                       PartitionedQueryStats* stats) {
+    if (!GraphUtils::isValidCity(k1, snapshot_->cityCount())) {
+        throw std::runtime_error("Некорректный номер города K1: " + std::to_string(k1));
+    }
+    if (!GraphUtils::isValidCity(k2, snapshot_->cityCount())) {
+        throw std::runtime_error("Некорректный номер города K2: " + std::to_string(k2));
+    }
+    if (!GraphUtils::isValidL(L)) {
+        throw std::runtime_error("Некорректное значение L: " + std::to_string(L));
+    }
+    if (k1 == k2) {
+        throw std::runtime_error("K1 и K2 не могут быть одинаковыми");
+    }
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    PartitionedQueryStats local;
+    PartitionedQueryStats& query = stats != nullptr ? *stats : local;
+    query = PartitionedQueryStats();
+
+    // У неориентированного графа все режимы совпадают
+    if (!snapshot_->isDirected()) {
+        mode = ReachMode::FromBoth;
+    }
+    const VertexPermutation& order = snapshot_->order();
+    std::vector<std::int64_t> request = {order.toInternal(k1 - 1), order.toInternal(k2 - 1),
+                                         static_cast<std::int64_t>(L) + 1, mode == ReachMode::ToBoth,
+                                         mode != ReachMode::FromBoth};
+    for (int control : controls_) {
+        sendValues(control, request);
+    }
+
+    // Диапазоны идут по возрастанию - ответы склеиваются по порядку
+    std::vector<int> commonCities;
+    std::vector<std::int64_t> reply;
+    for (std::size_t p = 0; p < controls_.size(); ++p) {
+        if (!receiveValues(controls_[p], reply)) {
+            throw std::runtime_error("Процесс BFS " + std::to_string(p) + " завершился");
+        }
+        std::size_t position = 0;
+        std::size_t count = static_cast<std::size_t>(reply.at(position++));
+        for (std::size_t i = 0; i < count; ++i) {
+            commonCities.push_back(static_cast<int>(reply.at(position++)));
+        }
+        addLevels(reply, position, query.fromK1);
+        addLevels(reply, position, query.fromK2);
+    }
+
+    for (int& city : commonCities) {
+        city = order.toOriginal(city) + 1;
+    }
+    if (!order.isIdentity()) {
+        std::sort(commonCities.begin(), commonCities.end());
+    }
+    query.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    if (commonCities.empty()) {
+        return {-1};
+    }
+    return commonCities;
+}
+
+std::vector<int> PartitionedAnalyzer::partitionByArcs(const CSRGraph& graph, int parts) {
+    int n = graph.vertexCount();
+    const std::int64_t* offsets = graph.offsetsData();
+    std::int64_t total = graph.arcCount() + n;
+    std::vector<int> bounds(static_cast<std::size_t>(parts) + 1, n);
+    bounds[0] = 0;
+
+    // Нагрузка вершин до v - offsets[v] + v, она строго возрастает
+    int v = 0;
+    for (int p = 1; p < parts; ++p) {
+        std::int64_t target = total * p / parts;
+        while (v < n && offsets[v] + v < target) {
+            ++v;
+        }
+        bounds[p] = v;
+    }
+    return bounds;
+}
+
+void PartitionedAnalyzer::shutdown() {
+    // Закрытый управляющий канал - сигнал процессу завершиться
+    for (int fd : controls_) {
+        ::close(fd);
+    }
+    controls_.clear();
+    for (pid_t pid : workers_) {
+        while (::waitpid(pid, nullptr, 0) < 0 && errno == EINTR) {
+        }
+    }
+    workers_.clear();
+}
@@ -0,0 +1,132 @@
+/**
+ * @file partitioned_analyzer.h
+ * @brief Поиск общих городов несколькими процессами по частям графа
+ * @version 1.0
+ *
+ * Вершины делятся на N непрерывных диапазонов с примерно равным
+ * числом дуг, каждый диапазон принадлежит своему процессу. Процесс
+ * хранит расстояния только своих вершин и раскрывает только их
+ * списки соседей; BFS идет по уровням синхронно, а найденные
+ * вершины чужих диапазонов пересылаются владельцам через
+ * FrontierTransport (frontier_transport.h). Процессы пока работают
+ * на одной машине и получают граф от родителя через fork.
+ */
+
+#ifndef PARTITIONED_ANALYZER_H
+#define PARTITIONED_ANALYZER_H
+
+#include "graph_analyzer.h"
+#include "graph_snapshot.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <sys/types.h>
+
+/**
+ * @struct PartitionLevelStats
+ * @brief Один уровень распределенного BFS (сумма по процессам)
+ */
+struct PartitionLevelStats {
+    std::int64_t frontierSize = 0;  ///< Вершин на уровне
+    std::uint64_t bytesSent = 0;    ///< Байт границы, переданных при раскрытии уровня
+};
+
+/**
+ * @struct PartitionedQueryStats
+ * @brief Статистика запроса PartitionedAnalyzer::findCommonCities
+ */
+struct PartitionedQueryStats {
+    std::vector<PartitionLevelStats> fromK1;  ///< Обход из K1 по уровням (уровень 0 - старт)
+    std::vector<PartitionLevelStats> fromK2;  ///< Обход из K2 по уровням
+    double seconds = 0.0;                     ///< Время запроса
+
+    /**
+     * @brief Всего передано байт границ
+     * @return std::uint64_t Сумма по уровням обоих обходов
+     */
+    std::uint64_t totalBytes() const;
+};
+
+/**
+ * @class PartitionedAnalyzer
+ * @brief Анализатор общих городов на процессах-владельцах частей графа
+ *
+ * Процессы создаются конструктором и живут до деструктора.
+ * Ответ совпадает с GraphAnalyzer::findCommonCities того же снимка.
+ */
+class PartitionedAnalyzer {
+private:
+    std::shared_ptr<const GraphSnapshot> snapshot_;
+    std::vector<int> bounds_;    ///< Процесс p владеет вершинами [bounds_[p], bounds_[p + 1])
+    std::vector<pid_t> workers_;
+    std::vector<int> controls_;  ///< Сокеты запросов к процессам
+
+public:
+    /**
+     * @brief Наибольшее количество процессов
+     */
+    static const int kMaxWorkers = 64;
+
+    /**
+     * @brief Разбиение графа и запуск процессов
+     *
+     * Граф не копируется: дочерние процессы разделяют его
+     * страницы с родителем
+     * @param snapshot Снимок графа
+     * @param workerCount Количество процессов (1..kMaxWorkers)
+     * @throws std::runtime_error если процессы не удалось запустить
+     */
+    PartitionedAnalyzer(std::shared_ptr<const GraphSnapshot> snapshot, int workerCount);
+
+    /**
+     * @brief Завершение процессов
+     */
+    ~PartitionedAnalyzer();
+
+    PartitionedAnalyzer(const PartitionedAnalyzer&) = delete;
+    PartitionedAnalyzer& operator=(const PartitionedAnalyzer&) = delete;
+
+    /**
+     * @brief Количество процессов
+     * @return int Количество процессов
+     */
+    int workerCount() const { return static_cast<int>(workers_.size()); }
+
+    /**
+     * @brief Границы диапазонов вершин
+     * @return const std::vector<int>& workerCount() + 1 границ во внутренней нумерации
+     */
+    const std::vector<int>& bounds() const { return bounds_; }
+
+    /**
+     * @brief Поиск общих городов
+     * @param k1 Первая штаб-квартира (1..cityCount)
+     * @param k2 Вторая штаб-квартира (1..cityCount)
+     * @param L Максимальное количество промежуточных городов
+     * @param mode Направление достижимости (для ориентированного графа)
+     * @param[out] stats Размеры уровней и переданные байты (может быть nullptr)
+     * @return std::vector<int> Отсортированные номера городов или {-1}
+     * @throws std::runtime_error при некорректных параметрах или сбое процесса
+     */
+    std::vector<int> findCommonCities(int k1, int k2, int L, ReachMode mode = ReachMode::FromBoth,
+                                      PartitionedQueryStats* stats = nullptr);
+
+    /**
+     * @brief Разбиение вершин на диапазоны с равной нагрузкой
+     *
+     * Нагрузка вершины - ее степень плюс один, чтобы вершины
+     * без дуг тоже распределялись поровну
+     * @param graph Граф
+     * @param parts Количество диапазонов
+     * @return std::vector<int> parts + 1 возрастающих границ от 0 до vertexCount
+     */
+    static std::vector<int> partitionByArcs(const CSRGraph& graph, int parts);
+
+private:
+    /**
+     * @brief Закрытие сокетов и ожидание процессов
+     */
+    void shutdown();
+};
+
+#endif // PARTITIONED_ANALYZER_H
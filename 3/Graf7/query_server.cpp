@@ -0,0 +1,353 @@
+/**
+ * @file query_server.cpp
+ * @brief Реализация сервера запросов
+ * @version 1.1
+ */
+
+#include "query_server.h"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void requestStop(int) {
+        stopRequested = 1;
+    }
+
+    /**
+     * @brief Чтение доступных данных
+     * @return Количество байт, 0 при конце данных, -1 если данных пока нет
+     */
+    ssize_t readSome(int fd, std::string& buffer) {
+        char chunk[64 * 1024];
+        for (;;) {
+            ssize_t got = ::read(fd, chunk, sizeof(chunk));
+            if (got > 0) {
+                buffer.append(chunk, static_cast<std::size_t>(got));
+                return got;
+            }
+            if (got == 0) {
+                return 0;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return -1;
+            }
+            throw std::runtime_error(std::string("Ошибка чтения запросов: ") + std::strerror(errno));
+        }
+    }
+
+    void writeAll(int fd, const std::string& data) {
+        std::size_t written = 0;
+        while (written < data.size()) {
+            ssize_t put = ::write(fd, data.data() + written, data.size() - written);
+            if (put < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("Ошибка записи ответов: ") + std::strerror(errno));
+            }
+            written += static_cast<std::size_t>(put);
+        }
+    }
+
+    bool hasInput(int fd) {
+        pollfd entry = {fd, POLLIN, 0};
+        return ::poll(&entry, 1, 0) > 0;
+    }
+
+    /**
+     * @brief Ответ клиенту, строка которого превысила предел
+     * @return std::string Строка ошибки с переводом строки
+     */
+    std::string lineTooLongAnswer() {
+        return "ОШИБКА: строка запроса длиннее " + std::to_string(QueryServer::kMaxLineBytes) + " байт\n";
+    }
+
+    void setNonBlocking(int fd) {
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    /**
+     * @struct Client
+     * @brief Состояние подключения к сокету
+     */
+    struct Client {
+        int fd;
+        std::string input;    ///< Принятые, но еще не разобранные байты
+        std::string output;   ///< Ответы, ожидающие отправки
+        bool closing;         ///< Клиент закончил передачу
+        bool failed;          ///< Ошибка сокета - отключить сразу
+    };
+}
+
+const std::size_t QueryServer::kMaxLineBytes;
+
+QueryServer::QueryServer(GraphAnalyzer& analyzer, std::size_t maxBatchSize)
+    : analyzer_(analyzer), maxBatchSize_(maxBatchSize == 0 ? 1 : maxBatchSize) {}
+
+std::vector<std::string> QueryServer::answerLines(const std::vector<std::string>& lines) {
+    std::vector<std::string> answers(lines.size());
+    std::vector<CityQuery> queries;
+    std::vector<std::size_t> positions;
+
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        CityQuery query;
+        if (!parseQuery(lines[i], query)) {
+            answers[i] = "ОШИБКА: ожидается строка \"K1 K2 L\"";
+            continue;
+        }
+        try {
+            analyzer_.validateQuery(query);
+        } catch (const std::exception& e) {
+            answers[i] = std::string("ОШИБКА: ") + e.what();
+            continue;
+        }
+        queries.push_back(query);
+        positions.push_back(i);
+    }
+
+    // Корректные запросы обрабатываются пакетами общего прохода
+    for (std::size_t begin = 0; begin < queries.size(); begin += maxBatchSize_) {
+        std::size_t end = std::min(queries.size(), begin + maxBatchSize_);
+        std::vector<CityQuery> batch(queries.begin() + begin, queries.begin() + end);
+        std::vector<std::vector<int>> results = analyzer_.findCommonCitiesBatch(batch);
+        for (std::size_t q = 0; q < results.size(); ++q) {
+            answers[positions[begin + q]] = formatAnswer(results[q]);
+        }
+    }
+
+    analyzer_.diagnostics().sink().flush();
+    return answers;
+}
+
+void QueryServer::serveStream(int inputFd, int outputFd) {
+    const std::size_t maxPendingBytes = 1024 * 1024;
+    std::string buffer;
+    bool finished = false;
+
+    while (!finished) {
+        // Ожидание хотя бы одного блока данных
+        finished = readSome(inputFd, buffer) == 0;
+
+        // Все, что уже пришло, попадает в тот же пакет
+        while (!finished && buffer.size() < maxPendingBytes && hasInput(inputFd)) {
+            finished = readSome(inputFd, buffer) == 0;
+        }
+
+        std::vector<std::string> lines;
+        takeLines(buffer, lines);
+        bool overflow = buffer.size() > kMaxLineBytes;
+        if (finished && !overflow) {
+            buffer += '\n';
+            takeLines(buffer, lines);
+        }
+        if (lines.empty() && !overflow) {
+            continue;
+        }
+
+        std::string response;
+        for (const std::string& answer : answerLines(lines)) {
+            response += answer;
+            response += '\n';
+        }
+        if (overflow) {
+            response += lineTooLongAnswer();
+            finished = true;
+        }
+        writeAll(outputFd, response);
+    }
+}
+
+void QueryServer::serveSocket(const std::string& path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Слишком длинный путь сокета: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        throw std::runtime_error(std::string("Не удалось создать сокет: ") + std::strerror(errno));
+    }
+    ::unlink(path.c_str());
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listener, 64) != 0) {
+        int error = errno;
+        ::close(listener);
+        throw std::runtime_error("Не удалось открыть сокет " + path + ": " + std::strerror(error));
+    }
+    setNonBlocking(listener);
+
+    // Без SA_RESTART: poll прерывается сигналом, и цикл завершается
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = requestStop;
+    ::sigaction(SIGINT, &action, nullptr);
+    ::sigaction(SIGTERM, &action, nullptr);
+    stopRequested = 0;
+
+    const std::size_t maxPendingBytes = 1024 * 1024;
+    std::vector<Client> clients;
+    std::vector<pollfd> entries;
+
+    while (!stopRequested) {
+        entries.clear();
+        entries.push_back(pollfd{listener, POLLIN, 0});
+        for (const Client& client : clients) {
+            short events = client.closing ? 0 : POLLIN;
+            if (!client.output.empty()) {
+                events |= POLLOUT;
+            }
+            entries.push_back(pollfd{client.fd, events, 0});
+        }
+
+        if (::poll(entries.data(), entries.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        // Новые подключения
+        if (entries[0].revents & POLLIN) {
+            int fd;
+            while ((fd = ::accept(listener, nullptr, nullptr)) >= 0) {
+                setNonBlocking(fd);
+                clients.push_back(Client{fd, std::string(), std::string(), false, false});
+            }
+        }
+
+        // Прием данных (клиенты, подключенные в этом цикле, ждут следующего)
+        for (std::size_t i = 0; i + 1 < entries.size(); ++i) {
+            Client& client = clients[i];
+            if (entries[i + 1].revents & (POLLERR | POLLNVAL)) {
+                client.failed = true;
+            } else if (entries[i + 1].revents & (POLLIN | POLLHUP)) {
+                // Остаток сверх предела дочитывается в следующем цикле
+                try {
+                    ssize_t got;
+                    while ((got = readSome(client.fd, client.input)) > 0 &&
+                           client.input.size() < maxPendingBytes) {
+                    }
+                    client.closing = got == 0;
+                } catch (const std::exception&) {
+                    client.failed = true;
+                }
+            }
+        }
+
+        // Один пакет на строки всех клиентов
+        std::vector<std::string> lines;
+        std::vector<std::size_t> owners;
+        std::vector<std::size_t> overflowed;
+        for (std::size_t c = 0; c < clients.size(); ++c) {
+            std::size_t before = lines.size();
+            takeLines(clients[c].input, lines);
+            if (clients[c].input.size() > kMaxLineBytes) {
+                overflowed.push_back(c);
+            } else if (clients[c].closing && !clients[c].input.empty()) {
+                clients[c].input += '\n';
+                takeLines(clients[c].input, lines);
+            }
+            owners.insert(owners.end(), lines.size() - before, c);
+        }
+
+        if (!lines.empty()) {
+            std::vector<std::string> answers = answerLines(lines);
+            for (std::size_t i = 0; i < answers.size(); ++i) {
+                clients[owners[i]].output += answers[i];
+                clients[owners[i]].output += '\n';
+            }
+        }
+
+        // Строка без перевода длиннее предела: ошибка после ответов
+        // на полные строки, дальнейший ввод клиента не читается
+        for (std::size_t c : overflowed) {
+            clients[c].output += lineTooLongAnswer();
+            clients[c].input.clear();
+            clients[c].input.shrink_to_fit();
+            clients[c].closing = true;
+        }
+
+        // Отправка без блокировки; остаток уйдет по POLLOUT
+        for (Client& client : clients) {
+            while (!client.output.empty() && !client.failed) {
+                ssize_t sent = ::send(client.fd, client.output.data(), client.output.size(), MSG_NOSIGNAL);
+                if (sent > 0) {
+                    client.output.erase(0, static_cast<std::size_t>(sent));
+                } else if (sent < 0 && errno == EINTR) {
+                    continue;
+                } else {
+                    client.failed = sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK;
+                    break;
+                }
+            }
+        }
+
+        // Отключение завершившихся клиентов
+        std::size_t kept = 0;
+        for (std::size_t c = 0; c < clients.size(); ++c) {
+            if (clients[c].failed || (clients[c].closing && clients[c].output.empty())) {
+                ::close(clients[c].fd);
+            } else {
+                clients[kept++] = clients[c];
+            }
+        }
+        clients.resize(kept);
+    }
+
+    for (const Client& client : clients) {
+        ::close(client.fd);
+    }
+    ::close(listener);
+    ::unlink(path.c_str());
+}
+
+bool QueryServer::parseQuery(const std::string& line, CityQuery& query) {
+    std::istringstream input(line);
+    std::string rest;
+    return static_cast<bool>(input >> query.k1 >> query.k2 >> query.L) && !(input >> rest);
+}
+
+std::string QueryServer::formatAnswer(const std::vector<int>& cities) {
+    std::string answer;
+    for (std::size_t i = 0; i < cities.size(); ++i) {
+        if (i > 0) {
+            answer += ' ';
+        }
+        answer += std::to_string(cities[i]);
+    }
+    return answer;
+}
+
+void QueryServer::takeLines(std::string& buffer, std::vector<std::string>& lines) {
+    std::size_t start = 0;
+    std::size_t newline;
+    while ((newline = buffer.find('\n', start)) != std::string::npos) {
+        std::size_t end = newline;
+        if (end > start && buffer[end - 1] == '\r') {
+            --end;
+        }
+        std::string line = buffer.substr(start, end - start);
+        if (line.find_first_not_of(" \t") != std::string::npos) {
+            lines.push_back(line);
+        }
+        start = newline + 1;
+    }
+    buffer.erase(0, start);
+}
@@ -0,0 +1,99 @@
+/**
+ * @file query_server.h
+ * @brief Сервер запросов с графом, постоянно находящимся в памяти
+ * @version 1.1
+ *
+ * Граф загружается один раз, запросы "K1 K2 L" принимаются построчно
+ * из stdin или через Unix-сокет. Запросы, пришедшие одновременно,
+ * объединяются в общий проход MS-BFS.
+ */
+
+#ifndef QUERY_SERVER_H
+#define QUERY_SERVER_H
+
+#include "graph_analyzer.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @class QueryServer
+ * @brief Построчный сервер запросов поиска общих городов
+ *
+ * Протокол: на каждую строку "K1 K2 L" сервер отвечает одной строкой -
+ * номерами общих городов через пробел, "-1" если их нет, или
+ * "ОШИБКА: ..." для некорректного запроса. Пустые строки пропускаются.
+ * Ответы каждому клиенту идут в порядке его запросов. Клиент, строка
+ * которого длиннее kMaxLineBytes, получает ошибку и отключается.
+ */
+class QueryServer {
+private:
+    GraphAnalyzer& analyzer_;
+    std::size_t maxBatchSize_;
+
+public:
+    /**
+     * @brief Наибольшая длина строки запроса (без перевода строки)
+     */
+    static const std::size_t kMaxLineBytes = 4096;
+
+    /**
+     * @brief Конструктор
+     * @param analyzer Анализатор с загруженным графом
+     * @param maxBatchSize Максимум запросов в одном пакете
+     */
+    explicit QueryServer(GraphAnalyzer& analyzer, std::size_t maxBatchSize = 128);
+
+    /**
+     * @brief Обслуживание потока (stdin/stdout) до конца входных данных
+     *
+     * Все строки, уже доступные для чтения, обрабатываются одним пакетом.
+     * Слишком длинная строка завершает обслуживание с ответом-ошибкой
+     * @param inputFd Дескриптор входа
+     * @param outputFd Дескриптор выхода
+     * @throws std::runtime_error при ошибке ввода-вывода
+     */
+    void serveStream(int inputFd, int outputFd);
+
+    /**
+     * @brief Обслуживание клиентов через Unix-сокет до SIGINT/SIGTERM
+     *
+     * Строки, пришедшие от всех клиентов за один цикл poll,
+     * обрабатываются общим пакетом
+     * @param path Путь сокета (существующий файл заменяется)
+     * @throws std::runtime_error если сокет не удалось создать
+     */
+    void serveSocket(const std::string& path);
+
+    /**
+     * @brief Ответы на набор строк запросов
+     * @param lines Строки "K1 K2 L"
+     * @return std::vector<std::string> Строки ответов (без перевода строки)
+     */
+    std::vector<std::string> answerLines(const std::vector<std::string>& lines);
+
+private:
+    /**
+     * @brief Разбор строки запроса
+     * @param line Строка
+     * @param[out] query Запрос
+     * @return false если строка не содержит ровно три целых числа
+     */
+    static bool parseQuery(const std::string& line, CityQuery& query);
+
+    /**
+     * @brief Форматирование ответа
+     * @param cities Результат findCommonCities
+     * @return std::string Строка ответа
+     */
+    static std::string formatAnswer(const std::vector<int>& cities);
+
+    /**
+     * @brief Извлечение полных строк из буфера
+     * @param buffer Буфер (полные строки из него удаляются)
+     * @param[out] lines Куда добавить строки
+     */
+    static void takeLines(std::string& buffer, std::vector<std::string>& lines);
+};
+
+#endif // QUERY_SERVER_H
@@ -0,0 +1,45 @@
+/**
+ * @file radix_heap.cpp
+ * @brief Реализация монотонной поразрядной кучи
+ * @version 1.0
+ */
+
+#include "radix_heap.h"
+
+RadixHeap::RadixHeap() : last_(0), size_(0) {}
+
+std::pair<std::uint64_t, int> RadixHeap::pop() {
+    if (buckets_[0].empty()) {
+        // Первая непустая корзина: ее минимум становится последним ключом,
+        // и все ее элементы попадают в корзины с меньшими номерами
+        int bucket = 1;
+        while (buckets_[bucket].empty()) {
+            ++bucket;
+        }
+        std::vector<std::pair<std::uint64_t, int>>& items = buckets_[bucket];
+        std::uint64_t minimum = items.front().first;
+        for (const std::pair<std::uint64_t, int>& item : items) {
+            if (item.first < minimum) {
+                minimum = item.first;
+            }
+        }
+        last_ = minimum;
+        for (const std::pair<std::uint64_t, int>& item : items) {
+            buckets_[bucketOf(item.first)].push_back(item);
+        }
+        items.clear();
+    }
+    
+    std::pair<std::uint64_t, int> top = buckets_[0].back();
+    buckets_[0].pop_back();
+    --size_;
+    return top;
+}
+
+void RadixHeap::clear() {
+    for (int bucket = 0; bucket < kBucketCount; ++bucket) {
+        buckets_[bucket].clear();
+    }
+    last_ = 0;
+    size_ = 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file radix_heap.h
+ * @brief Монотонная поразрядная куча
+ * @version 1.0
+ *
+ * Очередь с приоритетом для алгоритма Дейкстры с целыми весами:
+ * извлекаемые ключи не убывают, поэтому элементы раскладываются по
+ * корзинам по старшему биту, отличающему ключ от последнего извлеченного.
+ * Каждый элемент перекладывается не больше 64 раз, операции - без сравнений
+ * по всей куче.
+ */
+
+#ifndef RADIX_HEAP_H
+#define RADIX_HEAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @class RadixHeap
+ * @brief Монотонная куча пар (ключ, вершина)
+ *
+ * Добавлять можно только ключи не меньше последнего извлеченного.
+ */
+class RadixHeap {
+private:
+    static const int kBucketCount = 65;  ///< Корзина 0 - ключи, равные последнему; i - старший различающийся бит i - 1
+
+    std::vector<std::pair<std::uint64_t, int>> buckets_[kBucketCount];
+    std::uint64_t last_;   ///< Последний извлеченный ключ
+    std::size_t size_;
+
+public:
+    /**
+     * @brief Конструктор пустой кучи
+     */
+    RadixHeap();
+
+    /**
+     * @brief Проверка на пустоту
+     * @return true если элементов нет
+     */
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * @brief Количество элементов
+     * @return std::size_t Количество элементов
+     */
+    std::size_t size() const { return size_; }
+
+    /**
+     * @brief Добавление элемента
+     * @param key Ключ (не меньше последнего извлеченного)
+     * @param value Вершина
+     */
+    void push(std::uint64_t key, int value) {
+        buckets_[bucketOf(key)].push_back(std::make_pair(key, value));
+        ++size_;
+    }
+
+    /**
+     * @brief Извлечение элемента с наименьшим ключом
+     * @return std::pair<std::uint64_t, int> Ключ и вершина (куча не пуста)
+     */
+    std::pair<std::uint64_t, int> pop();
+
+    /**
+     * @brief Очистка (последний ключ сбрасывается в 0)
+     */
+    void clear();
+
+private:
+    /**
+     * @brief Корзина ключа относительно последнего извлеченного
+     * @param key Ключ
+     * @return int Номер корзины
+     */
+    int bucketOf(std::uint64_t key) const {
+        return key == last_ ? 0 : 64 - __builtin_clzll(key ^ last_);
+    }
+};
+
+#endif // RADIX_HEAP_H
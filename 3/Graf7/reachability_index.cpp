@@ -0,0 +1,175 @@
+/**
+ * @file reachability_index.cpp
+ * @brief Реализация индекса достижимости
+ * @version 1.1
+ */
+
+#include "reachability_index.h"
+#include "bit_matrix.h"
+#include "mapped_file.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+    const char kIndexMagic[8] = {'G', 'R', 'A', 'F', '7', 'R', 'I', 'X'};
+    const std::uint32_t kIndexVersion = 1;
+    const std::uint32_t kSaturatedFlag = 1;
+    const std::uint64_t kRowsSeed = 0x5245414348ULL;
+
+    /**
+     * @struct IndexHeader
+     * @brief Заголовок файла индекса (64 байта)
+     */
+    struct IndexHeader {
+        char magic[8];               ///< Сигнатура "GRAF7RIX"
+        std::uint32_t version;       ///< Версия формата
+        std::uint32_t flags;         ///< kSaturatedFlag если достигнуто замыкание
+        std::uint64_t vertexCount;   ///< Количество вершин
+        std::uint64_t levelCount;    ///< Количество матриц
+        std::uint64_t wordsPerRow;   ///< Слов в строке
+        std::uint64_t graphChecksum; ///< CSRGraph::checksum() графа
+        std::uint64_t rowsChecksum;  ///< Контрольная сумма матриц
+        std::uint64_t arcCount;      ///< Количество дуг графа (0 в файлах, записанных до появления поля)
+    };
+
+    static_assert(sizeof(IndexHeader) == 64, "Заголовок индекса должен занимать 64 байта");
+}
+
+ReachabilityIndex::ReachabilityIndex()
+    : vertexCount_(0), levelCount_(0), saturated_(false), arcCount_(0), graphChecksum_(0),
+      wordsPerRow_(0), rows_(nullptr) {}
+
+ReachabilityIndex ReachabilityIndex::build(const CSRGraph& graph, int maxL, ThreadPool* pool) {
+    if (maxL < 0) {
+        throw std::runtime_error("Некорректное значение Lmax индекса: " + std::to_string(maxL));
+    }
+
+    int n = graph.vertexCount();
+    BitMatrix step = BitMatrix::fromGraph(graph);
+    for (int v = 0; v < n; ++v) {
+        step.set(v, v);
+    }
+
+    ReachabilityIndex index;
+    index.vertexCount_ = n;
+    index.arcCount_ = graph.arcCount();
+    index.graphChecksum_ = graph.checksum();
+    index.wordsPerRow_ = step.wordsPerRow();
+
+    std::size_t levelWords = static_cast<std::size_t>(n) * step.wordsPerRow();
+    std::shared_ptr<std::vector<std::uint64_t>> rows = std::make_shared<std::vector<std::uint64_t>>();
+    rows->reserve(levelWords * (static_cast<std::size_t>(maxL) + 1));
+    rows->insert(rows->end(), step.data(), step.data() + levelWords);
+    index.levelCount_ = 1;
+
+    // R_{d+1} = (A + I) · R_d: разреженный множитель слева, и почти все
+    // его байты нулевые - строки таблиц для них не выбираются.
+    // Совпадение соседних степеней - замыкание
+    BitMatrix level = step;
+    while (index.levelCount_ <= maxL) {
+        BitMatrix next = BitMatrix::multiply(step, level, pool);
+        if (next.equals(level)) {
+            index.saturated_ = true;
+            break;
+        }
+        rows->insert(rows->end(), next.data(), next.data() + levelWords);
+        ++index.levelCount_;
+        level = std::move(next);
+    }
+
+    index.rows_ = rows->data();
+    index.storage_ = rows;
+    return index;
+}
+
+ReachabilityIndex ReachabilityIndex::load(const std::string& filename, const CSRGraph& graph,
+                                          bool verifyChecksum) {
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(filename);
+    if (file->size() < sizeof(IndexHeader)) {
+        throw std::runtime_error("Файл слишком мал для индекса: " + filename);
+    }
+
+    IndexHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+
+    if (std::memcmp(header.magic, kIndexMagic, sizeof(kIndexMagic)) != 0) {
+        throw std::runtime_error("Файл не является индексом достижимости: " + filename);
+    }
+    if (header.version != kIndexVersion) {
+        throw std::runtime_error("Неподдерживаемая версия индекса: " + std::to_string(header.version));
+    }
+    // Без проверки граф сверяется только по размерам: хеш графа и
+    // матриц - проходы по всем данным, которых быстрый запуск избегает
+    if (header.vertexCount != static_cast<std::uint64_t>(graph.vertexCount()) ||
+        (header.arcCount != 0 && header.arcCount != static_cast<std::uint64_t>(graph.arcCount())) ||
+        (verifyChecksum && header.graphChecksum != graph.checksum())) {
+        throw std::runtime_error("Индекс построен для другого графа: " + filename);
+    }
+
+    std::uint64_t rowsBytes = header.levelCount * header.vertexCount * header.wordsPerRow * sizeof(std::uint64_t);
+    if (header.levelCount == 0 || header.wordsPerRow != (header.vertexCount + 63) / 64 ||
+        sizeof(IndexHeader) + rowsBytes != file->size()) {
+        throw std::runtime_error("Размер индекса не совпадает с заголовком: " + filename);
+    }
+
+    const char* rows = file->data() + sizeof(IndexHeader);
+    if (verifyChecksum && CSRGraph::checksum(rows, rowsBytes, kRowsSeed) != header.rowsChecksum) {
+        throw std::runtime_error("Контрольная сумма индекса не совпадает: " + filename);
+    }
+
+    ReachabilityIndex index;
+    index.vertexCount_ = static_cast<int>(header.vertexCount);
+    index.levelCount_ = static_cast<int>(header.levelCount);
+    index.saturated_ = (header.flags & kSaturatedFlag) != 0;
+    index.arcCount_ = static_cast<std::int64_t>(header.arcCount);
+    index.graphChecksum_ = header.graphChecksum;
+    index.wordsPerRow_ = static_cast<std::size_t>(header.wordsPerRow);
+    index.rows_ = reinterpret_cast<const std::uint64_t*>(rows);
+    index.storage_ = file;
+
+    file->adviseRandomAccess();
+    return index;
+}
+
+void ReachabilityIndex::save(const std::string& filename) const {
+    std::uint64_t rowsBytes = memoryBytes();
+
+    IndexHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kIndexMagic, sizeof(kIndexMagic));
+    header.version = kIndexVersion;
+    header.flags = saturated_ ? kSaturatedFlag : 0;
+    header.vertexCount = static_cast<std::uint64_t>(vertexCount_);
+    header.levelCount = static_cast<std::uint64_t>(levelCount_);
+    header.wordsPerRow = wordsPerRow_;
+    header.arcCount = static_cast<std::uint64_t>(arcCount_);
+    header.graphChecksum = graphChecksum_;
+    header.rowsChecksum = CSRGraph::checksum(rows_, rowsBytes, kRowsSeed);
+
+    std::string tempName = filename + ".tmp";
+    {
+        std::ofstream out(tempName, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("Не удалось создать файл индекса: " + tempName);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(rows_), static_cast<std::streamsize>(rowsBytes));
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Ошибка записи индекса: " + tempName);
+        }
+    }
+
+    if (std::rename(tempName.c_str(), filename.c_str()) != 0) {
+        std::remove(tempName.c_str());
+        throw std::runtime_error("Не удалось переименовать индекс в " + filename);
+    }
+}
+
+std::string ReachabilityIndex::pathFor(const std::string& graphFilename) {
+    return graphFilename + ".reach";
+}
@@ -0,0 +1,143 @@
+/**
+ * @file reachability_index.h
+ * @brief Индекс достижимости за L + 1 ребер на степенях матрицы смежности
+ * @version 1.1
+ *
+ * Для каждого расстояния d = 1..D хранится битовая матрица
+ * R_d = (A + I)^d: строка v - все вершины в пределах d ребер от v.
+ * Запрос findCommonCities(k1, k2, L) сводится к AND строк R_{L+1}.
+ * Индекс строится один раз, сохраняется рядом с графом и отображается
+ * в память при следующих запусках.
+ */
+
+#ifndef REACHABILITY_INDEX_H
+#define REACHABILITY_INDEX_H
+
+#include "csr_graph.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+class ThreadPool;
+
+/**
+ * @class ReachabilityIndex
+ * @brief Матрицы R_1..R_D, неизменяемые и разделяемые между копиями
+ *
+ * Если R_{D+1} = R_D (достигнуто замыкание), индекс помечается
+ * насыщенным и отвечает на запросы с любым L.
+ * Копирование - O(1): копии разделяют одно хранилище.
+ */
+class ReachabilityIndex {
+private:
+    int vertexCount_;
+    int levelCount_;              ///< Количество хранимых матриц D
+    bool saturated_;              ///< R_D - замыкание, дальше матрицы не меняются
+    std::int64_t arcCount_;       ///< Количество дуг графа, по которому построен индекс
+    std::uint64_t graphChecksum_; ///< CSRGraph::checksum() графа, по которому построен индекс
+    std::size_t wordsPerRow_;
+    const std::uint64_t* rows_;   ///< D × vertexCount строк по wordsPerRow слов
+    std::shared_ptr<const void> storage_;
+
+public:
+    /**
+     * @brief Конструктор пустого индекса (не отвечает ни на один запрос)
+     */
+    ReachabilityIndex();
+
+    /**
+     * @brief Построение индекса для L = 0..maxL
+     *
+     * R_1 = A + I, далее R_{d+1} = R_1 · R_d булевым произведением
+     * методом четырех русских. Память - (maxL + 1) · n² / 8 байт.
+     * @param graph Граф
+     * @param maxL Наибольшее L (хранятся расстояния 1..maxL + 1)
+     * @param pool Пул потоков для произведений (nullptr - один поток)
+     * @return ReachabilityIndex Индекс
+     * @throws std::runtime_error при отрицательном maxL
+     */
+    static ReachabilityIndex build(const CSRGraph& graph, int maxL, ThreadPool* pool = nullptr);
+
+    /**
+     * @brief Загрузка индекса, сохраненного save()
+     *
+     * Файл отображается в память без копирования. Без проверки граф
+     * сверяется по числу вершин и дуг, а матрицы - по размеру файла
+     * @param filename Имя файла индекса
+     * @param graph Граф, к которому относится индекс
+     * @param verifyChecksum Проверять контрольные суммы графа и матриц
+     * @return ReachabilityIndex Индекс
+     * @throws std::runtime_error если файл поврежден или построен для другого графа
+     */
+    static ReachabilityIndex load(const std::string& filename, const CSRGraph& graph,
+                                  bool verifyChecksum = true);
+
+    /**
+     * @brief Сохранение индекса (через временный файл и атомарную замену)
+     * @param filename Имя файла индекса
+     * @throws std::runtime_error при ошибке записи
+     */
+    void save(const std::string& filename) const;
+
+    /**
+     * @brief Имя файла индекса для файла графа
+     * @param graphFilename Имя файла графа
+     * @return std::string graphFilename + ".reach"
+     */
+    static std::string pathFor(const std::string& graphFilename);
+
+    /**
+     * @brief Отвечает ли индекс на запросы с данным L
+     * @param L Количество промежуточных городов
+     * @return true если R_{L+1} есть в индексе
+     */
+    bool covers(int L) const {
+        return levelCount_ > 0 && L >= 0 && (saturated_ || L < levelCount_);
+    }
+
+    /**
+     * @brief Строка R_{L+1}: вершины в пределах L + 1 ребер (включая саму вершину)
+     * @param L Количество промежуточных городов (covers(L) == true)
+     * @param vertex Вершина (0-based)
+     * @return const std::uint64_t* Указатель на wordsPerRow() слов
+     */
+    const std::uint64_t* row(int L, int vertex) const {
+        std::size_t level = static_cast<std::size_t>(L < levelCount_ ? L : levelCount_ - 1);
+        return rows_ + (level * vertexCount_ + vertex) * wordsPerRow_;
+    }
+
+    /**
+     * @brief Количество вершин
+     * @return int Количество вершин
+     */
+    int vertexCount() const { return vertexCount_; }
+
+    /**
+     * @brief Количество хранимых матриц
+     * @return int D (0 для пустого индекса)
+     */
+    int levelCount() const { return levelCount_; }
+
+    /**
+     * @brief Достигнуто ли замыкание
+     * @return true если индекс отвечает на любое L
+     */
+    bool saturated() const { return saturated_; }
+
+    /**
+     * @brief Количество 64-битных слов в строке
+     * @return std::size_t Длина строки в словах
+     */
+    std::size_t wordsPerRow() const { return wordsPerRow_; }
+
+    /**
+     * @brief Объем матриц
+     * @return std::uint64_t Размер в байтах
+     */
+    std::uint64_t memoryBytes() const {
+        return static_cast<std::uint64_t>(levelCount_) * vertexCount_ * wordsPerRow_ * sizeof(std::uint64_t);
+    }
+};
+
+#endif // REACHABILITY_INDEX_H
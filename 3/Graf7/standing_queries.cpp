@@ -0,0 +1,309 @@
+/**
+ * @file standing_queries.cpp
+ * @brief Реализация постоянных запросов на изменяемом графе
+ * @version 1.0
+ */
+
+#include "standing_queries.h"
+#include "graph_utils.h"
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+StandingQueries::StandingQueries(const CSRGraph& graph)
+    : graph_(DynamicGraph::fromCSR(graph)), lastRepairSize_(0),
+      mark_(static_cast<std::size_t>(graph.vertexCount()), 0), epoch_(0),
+      tentative_(static_cast<std::size_t>(graph.vertexCount()), INT_MAX) {}
+
+int StandingQueries::watch(int k1, int k2, int L) {
+    checkCity(k1, "K1");
+    checkCity(k2, "K2");
+    if (k1 == k2) {
+        throw std::runtime_error("K1 и K2 не могут быть одинаковыми");
+    }
+    if (!GraphUtils::isValidL(L)) {
+        throw std::runtime_error("Некорректное значение L: " + std::to_string(L));
+    }
+
+    int id = static_cast<int>(watches_.size());
+    Watch created;
+    created.source1 = k1 - 1;
+    created.source2 = k2 - 1;
+    created.maxDistance = L + 1;
+    created.active = true;
+    created.members = DenseBitset(static_cast<std::size_t>(graph_.vertexCount()));
+
+    // Расстояния источника считаются заново, только если нужна большая глубина
+    int sources[2] = {created.source1, created.source2};
+    for (int source : sources) {
+        SourceDistances& entry = sources_[source];
+        if (entry.distances.empty() || entry.depth < created.maxDistance) {
+            entry.depth = std::max(entry.depth, created.maxDistance);
+            computeDistances(source, entry);
+        }
+        entry.watches.push_back(id);
+    }
+
+    const std::vector<int>& distances1 = sources_[created.source1].distances;
+    const std::vector<int>& distances2 = sources_[created.source2].distances;
+    for (int v = 0; v < graph_.vertexCount(); ++v) {
+        if (isMember(created, distances1, distances2, v)) {
+            created.members.set(v);
+        }
+    }
+
+    watches_.push_back(std::move(created));
+    return id;
+}
+
+void StandingQueries::unwatch(int id) {
+    activeWatch(id);
+    Watch& removed = watches_[id];
+    removed.active = false;
+    removed.members = DenseBitset();
+
+    int sources[2] = {removed.source1, removed.source2};
+    for (int source : sources) {
+        std::map<int, SourceDistances>::iterator entry = sources_.find(source);
+        std::vector<int>& users = entry->second.watches;
+        users.erase(std::remove(users.begin(), users.end(), id), users.end());
+        if (users.empty()) {
+            sources_.erase(entry);
+        }
+    }
+}
+
+std::vector<int> StandingQueries::result(int id) const {
+    std::vector<int> cities = activeWatch(id).members.toVector();
+    for (int& city : cities) {
+        city += 1;
+    }
+    if (cities.empty()) {
+        cities.push_back(-1);
+    }
+    return cities;
+}
+
+bool StandingQueries::addEdge(int a, int b) {
+    checkCity(a, "города");
+    checkCity(b, "города");
+    int u = a - 1;
+    int v = b - 1;
+    if (!graph_.addEdge(u, v)) {
+        return false;
+    }
+
+    lastRepairSize_ = 0;
+    std::vector<int> changed;
+    for (std::map<int, SourceDistances>::iterator it = sources_.begin(); it != sources_.end(); ++it) {
+        changed.clear();
+        relaxInsertion(it->second, u, v, changed);
+        relaxInsertion(it->second, v, u, changed);
+        lastRepairSize_ += changed.size();
+        refreshWatches(it->second, changed);
+    }
+    return true;
+}
+
+bool StandingQueries::removeEdge(int a, int b) {
+    checkCity(a, "города");
+    checkCity(b, "города");
+    int u = a - 1;
+    int v = b - 1;
+    if (!graph_.removeEdge(u, v)) {
+        return false;
+    }
+
+    lastRepairSize_ = 0;
+    std::vector<int> changed;
+    for (std::map<int, SourceDistances>::iterator it = sources_.begin(); it != sources_.end(); ++it) {
+        changed.clear();
+        repairDeletion(it->second, u, v, changed);
+        repairDeletion(it->second, v, u, changed);
+        lastRepairSize_ += changed.size();
+        refreshWatches(it->second, changed);
+    }
+    return true;
+}
+
+void StandingQueries::computeDistances(int source, SourceDistances& entry) const {
+    entry.distances.assign(static_cast<std::size_t>(graph_.vertexCount()), -1);
+    entry.distances[source] = 0;
+
+    std::vector<int> queue(1, source);
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        int current = queue[head];
+        int next = entry.distances[current] + 1;
+        if (next > entry.depth) {
+            continue;
+        }
+        for (int neighbor : graph_.neighbors(current)) {
+            if (entry.distances[neighbor] == -1) {
+                entry.distances[neighbor] = next;
+                queue.push_back(neighbor);
+            }
+        }
+    }
+}
+
+void StandingQueries::relaxInsertion(SourceDistances& entry, int from, int to,
+                                     std::vector<int>& changed) const {
+    std::vector<int>& distances = entry.distances;
+    if (distances[from] == -1 || distances[from] + 1 > entry.depth) {
+        return;
+    }
+    if (distances[to] != -1 && distances[to] <= distances[from] + 1) {
+        return;
+    }
+
+    // Волна в порядке BFS: каждая вершина уменьшается не больше одного раза
+    std::size_t first = changed.size();
+    distances[to] = distances[from] + 1;
+    changed.push_back(to);
+    for (std::size_t i = first; i < changed.size(); ++i) {
+        int current = changed[i];
+        int next = distances[current] + 1;
+        if (next > entry.depth) {
+            continue;
+        }
+        for (int neighbor : graph_.neighbors(current)) {
+            if (distances[neighbor] == -1 || distances[neighbor] > next) {
+                distances[neighbor] = next;
+                changed.push_back(neighbor);
+            }
+        }
+    }
+}
+
+void StandingQueries::repairDeletion(SourceDistances& entry, int parent, int child,
+                                     std::vector<int>& changed) {
+    std::vector<int>& distances = entry.distances;
+    if (distances[parent] == -1 || distances[child] != distances[parent] + 1) {
+        return;
+    }
+
+    ++epoch_;
+    if (hasUnmarkedParent(distances, child)) {
+        return;
+    }
+
+    // Затронутые вершины: все родители на предыдущем уровне затронуты.
+    // Вершина перепроверяется каждый раз, когда затронутым становится
+    // один из ее родителей, так что решение принимается по последнему
+    std::vector<int> affected(1, child);
+    mark_[child] = epoch_;
+    for (std::size_t i = 0; i < affected.size(); ++i) {
+        int current = affected[i];
+        for (int neighbor : graph_.neighbors(current)) {
+            if (distances[neighbor] == distances[current] + 1 && mark_[neighbor] != epoch_ &&
+                !hasUnmarkedParent(distances, neighbor)) {
+                mark_[neighbor] = epoch_;
+                affected.push_back(neighbor);
+            }
+        }
+    }
+
+    // Начальные оценки - через незатронутых соседей
+    std::vector<int> previous(affected.size());
+    std::vector<std::pair<int, int>> seeds;
+    for (std::size_t i = 0; i < affected.size(); ++i) {
+        int v = affected[i];
+        previous[i] = distances[v];
+        int best = INT_MAX;
+        for (int neighbor : graph_.neighbors(v)) {
+            if (mark_[neighbor] != epoch_ && distances[neighbor] != -1) {
+                best = std::min(best, distances[neighbor] + 1);
+            }
+        }
+        tentative_[v] = best;
+        if (best <= entry.depth) {
+            seeds.push_back(std::make_pair(best, v));
+        }
+    }
+    for (int v : affected) {
+        distances[v] = -1;
+    }
+    std::sort(seeds.begin(), seeds.end());
+
+    // Слияние отсортированных оценок с волной BFS внутри затронутой области
+    std::vector<std::pair<int, int>> wave;
+    std::size_t seed = 0;
+    std::size_t head = 0;
+    while (seed < seeds.size() || head < wave.size()) {
+        std::pair<int, int> next = (head < wave.size() &&
+                                    (seed == seeds.size() || wave[head].first <= seeds[seed].first))
+            ? wave[head++] : seeds[seed++];
+        int v = next.second;
+        if (distances[v] != -1) {
+            continue;
+        }
+        distances[v] = next.first;
+        int level = next.first + 1;
+        if (level > entry.depth) {
+            continue;
+        }
+        for (int neighbor : graph_.neighbors(v)) {
+            if (mark_[neighbor] == epoch_ && distances[neighbor] == -1 && level < tentative_[neighbor]) {
+                tentative_[neighbor] = level;
+                wave.push_back(std::make_pair(level, neighbor));
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < affected.size(); ++i) {
+        tentative_[affected[i]] = INT_MAX;
+        if (distances[affected[i]] != previous[i]) {
+            changed.push_back(affected[i]);
+        }
+    }
+}
+
+bool StandingQueries::hasUnmarkedParent(const std::vector<int>& distances, int v) const {
+    for (int neighbor : graph_.neighbors(v)) {
+        if (distances[neighbor] != -1 && distances[neighbor] + 1 == distances[v] &&
+            mark_[neighbor] != epoch_) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void StandingQueries::refreshWatches(const SourceDistances& entry, const std::vector<int>& changed) {
+    if (changed.empty()) {
+        return;
+    }
+    for (int id : entry.watches) {
+        Watch& current = watches_[id];
+        const std::vector<int>& distances1 = sources_[current.source1].distances;
+        const std::vector<int>& distances2 = sources_[current.source2].distances;
+        for (int v : changed) {
+            if (isMember(current, distances1, distances2, v)) {
+                current.members.set(v);
+            } else {
+                current.members.reset(v);
+            }
+        }
+    }
+}
+
+bool StandingQueries::isMember(const Watch& watch, const std::vector<int>& distances1,
+                               const std::vector<int>& distances2, int v) {
+    return v != watch.source1 && v != watch.source2 &&
+           distances1[v] != -1 && distances1[v] <= watch.maxDistance &&
+           distances2[v] != -1 && distances2[v] <= watch.maxDistance;
+}
+
+const StandingQueries::Watch& StandingQueries::activeWatch(int id) const {
+    if (id < 0 || id >= static_cast<int>(watches_.size()) || !watches_[id].active) {
+        throw std::runtime_error("Нет постоянного запроса с номером " + std::to_string(id));
+    }
+    return watches_[id];
+}
+
+void StandingQueries::checkCity(int city, const char* name) const {
+    if (!GraphUtils::isValidCity(city, graph_.vertexCount())) {
+        throw std::runtime_error(std::string("Некорректный номер ") + name + ": " + std::to_string(city));
+    }
+}
@@ -0,0 +1,199 @@
+/**
+ * @file standing_queries.h
+ * @brief Постоянные запросы на изменяемом графе
+ * @version 1.0
+ *
+ * Граф меняется в течение дня (дороги закрываются и открываются),
+ * а ответы на зарегистрированные запросы "K1 K2 L" поддерживаются
+ * актуальными: кэшированные расстояния от штаб-квартир
+ * исправляются локально вместо повторного BFS.
+ */
+
+#ifndef STANDING_QUERIES_H
+#define STANDING_QUERIES_H
+
+#include "dense_bitset.h"
+#include "dynamic_graph.h"
+#include <cstddef>
+#include <map>
+#include <vector>
+
+/**
+ * @class StandingQueries
+ * @brief Изменяемый граф и набор постоянных запросов к нему
+ *
+ * Для каждой штаб-квартиры хранится массив расстояний, усеченный на
+ * наибольшей глубине L + 1 среди ее запросов (дальше - -1).
+ * Добавление ребра запускает волну релаксации от его концов;
+ * удаление находит вершины, потерявшие все кратчайшие пути
+ * (их родители на предыдущем уровне затронуты), и пересчитывает
+ * только их - по уровням от ближайших незатронутых соседей.
+ * Затем у запросов перепроверяются только вершины с изменившимся расстоянием.
+ * Номера городов в интерфейсе - с 1, как у GraphAnalyzer.
+ */
+class StandingQueries {
+private:
+    /**
+     * @struct SourceDistances
+     * @brief Усеченные расстояния от одной штаб-квартиры
+     */
+    struct SourceDistances {
+        int depth = 0;                ///< Расстояния больше depth не хранятся (-1)
+        std::vector<int> distances;   ///< Расстояние в ребрах или -1
+        std::vector<int> watches;     ///< Запросы, использующие эти расстояния
+    };
+
+    /**
+     * @struct Watch
+     * @brief Постоянный запрос и его текущий ответ
+     */
+    struct Watch {
+        int source1 = 0;              ///< Первая штаб-квартира (0-based)
+        int source2 = 0;              ///< Вторая штаб-квартира (0-based)
+        int maxDistance = 0;          ///< L + 1
+        bool active = false;          ///< false после unwatch
+        DenseBitset members;          ///< Общие города (0-based)
+    };
+
+    DynamicGraph graph_;
+    std::map<int, SourceDistances> sources_;
+    std::vector<Watch> watches_;
+    std::size_t lastRepairSize_;      ///< Вершин с изменившимся расстоянием при последнем изменении
+
+    // Рабочие массивы исправления (общие для всех источников)
+    std::vector<int> mark_;           ///< Эпоха, в которую вершина помечена затронутой
+    int epoch_;
+    std::vector<int> tentative_;      ///< Предварительные расстояния затронутых вершин
+
+public:
+    /**
+     * @brief Конструктор
+     * @param graph Исходный граф
+     */
+    explicit StandingQueries(const CSRGraph& graph);
+
+    /**
+     * @brief Регистрация постоянного запроса
+     * @param k1 Первая штаб-квартира (1..cityCount)
+     * @param k2 Вторая штаб-квартира (1..cityCount)
+     * @param L Максимальное количество промежуточных городов
+     * @return int Идентификатор запроса
+     * @throws std::runtime_error при некорректных параметрах
+     */
+    int watch(int k1, int k2, int L);
+
+    /**
+     * @brief Снятие постоянного запроса
+     * @param id Идентификатор из watch()
+     * @throws std::runtime_error если запроса нет
+     */
+    void unwatch(int id);
+
+    /**
+     * @brief Текущий ответ на постоянный запрос
+     * @param id Идентификатор из watch()
+     * @return std::vector<int> Номера общих городов или {-1}, как у findCommonCities
+     * @throws std::runtime_error если запроса нет
+     */
+    std::vector<int> result(int id) const;
+
+    /**
+     * @brief Добавление дороги
+     * @param a Первый город (1..cityCount)
+     * @param b Второй город (1..cityCount)
+     * @return false если дорога уже была
+     * @throws std::runtime_error при некорректном номере города
+     */
+    bool addEdge(int a, int b);
+
+    /**
+     * @brief Удаление дороги
+     * @param a Первый город (1..cityCount)
+     * @param b Второй город (1..cityCount)
+     * @return false если дороги не было
+     * @throws std::runtime_error при некорректном номере города
+     */
+    bool removeEdge(int a, int b);
+
+    /**
+     * @brief Размер затронутой области при последнем изменении
+     * @return std::size_t Сумма по штаб-квартирам числа вершин с новым расстоянием
+     */
+    std::size_t lastRepairSize() const { return lastRepairSize_; }
+
+    /**
+     * @brief Текущий граф
+     * @return const DynamicGraph& Граф (для фиксации в CSR - toCSR())
+     */
+    const DynamicGraph& graph() const { return graph_; }
+
+private:
+    /**
+     * @brief Полный усеченный BFS от штаб-квартиры
+     * @param source Штаб-квартира (0-based)
+     * @param entry Расстояния (depth уже задана)
+     */
+    void computeDistances(int source, SourceDistances& entry) const;
+
+    /**
+     * @brief Волна релаксации после добавления дуги from → to
+     * @param entry Расстояния источника
+     * @param from Начало дуги
+     * @param to Конец дуги
+     * @param[out] changed Вершины с уменьшившимся расстоянием
+     */
+    void relaxInsertion(SourceDistances& entry, int from, int to, std::vector<int>& changed) const;
+
+    /**
+     * @brief Исправление после удаления дуги parent → child
+     * @param entry Расстояния источника
+     * @param parent Бывший родитель
+     * @param child Вершина, возможно потерявшая кратчайший путь
+     * @param[out] changed Вершины с увеличившимся расстоянием
+     */
+    void repairDeletion(SourceDistances& entry, int parent, int child, std::vector<int>& changed);
+
+    /**
+     * @brief Есть ли у вершины родитель вне затронутой области
+     * @param distances Расстояния источника
+     * @param v Вершина
+     * @return true если сосед на уровень ближе не помечен
+     */
+    bool hasUnmarkedParent(const std::vector<int>& distances, int v) const;
+
+    /**
+     * @brief Перепроверка вершин у запросов, использующих источник
+     * @param entry Расстояния источника
+     * @param changed Вершины с изменившимся расстоянием
+     */
+    void refreshWatches(const SourceDistances& entry, const std::vector<int>& changed);
+
+    /**
+     * @brief Принадлежность вершины ответу запроса
+     * @param watch Запрос
+     * @param distances1 Расстояния от первой штаб-квартиры
+     * @param distances2 Расстояния от второй штаб-квартиры
+     * @param v Вершина (0-based)
+     * @return true если v в пределах maxDistance от обеих штаб-квартир и не штаб-квартира
+     */
+    static bool isMember(const Watch& watch, const std::vector<int>& distances1,
+                         const std::vector<int>& distances2, int v);
+
+    /**
+     * @brief Проверка номера запроса
+     * @param id Идентификатор
+     * @return const Watch& Активный запрос
+     * @throws std::runtime_error если запроса нет
+     */
+    const Watch& activeWatch(int id) const;
+
+    /**
+     * @brief Проверка номера города
+     * @param city Номер города (1-based)
+     * @param name Имя параметра для сообщения
+     * @throws std::runtime_error при некорректном номере
+     */
+    void checkCity(int city, const char* name) const;
+};
+
+#endif // STANDING_QUERIES_H
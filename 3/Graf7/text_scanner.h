@@ -0,0 +1,116 @@
+/**
+ * @file text_scanner.h
+ * @brief Быстрый разбор целых чисел из буфера в памяти
+ * @version 1.0
+ *
+ * Замена std::ifstream >> для больших файлов: без локалей,
+ * без копирования, с минимумом ветвлений на цифру
+ */
+
+#ifndef TEXT_SCANNER_H
+#define TEXT_SCANNER_H
+
+#include <cstdint>
+
+/**
+ * @class TextScanner
+ * @brief Последовательный разбор целых чисел из текстового буфера
+ *
+ * Разделителями считаются пробелы, табуляции и переводы строк.
+ * Буфер не обязан заканчиваться нулевым символом.
+ */
+class TextScanner {
+private:
+    const char* pos_;
+    const char* end_;
+
+public:
+    /**
+     * @brief Конструктор
+     * @param begin Начало буфера
+     * @param end Конец буфера
+     */
+    TextScanner(const char* begin, const char* end) : pos_(begin), end_(end) {}
+
+    /**
+     * @brief Чтение следующего целого числа
+     * @param[out] value Прочитанное значение
+     * @return false если данные закончились или встречено не число
+     */
+    bool next(std::int64_t& value) {
+        skipWhitespace();
+        return parse(value);
+    }
+
+    /**
+     * @brief Чтение следующего числа только в пределах текущей строки
+     * @param[out] value Прочитанное значение
+     * @return false если до конца строки чисел больше нет
+     */
+    bool nextOnLine(std::int64_t& value) {
+        while (pos_ < end_ && (*pos_ == ' ' || *pos_ == '\t' || *pos_ == '\r')) {
+            ++pos_;
+        }
+        if (pos_ == end_ || *pos_ == '\n') {
+            return false;
+        }
+        return parse(value);
+    }
+
+    /**
+     * @brief Переход к началу следующей строки
+     */
+    void skipLine() {
+        while (pos_ < end_ && *pos_ != '\n') {
+            ++pos_;
+        }
+        if (pos_ < end_) {
+            ++pos_;
+        }
+    }
+
+    /**
+     * @brief Проверка, что после текущей позиции остались только пробелы
+     * @return true если непрочитанных данных нет
+     */
+    bool atEnd() {
+        skipWhitespace();
+        return pos_ == end_;
+    }
+
+private:
+    void skipWhitespace() {
+        // ' ', '\t', '\n', '\r' - все меньше или равны пробелу
+        while (pos_ < end_ && static_cast<unsigned char>(*pos_) <= ' ') {
+            ++pos_;
+        }
+    }
+
+    bool parse(std::int64_t& value) {
+        bool negative = false;
+        if (pos_ < end_ && *pos_ == '-') {
+            negative = true;
+            ++pos_;
+        }
+
+        const char* start = pos_;
+        std::uint64_t result = 0;
+        unsigned digit;
+        // Не более 18 цифр: значение гарантированно помещается в int64
+        const char* limit = end_ - pos_ > 18 ? pos_ + 18 : end_;
+        while (pos_ < limit && (digit = static_cast<unsigned>(*pos_ - '0')) < 10) {
+            result = result * 10 + digit;
+            ++pos_;
+        }
+
+        // Пустое число, слишком длинное число или мусор сразу после цифр
+        if (pos_ == start || (pos_ < end_ && static_cast<unsigned char>(*pos_) > ' ')) {
+            return false;
+        }
+
+        value = negative ? -static_cast<std::int64_t>(result) : static_cast<std::int64_t>(result);
+        return true;
+    }
+};
+
+#endif // TEXT_SCANNER_H
@@ -0,0 +1,109 @@
+/**
+ * @file thread_pool.h
+ * @brief Пул потоков для параллельных обходов графа
+ * @version 1.0
+ *
+ * Потоки создаются один раз и засыпают между заданиями, поэтому
+ * запуск уровня BFS не платит за создание потоков
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Фиксированный набор потоков, выполняющих одно задание сообща
+ *
+ * Вызывающий поток участвует в работе как исполнитель 0.
+ * Задания запускаются из одного потока; исключения из задания не допускаются.
+ */
+class ThreadPool {
+private:
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(int)>* task_;
+    std::uint64_t generation_;
+    std::size_t pending_;
+    bool stopping_;
+
+    /**
+     * @brief Цикл фонового исполнителя
+     * @param worker Номер исполнителя (1..size()-1)
+     */
+    void workerLoop(int worker);
+
+public:
+    /**
+     * @brief Конструктор
+     * @param threadCount Количество исполнителей вместе с вызывающим потоком
+     *                    (0 - по числу аппаратных потоков)
+     */
+    explicit ThreadPool(int threadCount = 0);
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Деструктор - останавливает и дожидается потоков
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Количество исполнителей (включая вызывающий поток)
+     * @return int Количество исполнителей
+     */
+    int size() const { return static_cast<int>(workers_.size()) + 1; }
+
+    /**
+     * @brief Выполнение задания всеми исполнителями
+     *
+     * Возвращает управление, когда задание завершено на всех исполнителях
+     * @param task Задание, получающее номер исполнителя 0..size()-1
+     */
+    void run(const std::function<void(int)>& task);
+
+    /**
+     * @brief Параллельный цикл по диапазону 0..count-1
+     *
+     * Диапазон раздается блоками по grain элементов через общий атомарный
+     * счетчик, так что неравномерная работа распределяется динамически.
+     * Диапазон из одного блока выполняется в вызывающем потоке.
+     * @param count Длина диапазона
+     * @param grain Размер блока
+     * @param body Вызывается как body(begin, end, worker)
+     */
+    template <typename Body>
+    void parallelFor(std::size_t count, std::size_t grain, const Body& body) {
+        grain = std::max<std::size_t>(grain, 1);
+        if (count <= grain || workers_.empty()) {
+            if (count > 0) {
+                body(std::size_t(0), count, 0);
+            }
+            return;
+        }
+        std::atomic<std::size_t> next(0);
+        run([&](int worker) {
+            for (;;) {
+                std::size_t begin = next.fetch_add(grain, std::memory_order_relaxed);
+                if (begin >= count) {
+                    break;
+                }
+                body(begin, std::min(count, begin + grain), worker);
+            }
+        });
+    }
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,257 @@
+/**
+ * @file vertex_order.cpp
+ * @brief Реализация перенумерации вершин
+ * @version 1.1
+ */
+
+#include "vertex_order.h"
+#include "adjacency.h"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+/**
+ * @brief Вершины в порядке возрастания степени (при равной - по номеру)
+ * @param graph Граф
+ * @return std::vector<int> Номера вершин
+ */
+template <class Adjacency>
+std::vector<int> verticesByDegree(const Adjacency& graph) {
+    std::vector<int> vertices(static_cast<std::size_t>(graph.vertexCount()));
+    std::iota(vertices.begin(), vertices.end(), 0);
+    std::stable_sort(vertices.begin(), vertices.end(), [&graph](int a, int b) {
+        return graph.degree(a) < graph.degree(b);
+    });
+    return vertices;
+}
+
+/**
+ * @brief BFS по еще не размещенным вершинам с добавлением в порядок
+ * @param graph Граф
+ * @param start Начальная вершина (не размещена)
+ * @param byDegree true - новые соседи каждой вершины по возрастанию степени
+ * @param placed Отметки размещенных вершин
+ * @param sequence Порядок вершин (дополняется)
+ */
+template <class Adjacency>
+void appendBreadthFirst(Adjacency& graph, int start, bool byDegree,
+                        std::vector<char>& placed, std::vector<int>& sequence) {
+    std::size_t head = sequence.size();
+    placed[start] = 1;
+    sequence.push_back(start);
+    for (; head < sequence.size(); ++head) {
+        int current = sequence[head];
+        std::size_t first = sequence.size();
+        NeighborRange range = graph.neighbors(current);
+        for (const int* it = range.first; it != range.second; ++it) {
+            if (!placed[*it]) {
+                placed[*it] = 1;
+                sequence.push_back(*it);
+            }
+        }
+        if (byDegree) {
+            std::stable_sort(sequence.begin() + first, sequence.end(), [&graph](int a, int b) {
+                return graph.degree(a) < graph.degree(b);
+            });
+        }
+    }
+}
+
+/**
+ * @brief Псевдопериферийная вершина (алгоритм Джорджа-Лю)
+ *
+ * BFS повторяется от вершины наименьшей степени на последнем уровне,
+ * пока глубина растет
+ * @param graph Граф
+ * @param root Вершина, с которой начинается поиск
+ * @param placed Отметки размещенных вершин (обход их не посещает)
+ * @param level Рабочий массив уровней (на выходе снова -1)
+ * @return int Найденная вершина
+ */
+template <class Adjacency>
+int pseudoPeripheralVertex(Adjacency& graph, int root, const std::vector<char>& placed,
+                           std::vector<int>& level) {
+    std::vector<int> queue;
+    int depth = -1;
+    for (;;) {
+        queue.assign(1, root);
+        level[root] = 0;
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            int current = queue[head];
+            NeighborRange range = graph.neighbors(current);
+            for (const int* it = range.first; it != range.second; ++it) {
+                if (!placed[*it] && level[*it] == -1) {
+                    level[*it] = level[current] + 1;
+                    queue.push_back(*it);
+                }
+            }
+        }
+
+        int lastLevel = level[queue.back()];
+        int candidate = queue.back();
+        for (std::size_t i = queue.size(); i-- > 0 && level[queue[i]] == lastLevel;) {
+            if (graph.degree(queue[i]) <= graph.degree(candidate)) {
+                candidate = queue[i];
+            }
+        }
+        for (int v : queue) {
+            level[v] = -1;
+        }
+
+        if (lastLevel <= depth) {
+            return root;
+        }
+        depth = lastLevel;
+        root = candidate;
+    }
+}
+
+} // namespace
+
+VertexPermutation::VertexPermutation() : order_(VertexOrder::Original) {}
+
+VertexPermutation::VertexPermutation(VertexOrder order, std::vector<int> sequence)
+    : order_(order), internal_(sequence.size()), original_(std::move(sequence)) {
+    for (std::size_t i = 0; i < original_.size(); ++i) {
+        internal_[original_[i]] = static_cast<int>(i);
+    }
+}
+
+VertexPermutation VertexPermutation::compute(const CSRGraph& graph, VertexOrder order) {
+    CSRAdjacency adjacency(graph);
+    return computeFrom(adjacency, order);
+}
+
+VertexPermutation VertexPermutation::compute(const CompressedGraph& graph, VertexOrder order) {
+    CompressedAdjacency adjacency(graph);
+    return computeFrom(adjacency, order);
+}
+
+template <class Adjacency>
+VertexPermutation VertexPermutation::computeFrom(Adjacency& graph, VertexOrder order) {
+    if (order == VertexOrder::Original) {
+        return VertexPermutation();
+    }
+
+    int n = graph.vertexCount();
+    std::vector<int> vertices = verticesByDegree(graph);
+    if (order == VertexOrder::Degree) {
+        std::stable_sort(vertices.begin(), vertices.end(), [&graph](int a, int b) {
+            return graph.degree(a) > graph.degree(b);
+        });
+        return VertexPermutation(order, std::move(vertices));
+    }
+
+    std::vector<char> placed(static_cast<std::size_t>(n), 0);
+    std::vector<int> sequence;
+    sequence.reserve(static_cast<std::size_t>(n));
+    if (order == VertexOrder::BreadthFirst) {
+        // Компоненты начинаются с вершины наибольшей степени
+        for (std::size_t i = vertices.size(); i-- > 0;) {
+            if (!placed[vertices[i]]) {
+                appendBreadthFirst(graph, vertices[i], false, placed, sequence);
+            }
+        }
+        return VertexPermutation(order, std::move(sequence));
+    }
+
+    // Катхилл-Макки по компонентам, затем весь порядок разворачивается.
+    // По исходящим дугам найденная вершина может не достигать
+    // кандидата - тогда обход повторяется
+    std::vector<int> level(static_cast<std::size_t>(n), -1);
+    for (int candidate : vertices) {
+        while (!placed[candidate]) {
+            int start = pseudoPeripheralVertex(graph, candidate, placed, level);
+            appendBreadthFirst(graph, start, true, placed, sequence);
+        }
+    }
+    std::reverse(sequence.begin(), sequence.end());
+    return VertexPermutation(order, std::move(sequence));
+}
+
+CSRGraph VertexPermutation::apply(const CSRGraph& graph) const {
+    if (isIdentity()) {
+        return graph;
+    }
+    return scatter(graph);
+}
+
+DirectedGraph VertexPermutation::apply(const DirectedGraph& graph) const {
+    if (isIdentity()) {
+        return graph;
+    }
+    DirectedGraph relabeled;
+    relabeled.forward = scatter(graph.reverse);
+    relabeled.reverse = scatter(graph.forward);
+    return relabeled;
+}
+
+CSRGraph VertexPermutation::scatter(const CSRGraph& graph) const {
+    int n = graph.vertexCount();
+    if (static_cast<std::size_t>(n) != original_.size()) {
+        throw std::runtime_error("Перестановка построена для графа другого размера");
+    }
+
+    std::vector<std::int64_t> offsets(static_cast<std::size_t>(n) + 1, 0);
+    const int* arcs = graph.neighborsData();
+    for (std::int64_t i = 0; i < graph.arcCount(); ++i) {
+        ++offsets[internal_[arcs[i]] + 1];
+    }
+    for (int v = 0; v < n; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+
+    // Источники перебираются по возрастанию нового номера - строки сразу отсортированы
+    std::vector<int> neighbors(static_cast<std::size_t>(graph.arcCount()));
+    std::vector<std::uint32_t> weights(graph.isWeighted() ? neighbors.size() : 0);
+    std::vector<std::int64_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (int u = 0; u < n; ++u) {
+        int source = original_[u];
+        const int* begin = graph.neighborsBegin(source);
+        for (const int* it = begin; it != graph.neighborsEnd(source); ++it) {
+            std::int64_t position = cursor[internal_[*it]]++;
+            neighbors[position] = u;
+            if (graph.isWeighted()) {
+                weights[position] = graph.weightsBegin(source)[it - begin];
+            }
+        }
+    }
+
+    if (!graph.isWeighted()) {
+        return CSRGraph(n, std::move(offsets), std::move(neighbors));
+    }
+    return CSRGraph(n, std::move(offsets), std::move(neighbors), std::move(weights));
+}
+
+VertexOrder VertexPermutation::parseOrder(const std::string& name) {
+    if (name == "none") {
+        return VertexOrder::Original;
+    }
+    if (name == "degree") {
+        return VertexOrder::Degree;
+    }
+    if (name == "bfs") {
+        return VertexOrder::BreadthFirst;
+    }
+    if (name == "rcm") {
+        return VertexOrder::ReverseCuthillMcKee;
+    }
+    throw std::runtime_error("Неизвестный способ перенумерации: " + name);
+}
+
+const char* VertexPermutation::orderName(VertexOrder order) {
+    if (order == VertexOrder::Degree) {
+        return "degree";
+    }
+    if (order == VertexOrder::BreadthFirst) {
+        return "bfs";
+    }
+    if (order == VertexOrder::ReverseCuthillMcKee) {
+        return "rcm";
+    }
+    return "none";
+}
@@ -0,0 +1,167 @@
+/**
+ * @file vertex_order.h
+ * @brief Перенумерация вершин для локальности обходов
+ * @version 1.1
+ *
+ * Номера городов приходят из внешней нумерации, и соседи в BFS
+ * оказываются разбросаны по массивам distances и neighbors: почти
+ * каждое обращение - промах кэша. Перенумерация при загрузке
+ * сближает номера соседних вершин, а перестановка позволяет
+ * принимать и возвращать исходные номера.
+ */
+
+#ifndef VERTEX_ORDER_H
+#define VERTEX_ORDER_H
+
+#include "compressed_graph.h"
+#include "csr_graph.h"
+#include <string>
+#include <vector>
+
+/**
+ * @enum VertexOrder
+ * @brief Способ перенумерации вершин
+ */
+enum class VertexOrder {
+    Original,            ///< Без перенумерации
+    Degree,              ///< По убыванию степени (узлы-хабы рядом)
+    BreadthFirst,        ///< В порядке BFS по компонентам
+    ReverseCuthillMcKee  ///< Обратный Катхилл-Макки (малая ширина ленты)
+};
+
+/**
+ * @class VertexPermutation
+ * @brief Перестановка исходных номеров вершин во внутренние
+ *
+ * Пустая перестановка - тождественная: массивы не хранятся,
+ * преобразования номеров возвращают аргумент.
+ */
+class VertexPermutation {
+private:
+    VertexOrder order_;
+    std::vector<int> internal_;  ///< internal_[исходный] - внутренний номер
+    std::vector<int> original_;  ///< original_[внутренний] - исходный номер
+
+public:
+    /**
+     * @brief Конструктор тождественной перестановки
+     */
+    VertexPermutation();
+
+    /**
+     * @brief Вычисление перестановки для графа
+     *
+     * Degree - устойчивая сортировка по убыванию степени.
+     * BreadthFirst - BFS по компонентам, каждая от вершины наибольшей
+     * степени. ReverseCuthillMcKee - BFS от псевдопериферийной вершины
+     * (Джордж-Лю) с соседями по возрастанию степени, порядок затем
+     * разворачивается. Ориентированный граф упорядочивается по
+     * исходящим дугам.
+     * @param graph Граф в исходной нумерации
+     * @param order Способ перенумерации
+     * @return VertexPermutation Перестановка (Original - тождественная)
+     */
+    static VertexPermutation compute(const CSRGraph& graph, VertexOrder order);
+
+    /**
+     * @brief Вычисление перестановки по сжатым спискам соседей
+     *
+     * Тот же порядок, что compute для CSR с теми же списками
+     * @param graph Сжатый граф в исходной нумерации
+     * @param order Способ перенумерации
+     * @return VertexPermutation Перестановка (Original - тождественная)
+     */
+    static VertexPermutation compute(const CompressedGraph& graph, VertexOrder order);
+
+    /**
+     * @brief Перенумерация неориентированного графа
+     *
+     * Одна раскладка подсчетом: источники перебираются по возрастанию
+     * нового номера, так что строки сразу отсортированы. Раскладка
+     * строит транспонированный граф, который у симметричного графа
+     * совпадает с исходным. Веса сохраняются.
+     * @param graph Симметричный граф в исходной нумерации
+     * @return CSRGraph Граф во внутренней нумерации
+     */
+    CSRGraph apply(const CSRGraph& graph) const;
+
+    /**
+     * @brief Перенумерация ориентированного графа
+     *
+     * Исходящие дуги получаются раскладкой входящих и наоборот
+     * @param graph Исходящие и входящие дуги в исходной нумерации
+     * @return DirectedGraph Граф во внутренней нумерации
+     */
+    DirectedGraph apply(const DirectedGraph& graph) const;
+
+    /**
+     * @brief Внутренний номер вершины
+     * @param original Исходный номер (0-based)
+     * @return int Внутренний номер (0-based)
+     */
+    int toInternal(int original) const {
+        return internal_.empty() ? original : internal_[original];
+    }
+
+    /**
+     * @brief Исходный номер вершины
+     * @param internal Внутренний номер (0-based)
+     * @return int Исходный номер (0-based)
+     */
+    int toOriginal(int internal) const {
+        return original_.empty() ? internal : original_[internal];
+    }
+
+    /**
+     * @brief Тождественна ли перестановка
+     * @return true если номера не меняются
+     */
+    bool isIdentity() const { return original_.empty(); }
+
+    /**
+     * @brief Способ, которым построена перестановка
+     * @return VertexOrder Способ перенумерации
+     */
+    VertexOrder order() const { return order_; }
+
+    /**
+     * @brief Разбор названия способа перенумерации
+     * @param name "none", "degree", "bfs" или "rcm"
+     * @return VertexOrder Способ перенумерации
+     * @throws std::runtime_error при неизвестном названии
+     */
+    static VertexOrder parseOrder(const std::string& name);
+
+    /**
+     * @brief Название способа перенумерации
+     * @param order Способ перенумерации
+     * @return const char* Название, принимаемое parseOrder
+     */
+    static const char* orderName(VertexOrder order);
+
+private:
+    /**
+     * @brief Перестановка по готовому порядку вершин
+     * @param order Способ перенумерации
+     * @param sequence Исходные номера в новом порядке
+     */
+    VertexPermutation(VertexOrder order, std::vector<int> sequence);
+
+    /**
+     * @brief Вычисление перестановки по спискам соседей в любом представлении (adjacency.h)
+     * @param graph Граф в исходной нумерации
+     * @param order Способ перенумерации
+     * @return VertexPermutation Перестановка
+     */
+    template <class Adjacency>
+    static VertexPermutation computeFrom(Adjacency& graph, VertexOrder order);
+
+    /**
+     * @brief Раскладка дуг графа по новым номерам
+     * @param graph Граф в исходной нумерации
+     * @return CSRGraph Транспонированный граф во внутренней нумерации
+     */
+    CSRGraph scatter(const CSRGraph& graph) const;
+};
+
+#endif // VERTEX_ORDER_H